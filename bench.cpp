@@ -0,0 +1,1408 @@
+// SPDX-License-Identifier: MIT
+// Copyright(c) 2021 ur4t
+
+// Microbenchmarks of the main library surfaces, one JSON object per line:
+//     {"name": ..., "cplusplus": ..., "ns_per_op": ..., "bytes_per_sec": ...,
+//      "allocs_per_op": ...}
+// usage: bench [--filter SUBSTR] [--baseline FILE] [--tolerance PERCENT]
+// With --baseline (a previous output), every case slower than its baseline
+// by more than the tolerance (default 10%) is reported on stderr and the
+// run exits with 1. bench.sh runs it for every supported standard.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// metrics/* cases time the instrumentation macros, the results are not
+// dumped
+#define RUSTY_DBG_METRICS
+#define RUSTY_DBG_METRICS_AT_EXIT 0
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define BENCH_HAS_DEV_NULL
+#endif
+
+#include "rusty.hpp"
+
+namespace bench {
+
+// heap allocations so far, counted by the global operator new below
+inline ::std::atomic<::std::size_t> &allocations() {
+    static ::std::atomic<::std::size_t> count{0};
+    return count;
+}
+
+// opaque to the optimizer, so benchmarked work is neither hoisted nor
+// dropped
+template <typename T> inline void keep(T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : "+m"(value) : : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+// @run performs @n operations and returns the bytes they processed, 0 when
+// throughput does not apply
+struct Case {
+    ::std::string name;
+    ::std::function<::std::size_t(::std::size_t n)> run;
+};
+
+inline ::std::vector<Case> &registry() {
+    static ::std::vector<Case> cases;
+    return cases;
+}
+
+struct Register {
+    Register(::std::string name,
+             ::std::function<::std::size_t(::std::size_t n)> run) {
+        registry().push_back(Case{::std::move(name), ::std::move(run)});
+    }
+};
+
+struct Result {
+    double ns_per_op;
+    double bytes_per_sec;
+    double allocs_per_op;
+};
+
+// doubles @n until a run takes 10ms, then keeps the best of 5 runs;
+// allocations are the difference between the last two doublings, so
+// per-run setup does not count
+inline Result measure(const Case &c) {
+    using Clock = ::std::chrono::steady_clock;
+    const auto time = [&c](::std::size_t n, ::std::size_t &bytes,
+                           ::std::size_t &allocs) {
+        const auto before = allocations().load(::std::memory_order_relaxed);
+        const auto start = Clock::now();
+        bytes = c.run(n);
+        const auto ns = ::std::chrono::duration<double, ::std::nano>(
+                            Clock::now() - start)
+                            .count();
+        allocs = allocations().load(::std::memory_order_relaxed) - before;
+        return ns;
+    };
+    auto n = ::std::size_t{1};
+    auto bytes = ::std::size_t{0};
+    auto allocs = ::std::size_t{0};
+    auto half_allocs = ::std::size_t{0};
+    while (time(n, bytes, allocs) < 1e7 && n < (::std::size_t{1} << 40)) {
+        half_allocs = allocs;
+        n *= 2;
+    }
+    const auto allocs_per_op =
+        allocs > half_allocs
+            ? static_cast<double>(allocs - half_allocs) /
+                  static_cast<double>(n - n / 2)
+            : 0.0;
+    auto ignored = ::std::size_t{0};
+    auto best = time(n, bytes, ignored);
+    for (int i = 0; i < 4; ++i) {
+        best = ::std::min(best, time(n, bytes, ignored));
+    }
+    return {best / static_cast<double>(n),
+            static_cast<double>(bytes) * 1e9 / best, allocs_per_op};
+}
+
+// value of @key in a line printed by main, empty when missing
+inline ::std::string field(const ::std::string &line, const char *key) {
+    const auto needle = ::std::string{"\""} + key + "\": ";
+    auto begin = line.find(needle);
+    if (begin == ::std::string::npos) {
+        return {};
+    }
+    begin += needle.size();
+    if (line[begin] == '"') {
+        return line.substr(begin + 1, line.find('"', begin + 1) - begin - 1);
+    }
+    return line.substr(begin, line.find_first_of(",}", begin) - begin);
+}
+
+// stderr redirected to /dev/null while alive, for dbg cases
+class Silence {
+  public:
+#ifdef BENCH_HAS_DEV_NULL
+    Silence() : saved(::dup(STDERR_FILENO)) {
+        const auto null = ::open("/dev/null", O_WRONLY);
+        ::dup2(null, STDERR_FILENO);
+        ::close(null);
+    }
+    ~Silence() {
+        ::dup2(saved, STDERR_FILENO);
+        ::close(saved);
+    }
+
+  private:
+    int saved;
+#endif
+};
+
+} // namespace bench
+
+// counting replacements of the global allocation functions, the other
+// forms forward to these; kept out of line, g++ flags free() on memory from
+// an inlined operator new as mismatched
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+BENCH_NOINLINE void *operator new(::std::size_t size) {
+    bench::allocations().fetch_add(1, ::std::memory_order_relaxed);
+    if (void *p = ::std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw ::std::bad_alloc{};
+}
+BENCH_NOINLINE void operator delete(void *p) noexcept { ::std::free(p); }
+BENCH_NOINLINE void operator delete(void *p, ::std::size_t) noexcept {
+    ::std::free(p);
+}
+
+using namespace ::rusty::numeric_types;
+using namespace ::rusty::numeric_types::literal;
+using namespace ::rusty::collections;
+using namespace ::rusty::collections::ostream;
+
+namespace {
+
+constexpr ::std::size_t BLOCK = 4096;
+
+// deterministic pseudo random input
+template <typename N> Vec<N> input(::std::size_t count) {
+    auto state = ::std::uint64_t{0x9e3779b97f4a7c15ULL};
+    auto out = Vec<N>(count);
+    for (auto &n : out) {
+        state ^= state << 13U;
+        state ^= state >> 7U;
+        state ^= state << 17U;
+        n = static_cast<decltype(n.value)>(state >> 11U);
+    }
+    return out;
+}
+
+// numeric: byte conversions
+
+const bench::Register from_le_bytes_u64(
+    "numeric/from_le_bytes/u64", [](::std::size_t n) {
+        auto bytes = (0x0123456789abcdef_u64).to_le_bytes();
+        auto acc = 0_u64;
+        for (::std::size_t i = 0; i < n; ++i) {
+            bench::keep(bytes);
+            acc ^= u64::from_le_bytes(bytes);
+        }
+        bench::keep(acc);
+        return n * sizeof(u64);
+    });
+
+const bench::Register to_be_bytes_u32(
+    "numeric/to_be_bytes/u32", [](::std::size_t n) {
+        auto value = 0x01234567_u32;
+        for (::std::size_t i = 0; i < n; ++i) {
+            bench::keep(value);
+            auto bytes = value.to_be_bytes();
+            bench::keep(bytes);
+        }
+        return n * sizeof(u32);
+    });
+
+const bench::Register to_be_slice_u32(
+    "numeric/to_be_slice/u32", [](::std::size_t n) {
+        const auto in = input<u32>(BLOCK);
+        auto out = Vec<::std::uint8_t>(BLOCK * sizeof(u32));
+        for (::std::size_t i = 0; i < n; ++i) {
+            u32::to_be_slice(in.data(), in.size(), out.data());
+            bench::keep(out[0]);
+        }
+        return n * BLOCK * sizeof(u32);
+    });
+
+// per element baselines of the slice forms
+const bench::Register to_be_slice_loop_u32(
+    "numeric/to_be_slice_loop/u32", [](::std::size_t n) {
+        const auto in = input<u32>(BLOCK);
+        auto out = Vec<::std::uint8_t>(BLOCK * sizeof(u32));
+        for (::std::size_t i = 0; i < n; ++i) {
+            for (::std::size_t j = 0; j < BLOCK; ++j) {
+                const auto bytes = in[j].to_be_bytes();
+                ::std::memcpy(&out[j * sizeof(u32)], bytes.data(), sizeof(u32));
+            }
+            bench::keep(out[0]);
+        }
+        return n * BLOCK * sizeof(u32);
+    });
+
+const bench::Register swap_bytes_inplace_u64(
+    "numeric/swap_bytes_inplace/u64", [](::std::size_t n) {
+        auto data = input<u64>(BLOCK);
+        for (::std::size_t i = 0; i < n; ++i) {
+            u64::swap_bytes_inplace(data);
+            bench::keep(data[0]);
+        }
+        return n * BLOCK * sizeof(u64);
+    });
+
+const bench::Register swap_bytes_loop_u64(
+    "numeric/swap_bytes_loop/u64", [](::std::size_t n) {
+        auto data = input<u64>(BLOCK);
+        for (::std::size_t i = 0; i < n; ++i) {
+            for (auto &x : data) {
+                x = x.to_be();
+            }
+            bench::keep(data[0]);
+        }
+        return n * BLOCK * sizeof(u64);
+    });
+
+// numeric: arithmetic
+
+const bench::Register compound_assign_u32(
+    "numeric/compound_assign/u32", [](::std::size_t n) {
+        auto data = input<u32>(BLOCK);
+        for (::std::size_t i = 0; i < n; ++i) {
+            for (auto &x : data) {
+                x *= 3_u32;
+                x += 1_u32;
+            }
+            bench::keep(data[0]);
+        }
+        return n * BLOCK * sizeof(u32);
+    });
+
+const bench::Register checked_add_i32(
+    "numeric/checked_add/i32", [](::std::size_t n) {
+        const auto data = input<i32>(BLOCK);
+        auto overflows = ::std::size_t{0};
+        for (::std::size_t i = 0; i < n; ++i) {
+            for (const auto &x : data) {
+                overflows += x.checked_add(x).is_none();
+            }
+            bench::keep(overflows);
+        }
+        return n * BLOCK * sizeof(i32);
+    });
+
+const bench::Register saturating_add_slice_u8(
+    "numeric/saturating_add_slice/u8", [](::std::size_t n) {
+        const auto a = input<u8>(BLOCK);
+        const auto b = input<u8>(BLOCK);
+        auto out = Vec<u8>(BLOCK);
+        for (::std::size_t i = 0; i < n; ++i) {
+            u8::saturating_add_slice(a.data(), b.data(), out.data(), BLOCK);
+            bench::keep(out[0]);
+        }
+        return n * BLOCK;
+    });
+
+// hand written scalar baseline of the slice form
+const bench::Register saturating_add_loop_u8(
+    "numeric/saturating_add_loop/u8", [](::std::size_t n) {
+        const auto a = input<u8>(BLOCK);
+        const auto b = input<u8>(BLOCK);
+        auto out = Vec<u8>(BLOCK);
+        for (::std::size_t i = 0; i < n; ++i) {
+            for (::std::size_t j = 0; j < BLOCK; ++j) {
+                out[j] = a[j].saturating_add(b[j]);
+            }
+            bench::keep(out[0]);
+        }
+        return n * BLOCK;
+    });
+
+const bench::Register count_ones_slice_u64(
+    "numeric/count_ones_slice/u64", [](::std::size_t n) {
+        const auto data = input<u64>(BLOCK);
+        auto total = ::std::uint64_t{0};
+        for (::std::size_t i = 0; i < n; ++i) {
+            total += u64::count_ones_slice(data.data(), data.size());
+            bench::keep(total);
+        }
+        return n * BLOCK * sizeof(u64);
+    });
+
+const bench::Register count_ones_loop_u64(
+    "numeric/count_ones_loop/u64", [](::std::size_t n) {
+        const auto data = input<u64>(BLOCK);
+        auto total = ::std::uint64_t{0};
+        for (::std::size_t i = 0; i < n; ++i) {
+            for (const auto &x : data) {
+                total += x.count_ones();
+            }
+            bench::keep(total);
+        }
+        return n * BLOCK * sizeof(u64);
+    });
+
+// numeric: formatting and parsing
+
+const bench::Register write_to_u64("numeric/write_to/u64", [](::std::size_t n) {
+    const auto data = input<u64>(BLOCK);
+    char buffer[::rusty::numeric_types::detail::MAX_FORMAT_CHARS]; // NOLINT
+    auto bytes = ::std::size_t{0};
+    for (::std::size_t i = 0; i < n; ++i) {
+        bytes += static_cast<::std::size_t>(
+            data[i % BLOCK].write_to(buffer) - buffer);
+        bench::keep(buffer);
+    }
+    return bytes;
+});
+
+// the locale aware iostream path, against write_to
+const bench::Register ostream_u64("numeric/ostream/u64", [](::std::size_t n) {
+    const auto data = input<u64>(BLOCK);
+    ::rusty::debug::StringBuf buf;
+    ::std::ostream s(&buf);
+    auto bytes = ::std::size_t{0};
+    for (::std::size_t i = 0; i < n; ++i) {
+        buf.buffer.clear();
+        s << data[i % BLOCK].value;
+        bytes += buf.buffer.size();
+        bench::keep(buf.buffer);
+    }
+    return bytes;
+});
+
+const bench::Register write_to_f64("numeric/write_to/f64", [](::std::size_t n) {
+    auto data = Vec<f64>(BLOCK);
+    const auto bits = input<u64>(BLOCK);
+    for (::std::size_t i = 0; i < BLOCK; ++i) {
+        data[i] = static_cast<double>(bits[i].value >> 11U) / 1e6;
+    }
+    char buffer[::rusty::numeric_types::detail::MAX_FORMAT_CHARS]; // NOLINT
+    auto bytes = ::std::size_t{0};
+    for (::std::size_t i = 0; i < n; ++i) {
+        bytes += static_cast<::std::size_t>(
+            data[i % BLOCK].write_to(buffer) - buffer);
+        bench::keep(buffer);
+    }
+    return bytes;
+});
+
+const bench::Register ostream_f64("numeric/ostream/f64", [](::std::size_t n) {
+    auto data = Vec<f64>(BLOCK);
+    const auto bits = input<u64>(BLOCK);
+    for (::std::size_t i = 0; i < BLOCK; ++i) {
+        data[i] = static_cast<double>(bits[i].value >> 11U) / 1e6;
+    }
+    ::rusty::debug::StringBuf buf;
+    ::std::ostream s(&buf);
+    s.precision(17);
+    auto bytes = ::std::size_t{0};
+    for (::std::size_t i = 0; i < n; ++i) {
+        buf.buffer.clear();
+        s << data[i % BLOCK].value;
+        bytes += buf.buffer.size();
+        bench::keep(buf.buffer);
+    }
+    return bytes;
+});
+
+const bench::Register to_string_i128(
+    "numeric/to_string/i128", [](::std::size_t n) {
+        const auto data = input<i128>(BLOCK);
+        auto bytes = ::std::size_t{0};
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto s = data[i % BLOCK].to_string();
+            bytes += s.size();
+            bench::keep(s);
+        }
+        return bytes;
+    });
+
+const bench::Register from_str_u64("numeric/from_str/u64", [](::std::size_t n) {
+    auto texts = Vec<::std::string>{};
+    for (const auto &x : input<u64>(BLOCK)) {
+        texts.push_back(x.to_string());
+    }
+    auto acc = 0_u64;
+    auto bytes = ::std::size_t{0};
+    for (::std::size_t i = 0; i < n; ++i) {
+        const auto &text = texts[i % BLOCK];
+        acc ^= u64::from_str(text).unwrap_or(0_u64);
+        bytes += text.size();
+        bench::keep(acc);
+    }
+    return bytes;
+});
+
+// strtoull and operator>>, against from_str
+const bench::Register strtoull_u64("numeric/strtoull/u64", [](::std::size_t n) {
+    auto texts = Vec<::std::string>{};
+    for (const auto &x : input<u64>(BLOCK)) {
+        texts.push_back(x.to_string());
+    }
+    auto acc = 0ULL;
+    auto bytes = ::std::size_t{0};
+    for (::std::size_t i = 0; i < n; ++i) {
+        const auto &text = texts[i % BLOCK];
+        acc ^= ::std::strtoull(text.c_str(), nullptr, 10);
+        bytes += text.size();
+        bench::keep(acc);
+    }
+    return bytes;
+});
+
+const bench::Register istream_u64("numeric/istream/u64", [](::std::size_t n) {
+    auto texts = Vec<::std::string>{};
+    for (const auto &x : input<u64>(BLOCK)) {
+        texts.push_back(x.to_string());
+    }
+    ::std::istringstream s;
+    auto acc = 0_u64;
+    auto bytes = ::std::size_t{0};
+    for (::std::size_t i = 0; i < n; ++i) {
+        const auto &text = texts[i % BLOCK];
+        s.clear();
+        s.str(text);
+        auto x = 0_u64;
+        s >> x;
+        acc ^= x;
+        bytes += text.size();
+        bench::keep(acc);
+    }
+    return bytes;
+});
+
+// Number<T> against its raw type in the loops compilers vectorize, the
+// pairs should match; values stay below 100 so nothing overflows
+
+template <typename T> ::std::vector<T> small_input() {
+    auto out = ::std::vector<T>{};
+    for (const auto &x : input<u32>(BLOCK)) {
+        out.push_back(static_cast<T>(x.value % 100U));
+    }
+    return out;
+}
+
+template <typename N, typename T>
+void register_wrapper(const ::std::string &suffix) {
+    bench::Register("wrapper/sum/" + suffix, [](::std::size_t n) {
+        const auto raw = small_input<T>();
+        const auto data = Vec<N>(raw.begin(), raw.end());
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto acc = N{};
+            for (const auto &x : data) {
+                acc += x;
+            }
+            auto result = acc; // acc itself stays in a register
+            bench::keep(result);
+        }
+        return n * BLOCK * sizeof(T);
+    });
+    bench::Register("raw/sum/" + suffix, [](::std::size_t n) {
+        const auto data = small_input<T>();
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto acc = T{};
+            for (const auto &x : data) {
+                acc = static_cast<T>(acc + x);
+            }
+            auto result = acc; // acc itself stays in a register
+            bench::keep(result);
+        }
+        return n * BLOCK * sizeof(T);
+    });
+    bench::Register("wrapper/dot/" + suffix, [](::std::size_t n) {
+        const auto raw = small_input<T>();
+        const auto a = Vec<N>(raw.begin(), raw.end());
+        const auto b = Vec<N>(raw.rbegin(), raw.rend());
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto acc = N{};
+            for (::std::size_t j = 0; j < BLOCK; ++j) {
+                acc += a[j] * b[j];
+            }
+            auto result = acc; // acc itself stays in a register
+            bench::keep(result);
+        }
+        return n * BLOCK * 2 * sizeof(T);
+    });
+    bench::Register("raw/dot/" + suffix, [](::std::size_t n) {
+        const auto a = small_input<T>();
+        const auto b = ::std::vector<T>(a.rbegin(), a.rend());
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto acc = T{};
+            for (::std::size_t j = 0; j < BLOCK; ++j) {
+                acc = static_cast<T>(acc + static_cast<T>(a[j] * b[j]));
+            }
+            auto result = acc; // acc itself stays in a register
+            bench::keep(result);
+        }
+        return n * BLOCK * 2 * sizeof(T);
+    });
+    bench::Register("wrapper/transform/" + suffix, [](::std::size_t n) {
+        const auto raw = small_input<T>();
+        const auto in = Vec<N>(raw.begin(), raw.end());
+        auto out = Vec<N>(BLOCK);
+        const auto k = N{static_cast<T>(3)};
+        for (::std::size_t i = 0; i < n; ++i) {
+            const auto *src = in.data();
+            auto *dst = out.data();
+            bench::keep(src);
+            bench::keep(dst);
+            for (::std::size_t j = 0; j < BLOCK; ++j) {
+                dst[j] = src[j] * k + k;
+            }
+            bench::keep(out[0]);
+        }
+        return n * BLOCK * sizeof(T);
+    });
+    bench::Register("raw/transform/" + suffix, [](::std::size_t n) {
+        const auto in = small_input<T>();
+        auto out = ::std::vector<T>(BLOCK);
+        const auto k = static_cast<T>(3);
+        for (::std::size_t i = 0; i < n; ++i) {
+            const auto *src = in.data();
+            auto *dst = out.data();
+            bench::keep(src);
+            bench::keep(dst);
+            for (::std::size_t j = 0; j < BLOCK; ++j) {
+                dst[j] = static_cast<T>(src[j] * k + k);
+            }
+            bench::keep(out[0]);
+        }
+        return n * BLOCK * sizeof(T);
+    });
+}
+
+const bool wrapper_cases = [] {
+    register_wrapper<u8, ::std::uint8_t>("u8");
+    register_wrapper<u32, ::std::uint32_t>("u32");
+    register_wrapper<i64, ::std::int64_t>("i64");
+    register_wrapper<f32, float>("f32");
+    return true;
+}();
+
+// conversions, try_from into a wider type checks nothing
+
+const bench::Register try_from_narrow_u8(
+    "convert/try_from_narrow/u8", [](::std::size_t n) {
+        const auto data = input<u32>(BLOCK);
+        auto acc = 0_u8;
+        for (::std::size_t i = 0; i < n; ++i) {
+            for (const auto &x : data) {
+                acc ^= u8::try_from(x >> 23U).unwrap_or(0_u8);
+            }
+            bench::keep(acc);
+        }
+        return n * BLOCK * sizeof(u32);
+    });
+
+const bench::Register try_from_widen_i64(
+    "convert/try_from_widen/i64", [](::std::size_t n) {
+        const auto data = input<u32>(BLOCK);
+        auto acc = 0_i64;
+        for (::std::size_t i = 0; i < n; ++i) {
+            for (const auto &x : data) {
+                acc += i64::try_from(x).unwrap();
+            }
+            bench::keep(acc);
+        }
+        return n * BLOCK * sizeof(u32);
+    });
+
+const bench::Register as_saturate_f64_i32(
+    "convert/as_saturate/f64_i32", [](::std::size_t n) {
+        // in [-4e9, 4e9), a half out of range of i32
+        auto data = input<f64>(BLOCK);
+        for (auto &x : data) {
+            x = x / 9007199254740992.0 * 8e9 - 4e9;
+        }
+        auto acc = 0_i32;
+        for (::std::size_t i = 0; i < n; ++i) {
+            for (const auto &x : data) {
+                acc ^= x.as<i32>();
+            }
+            bench::keep(acc);
+        }
+        return n * BLOCK * sizeof(f64);
+    });
+
+// collection printers, into a reused string buffer
+
+template <typename C> ::std::size_t print(const C &collection, ::std::size_t n) {
+    ::rusty::debug::StringBuf buf;
+    ::std::ostream s(&buf);
+    auto bytes = ::std::size_t{0};
+    for (::std::size_t i = 0; i < n; ++i) {
+        buf.buffer.clear();
+        s << collection;
+        bytes += buf.buffer.size();
+        bench::keep(buf.buffer);
+    }
+    return bytes;
+}
+
+const bench::Register printer_vec_u32("printer/vec/u32", [](::std::size_t n) {
+    return print(input<u32>(1000), n);
+});
+
+const bench::Register printer_vec_f64("printer/vec/f64", [](::std::size_t n) {
+    auto data = Vec<f64>{};
+    for (const auto &x : input<u32>(1000)) {
+        data.push_back(static_cast<double>(x.value) / 1000.0);
+    }
+    return print(data, n);
+});
+
+const bench::Register printer_small_vec_u16(
+    "printer/small_vec/u16", [](::std::size_t n) {
+        auto data = SmallVec<u16, 16>{};
+        for (const auto &x : input<u16>(16)) {
+            data.push_back(x);
+        }
+        return print(data, n);
+    });
+
+const bench::Register printer_hash_map_u32(
+    "printer/hash_map/u32", [](::std::size_t n) {
+        auto data = HashMap<u32, u32>{};
+        for (const auto &x : input<u32>(1000)) {
+            data.emplace(x, x);
+        }
+        return print(data, n);
+    });
+
+// SmallVec against Vec, an op builds a vector of @len elements and drops
+// it; allocs_per_op shows when SmallVec<_, 16> spills
+
+template <typename V> ::std::size_t build_drop(::std::size_t len,
+                                               ::std::size_t n) {
+    const auto data = input<u32>(len);
+    for (::std::size_t i = 0; i < n; ++i) {
+        auto v = V{};
+        for (const auto &x : data) {
+            v.push_back(x);
+        }
+        bench::keep(v);
+    }
+    return n * len * sizeof(u32);
+}
+
+const bench::Register small_vec_build_drop_8(
+    "small_vec/build_drop/u32/8",
+    [](::std::size_t n) { return build_drop<SmallVec<u32, 16>>(8, n); });
+
+const bench::Register vec_build_drop_8(
+    "vec/build_drop/u32/8",
+    [](::std::size_t n) { return build_drop<Vec<u32>>(8, n); });
+
+const bench::Register small_vec_build_drop_64(
+    "small_vec/build_drop/u32/64",
+    [](::std::size_t n) { return build_drop<SmallVec<u32, 16>>(64, n); });
+
+const bench::Register vec_build_drop_64(
+    "vec/build_drop/u32/64",
+    [](::std::size_t n) { return build_drop<Vec<u32>>(64, n); });
+
+// arena collections against the default allocator, an op is one request
+// building a REQUEST_LEN element container, released by an Arena::Scope
+
+constexpr ::std::size_t REQUEST_LEN = 64;
+
+const bench::Register alloc_vec_arena(
+    "alloc/vec/u64/arena", [](::std::size_t n) {
+        namespace arena = ::rusty::alloc::arena;
+        const auto data = input<u64>(REQUEST_LEN);
+        ::rusty::alloc::Arena pool;
+        for (::std::size_t i = 0; i < n; ++i) {
+            const ::rusty::alloc::Arena::Scope scope(pool);
+            auto v = arena::Vec<u64>(&pool);
+            for (const auto &x : data) {
+                v.push_back(x);
+            }
+            bench::keep(v);
+        }
+        return n * REQUEST_LEN * sizeof(u64);
+    });
+
+const bench::Register alloc_vec_default(
+    "alloc/vec/u64/default", [](::std::size_t n) {
+        const auto data = input<u64>(REQUEST_LEN);
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto v = Vec<u64>{};
+            for (const auto &x : data) {
+                v.push_back(x);
+            }
+            bench::keep(v);
+        }
+        return n * REQUEST_LEN * sizeof(u64);
+    });
+
+const bench::Register alloc_hash_map_arena(
+    "alloc/hash_map/u64/arena", [](::std::size_t n) {
+        namespace arena = ::rusty::alloc::arena;
+        using Map = arena::HashMap<u64, u64>;
+        const auto data = input<u64>(REQUEST_LEN);
+        ::rusty::alloc::Arena pool;
+        for (::std::size_t i = 0; i < n; ++i) {
+            const ::rusty::alloc::Arena::Scope scope(pool);
+            auto map = Map(0, Map::hasher{}, Map::key_equal{}, &pool);
+            for (const auto &x : data) {
+                map.emplace(x, x);
+            }
+            bench::keep(map);
+        }
+        return n * REQUEST_LEN * sizeof(u64);
+    });
+
+const bench::Register alloc_hash_map_default(
+    "alloc/hash_map/u64/default", [](::std::size_t n) {
+        using Map = ::std::unordered_map<u64, u64>;
+        const auto data = input<u64>(REQUEST_LEN);
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto map = Map{};
+            for (const auto &x : data) {
+                map.emplace(x, x);
+            }
+            bench::keep(map);
+        }
+        return n * REQUEST_LEN * sizeof(u64);
+    });
+
+// columnar serialization, against the printer/* text cases
+
+constexpr ::std::size_t COLUMN_LEN = 1 << 16;
+
+// writer into a preallocated buffer, so saving allocates nothing
+class SpanWriter : public ::rusty::io::WriteExt<SpanWriter> {
+  public:
+    explicit SpanWriter(Vec<::std::uint8_t> &buffer) : buffer(buffer) {}
+    void write_bytes(const ::std::uint8_t *bytes, ::std::size_t n) {
+        ::std::memcpy(buffer.data() + pos, bytes, n);
+        pos += n;
+    }
+
+  private:
+    Vec<::std::uint8_t> &buffer;
+    ::std::size_t pos = 0;
+};
+
+template <typename C> Vec<::std::uint8_t> saved(const C &container) {
+    auto writer = ::rusty::io::ByteWriter{};
+    save(writer, container);
+    return ::std::move(writer).into_inner();
+}
+
+HashMap<u64, f64> column_map() {
+    auto map = HashMap<u64, f64>{};
+    for (const auto &x : input<u64>(COLUMN_LEN / 4)) {
+        map.emplace(x, static_cast<double>(x.value >> 11U));
+    }
+    return map;
+}
+
+const bench::Register serialize_save_vec_u64(
+    "serialize/save/vec/u64", [](::std::size_t n) {
+        const auto data = input<u64>(COLUMN_LEN);
+        auto buffer = saved(data);
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto writer = SpanWriter{buffer};
+            save(writer, data);
+            bench::keep(buffer);
+        }
+        return n * buffer.size();
+    });
+
+const bench::Register serialize_load_vec_u64(
+    "serialize/load/vec/u64", [](::std::size_t n) {
+        const auto buffer = saved(input<u64>(COLUMN_LEN));
+        auto data = Vec<u64>{};
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto reader = ::rusty::io::ByteReader{buffer.data(), buffer.size()};
+            load(reader, data);
+            bench::keep(data);
+        }
+        return n * buffer.size();
+    });
+
+const bench::Register serialize_view_vec_u64(
+    "serialize/view/vec/u64", [](::std::size_t n) {
+        const auto buffer = saved(input<u64>(COLUMN_LEN));
+        auto acc = 0_u64;
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto reader = ::rusty::io::ByteReader{buffer.data(), buffer.size()};
+            const auto column = view<u64>(reader);
+            acc ^= column[i % COLUMN_LEN];
+            bench::keep(acc);
+        }
+        return n * buffer.size();
+    });
+
+const bench::Register serialize_save_hash_map(
+    "serialize/save/hash_map/u64_f64", [](::std::size_t n) {
+        const auto map = column_map();
+        auto buffer = saved(map);
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto writer = SpanWriter{buffer};
+            save(writer, map);
+            bench::keep(buffer);
+        }
+        return n * buffer.size();
+    });
+
+const bench::Register serialize_load_hash_map(
+    "serialize/load/hash_map/u64_f64", [](::std::size_t n) {
+        const auto buffer = saved(column_map());
+        auto map = HashMap<u64, f64>{};
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto reader = ::rusty::io::ByteReader{buffer.data(), buffer.size()};
+            load(reader, map);
+            bench::keep(map);
+        }
+        return n * buffer.size();
+    });
+
+// dbg, emitted records go to /dev/null
+
+const bench::Register dbg_disabled_level(
+    "dbg/disabled_level", [](::std::size_t n) {
+        auto value = 42_u64;
+        for (::std::size_t i = 0; i < n; ++i) {
+            bench::keep(dbg_level(RUSTY_DBG_LEVEL + 1, value));
+        }
+        return ::std::size_t{0};
+    });
+
+#ifdef BENCH_HAS_DEV_NULL
+const bench::Register dbg_u64("dbg/u64", [](::std::size_t n) {
+    const bench::Silence silence;
+    auto value = 42_u64;
+    for (::std::size_t i = 0; i < n; ++i) {
+        bench::keep(dbg(value));
+    }
+    return ::std::size_t{0};
+});
+
+// the original dbg: a copy of the value and piecewise, flushed std::cerr
+// writes
+const bench::Register dbg_legacy_cerr("dbg/legacy_cerr", [](::std::size_t n) {
+    const bench::Silence silence;
+    auto value = 42_u64;
+    for (::std::size_t i = 0; i < n; ++i) {
+        [&] {
+            auto t = (value);
+            auto flag = ::std::cerr.flags();
+            auto precision = ::std::cerr.precision();
+            ::std::cerr << "[" __FILE__ ":" << __LINE__ << "] value = " << t
+                        << ::std::endl;
+            ::std::cerr.flags(flag);
+            ::std::cerr.precision(precision);
+            return t;
+        }();
+        bench::keep(value);
+    }
+    return ::std::size_t{0};
+});
+
+const bench::Register dbg_vec_u32("dbg/vec/u32", [](::std::size_t n) {
+    const bench::Silence silence;
+    auto data = input<u32>(100);
+    for (::std::size_t i = 0; i < n; ++i) {
+        bench::keep(dbg(data));
+    }
+    return ::std::size_t{0};
+});
+#endif
+
+// instrumentation overhead per recorded event
+
+const bench::Register metrics_count("metrics/count", [](::std::size_t n) {
+    for (::std::size_t i = 0; i < n; ++i) {
+        dbg_count("bench");
+    }
+    return ::std::size_t{0};
+});
+
+const bench::Register metrics_hist("metrics/hist", [](::std::size_t n) {
+    for (::std::size_t i = 0; i < n; ++i) {
+        dbg_hist("bench", i & 0xffffU);
+    }
+    return ::std::size_t{0};
+});
+
+const bench::Register metrics_time("metrics/time", [](::std::size_t n) {
+    for (::std::size_t i = 0; i < n; ++i) {
+        dbg_time("bench");
+    }
+    return ::std::size_t{0};
+});
+
+// FlatHashMap against std::unordered_map under the same hasher, an op is
+// a pass over BLOCK keys; erase/* puts each key back after erasing it
+
+using FlatMapU64 = FlatHashMap<u64, u64, ::rusty::hash::FastHash<u64>>;
+using StdMapU64 = ::std::unordered_map<u64, u64, ::rusty::hash::FastHash<u64>>;
+
+template <typename M> ::std::size_t map_insert(::std::size_t n) {
+    const auto keys = input<u64>(BLOCK);
+    for (::std::size_t i = 0; i < n; ++i) {
+        auto map = M{};
+        for (const auto &k : keys) {
+            map.emplace(k, k);
+        }
+        bench::keep(map);
+    }
+    return n * BLOCK * sizeof(u64);
+}
+
+template <typename M> ::std::size_t map_find(::std::size_t n) {
+    const auto keys = input<u64>(BLOCK);
+    auto map = M{};
+    for (const auto &k : keys) {
+        map.emplace(k, k);
+    }
+    auto acc = 0_u64;
+    for (::std::size_t i = 0; i < n; ++i) {
+        for (const auto &k : keys) {
+            acc ^= map.find(k)->second;
+        }
+        bench::keep(acc);
+    }
+    return n * BLOCK * sizeof(u64);
+}
+
+template <typename M> ::std::size_t map_erase(::std::size_t n) {
+    const auto keys = input<u64>(BLOCK);
+    auto map = M{};
+    for (const auto &k : keys) {
+        map.emplace(k, k);
+    }
+    for (::std::size_t i = 0; i < n; ++i) {
+        for (const auto &k : keys) {
+            map.erase(k);
+            map.emplace(k, k);
+        }
+        bench::keep(map);
+    }
+    return n * BLOCK * sizeof(u64);
+}
+
+const bench::Register flat_hash_map_insert(
+    "flat_hash_map/insert/u64",
+    [](::std::size_t n) { return map_insert<FlatMapU64>(n); });
+
+const bench::Register std_unordered_map_insert(
+    "std_unordered_map/insert/u64",
+    [](::std::size_t n) { return map_insert<StdMapU64>(n); });
+
+const bench::Register flat_hash_map_find(
+    "flat_hash_map/find/u64",
+    [](::std::size_t n) { return map_find<FlatMapU64>(n); });
+
+const bench::Register std_unordered_map_find(
+    "std_unordered_map/find/u64",
+    [](::std::size_t n) { return map_find<StdMapU64>(n); });
+
+const bench::Register flat_hash_map_erase(
+    "flat_hash_map/erase/u64",
+    [](::std::size_t n) { return map_erase<FlatMapU64>(n); });
+
+const bench::Register std_unordered_map_erase(
+    "std_unordered_map/erase/u64",
+    [](::std::size_t n) { return map_erase<StdMapU64>(n); });
+
+// hashing of Number<T>
+
+// @keys holds BLOCK keys
+template <typename H, typename N>
+::std::size_t hash_all(const Vec<N> &keys, ::std::size_t n) {
+    const auto hasher = H{};
+    auto acc = ::std::size_t{0};
+    for (::std::size_t i = 0; i < n; ++i) {
+        acc ^= hasher(keys[i % BLOCK]);
+        bench::keep(acc);
+    }
+    return n * sizeof(N);
+}
+
+const bench::Register hash_std_u64("hash/std/u64", [](::std::size_t n) {
+    return hash_all<::rusty::hash::StdHash<u64>>(input<u64>(BLOCK), n);
+});
+
+const bench::Register hash_fast_u64("hash/fast/u64", [](::std::size_t n) {
+    return hash_all<::rusty::hash::FastHash<u64>>(input<u64>(BLOCK), n);
+});
+
+const bench::Register hash_random_u64("hash/random/u64", [](::std::size_t n) {
+    return hash_all<::rusty::hash::RandomHash<u64>>(input<u64>(BLOCK), n);
+});
+
+const bench::Register hash_fast_u128("hash/fast/u128", [](::std::size_t n) {
+    return hash_all<::rusty::hash::FastHash<u128>>(input<u128>(BLOCK), n);
+});
+
+const bench::Register hash_fast_f64("hash/fast/f64", [](::std::size_t n) {
+    auto keys = Vec<f64>{};
+    for (const auto &x : input<u32>(BLOCK)) {
+        keys.push_back(static_cast<double>(x.value) / 7.0);
+    }
+    return hash_all<::rusty::hash::FastHash<f64>>(keys, n);
+});
+
+// lookups of keys that are all multiples of the bucket count, so every
+// identity (std) hash lands in one bucket; fast and random stay flat
+
+constexpr ::std::size_t ADVERSARIAL_LEN = 1024;
+
+const Vec<u64> &adversarial_keys() {
+    static const auto keys = [] {
+        auto probe = ::std::unordered_map<u64, u64>{};
+        probe.reserve(ADVERSARIAL_LEN);
+        const auto buckets = static_cast<::std::uint64_t>(probe.bucket_count());
+        auto out = Vec<u64>{};
+        for (::std::uint64_t i = 1; i <= ADVERSARIAL_LEN; ++i) {
+            out.push_back(i * buckets);
+        }
+        return out;
+    }();
+    return keys;
+}
+
+template <template <typename> class H>
+::std::size_t adversarial_find(::std::size_t n) {
+    const auto &keys = adversarial_keys();
+    auto map = HashMap<u64, u64, H>{};
+    map.reserve(ADVERSARIAL_LEN);
+    for (const auto &k : keys) {
+        map.emplace(k, k);
+    }
+    auto acc = 0_u64;
+    for (::std::size_t i = 0; i < n; ++i) {
+        acc ^= map.find(keys[i % ADVERSARIAL_LEN])->second;
+        bench::keep(acc);
+    }
+    return n * sizeof(u64);
+}
+
+const bench::Register hash_adversarial_std(
+    "hash/adversarial_find/u64/std", [](::std::size_t n) {
+        return adversarial_find<::rusty::hash::StdHash>(n);
+    });
+
+const bench::Register hash_adversarial_fast(
+    "hash/adversarial_find/u64/fast", [](::std::size_t n) {
+        return adversarial_find<::rusty::hash::FastHash>(n);
+    });
+
+const bench::Register hash_adversarial_random(
+    "hash/adversarial_find/u64/random", [](::std::size_t n) {
+        return adversarial_find<::rusty::hash::RandomHash>(n);
+    });
+
+// iterator pipelines fused into one loop, against the same pipeline as
+// multi-pass STL code with an intermediate vector per stage
+
+const bench::Register iter_filter_map_sum_fused(
+    "iter/filter_map_sum/u32/fused", [](::std::size_t n) {
+        using ::rusty::iter::iter;
+        const auto data = input<u32>(BLOCK);
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto total = iter(data)
+                             .filter([](const u32 &x) { return x < 1U << 30U; })
+                             .map([](const u32 &x) { return x * 3U; })
+                             .sum();
+            bench::keep(total);
+        }
+        return n * BLOCK * sizeof(u32);
+    });
+
+const bench::Register iter_filter_map_sum_stl(
+    "iter/filter_map_sum/u32/stl", [](::std::size_t n) {
+        const auto data = input<u32>(BLOCK);
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto kept = Vec<u32>{};
+            ::std::copy_if(data.begin(), data.end(), ::std::back_inserter(kept),
+                           [](const u32 &x) { return x < 1U << 30U; });
+            auto mapped = Vec<u32>(kept.size());
+            ::std::transform(kept.begin(), kept.end(), mapped.begin(),
+                             [](const u32 &x) { return x * 3U; });
+            auto total = ::std::accumulate(mapped.begin(), mapped.end(), 0_u32);
+            bench::keep(total);
+        }
+        return n * BLOCK * sizeof(u32);
+    });
+
+const bench::Register iter_filter_map_collect_fused(
+    "iter/filter_map_collect/u32/fused", [](::std::size_t n) {
+        using ::rusty::iter::iter;
+        const auto data = input<u32>(BLOCK);
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto out = iter(data)
+                           .filter([](const u32 &x) { return x < 1U << 30U; })
+                           .map([](const u32 &x) { return u64(x) * 3U; })
+                           .collect<Vec>();
+            bench::keep(out[0]);
+        }
+        return n * BLOCK * sizeof(u32);
+    });
+
+const bench::Register iter_filter_map_collect_stl(
+    "iter/filter_map_collect/u32/stl", [](::std::size_t n) {
+        const auto data = input<u32>(BLOCK);
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto kept = Vec<u32>{};
+            ::std::copy_if(data.begin(), data.end(), ::std::back_inserter(kept),
+                           [](const u32 &x) { return x < 1U << 30U; });
+            auto out = Vec<u64>(kept.size());
+            ::std::transform(kept.begin(), kept.end(), out.begin(),
+                             [](const u32 &x) { return u64(x) * 3U; });
+            bench::keep(out[0]);
+        }
+        return n * BLOCK * sizeof(u32);
+    });
+
+const bench::Register iter_zip_dot_fused(
+    "iter/zip_dot/u32/fused", [](::std::size_t n) {
+        using ::rusty::iter::iter;
+        const auto a = input<u32>(BLOCK);
+        const auto b = Vec<u32>(a.rbegin(), a.rend());
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto dot = iter(a).zip(b).fold(
+                0_u64, [](u64 acc, Pair<const u32 &, const u32 &> p) {
+                    return acc + u64(p.first) * u64(p.second);
+                });
+            bench::keep(dot);
+        }
+        return n * BLOCK * 2 * sizeof(u32);
+    });
+
+const bench::Register iter_zip_dot_stl(
+    "iter/zip_dot/u32/stl", [](::std::size_t n) {
+        const auto a = input<u32>(BLOCK);
+        const auto b = Vec<u32>(a.rbegin(), a.rend());
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto products = Vec<u64>(BLOCK);
+            ::std::transform(a.begin(), a.end(), b.begin(), products.begin(),
+                             [](const u32 &x, const u32 &y) {
+                                 return u64(x) * u64(y);
+                             });
+            auto dot = ::std::accumulate(products.begin(), products.end(),
+                                         0_u64);
+            bench::keep(dot);
+        }
+        return n * BLOCK * 2 * sizeof(u32);
+    });
+
+const bench::Register iter_windows_sum_fused(
+    "iter/windows_sum/u32/fused", [](::std::size_t n) {
+        using ::rusty::iter::iter;
+        using ::rusty::iter::windows;
+        const auto data = input<u32>(BLOCK);
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto out = windows(data, 4)
+                           .map([](Slice<const u32> w) { return iter(w).sum(); })
+                           .collect();
+            bench::keep(out[0]);
+        }
+        return n * BLOCK * sizeof(u32);
+    });
+
+const bench::Register iter_windows_sum_stl(
+    "iter/windows_sum/u32/stl", [](::std::size_t n) {
+        const auto data = input<u32>(BLOCK);
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto windows = Vec<Vec<u32>>{};
+            for (::std::size_t j = 0; j + 4 <= BLOCK; ++j) {
+                windows.emplace_back(data.begin() + j, data.begin() + j + 4);
+            }
+            auto out = Vec<u32>(windows.size());
+            ::std::transform(windows.begin(), windows.end(), out.begin(),
+                             [](const Vec<u32> &w) {
+                                 return ::std::accumulate(w.begin(), w.end(),
+                                                          0_u32);
+                             });
+            bench::keep(out[0]);
+        }
+        return n * BLOCK * sizeof(u32);
+    });
+
+// parallel algorithms at 1, 2, 4, ... threads up to the hardware
+// concurrency, to show the scaling, next to the serial std algorithm; an
+// op is a whole pass over PARALLEL_LEN elements
+
+constexpr ::std::size_t PARALLEL_LEN = ::std::size_t{1} << 20U;
+
+const Vec<u32> &parallel_input() {
+    static const auto data = input<u32>(PARALLEL_LEN);
+    return data;
+}
+
+// pool of @threads, created on first use so filtered out cases spawn no
+// thread
+::std::function<::rusty::parallel::ThreadPool &()>
+lazy_pool(::std::size_t threads) {
+    using ::rusty::parallel::ThreadPool;
+    auto pool = ::std::make_shared<::std::unique_ptr<ThreadPool>>();
+    return [pool, threads]() -> ThreadPool & {
+        if (!*pool) {
+            pool->reset(new ThreadPool(threads));
+        }
+        return **pool;
+    };
+}
+
+void register_parallel(const ::std::string &suffix,
+                       const ::std::function<::rusty::parallel::ThreadPool &()>
+                           &pool) {
+    using namespace ::rusty::parallel;
+    bench::Register("parallel/sum/u64/" + suffix, [pool](::std::size_t n) {
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto total = par_iter(parallel_input(), pool())
+                             .map([](u32 x) { return u64(x.value); })
+                             .sum();
+            bench::keep(total);
+        }
+        return n * PARALLEL_LEN * sizeof(u32);
+    });
+    bench::Register("parallel/sort_unstable/u32/" + suffix,
+                    [pool](::std::size_t n) {
+                        for (::std::size_t i = 0; i < n; ++i) {
+                            auto data = parallel_input();
+                            par_sort_unstable(data, pool());
+                            bench::keep(data[0]);
+                        }
+                        return n * PARALLEL_LEN * sizeof(u32);
+                    });
+    bench::Register("parallel/prefix_sum/u32/" + suffix,
+                    [pool](::std::size_t n) {
+                        auto data = parallel_input();
+                        for (::std::size_t i = 0; i < n; ++i) {
+                            par_prefix_sum(data, pool());
+                            bench::keep(data[0]);
+                        }
+                        return n * PARALLEL_LEN * sizeof(u32);
+                    });
+    bench::Register("parallel/histogram/u32/" + suffix,
+                    [pool](::std::size_t n) {
+                        for (::std::size_t i = 0; i < n; ++i) {
+                            auto counts = par_histogram(
+                                parallel_input(), 256,
+                                [](u32 x) { return usize(x.value >> 24U); },
+                                pool());
+                            bench::keep(counts[0]);
+                        }
+                        return n * PARALLEL_LEN * sizeof(u32);
+                    });
+}
+
+const bool parallel_cases = [] {
+    const auto cores = static_cast<::std::size_t>(
+        ::std::max(::std::thread::hardware_concurrency(), 1U));
+    for (::std::size_t threads = 1; threads < cores; threads *= 2) {
+        register_parallel(::std::to_string(threads), lazy_pool(threads));
+    }
+    register_parallel(::std::to_string(cores), lazy_pool(cores));
+    return true;
+}();
+
+const bench::Register parallel_sum_std(
+    "parallel/sum/u64/std", [](::std::size_t n) {
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto total = ::std::accumulate(
+                parallel_input().begin(), parallel_input().end(), u64{0},
+                [](u64 acc, u32 x) { return acc + x; });
+            bench::keep(total);
+        }
+        return n * PARALLEL_LEN * sizeof(u32);
+    });
+
+const bench::Register parallel_sort_std(
+    "parallel/sort_unstable/u32/std", [](::std::size_t n) {
+        for (::std::size_t i = 0; i < n; ++i) {
+            auto data = parallel_input();
+            ::std::sort(data.begin(), data.end());
+            bench::keep(data[0]);
+        }
+        return n * PARALLEL_LEN * sizeof(u32);
+    });
+
+const bench::Register parallel_prefix_sum_std(
+    "parallel/prefix_sum/u32/std", [](::std::size_t n) {
+        auto data = parallel_input();
+        for (::std::size_t i = 0; i < n; ++i) {
+            ::std::partial_sum(data.begin(), data.end(), data.begin());
+            bench::keep(data[0]);
+        }
+        return n * PARALLEL_LEN * sizeof(u32);
+    });
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const char *filter = "";
+    const char *baseline_path = nullptr;
+    auto tolerance = 10.0;
+    for (int i = 1; i < argc; ++i) {
+        const auto arg = ::std::string{argv[i]};
+        if (i + 1 < argc && arg == "--filter") {
+            filter = argv[++i];
+        } else if (i + 1 < argc && arg == "--baseline") {
+            baseline_path = argv[++i];
+        } else if (i + 1 < argc && arg == "--tolerance") {
+            tolerance = ::std::atof(argv[++i]);
+        } else {
+            ::std::cerr << "usage: " << argv[0]
+                        << " [--filter SUBSTR] [--baseline FILE]"
+                           " [--tolerance PERCENT]\n";
+            return 2;
+        }
+    }
+
+    // "name/cplusplus" to ns_per_op
+    auto baseline = HashMap<::std::string, double>{};
+    if (baseline_path != nullptr) {
+        ::std::ifstream file(baseline_path);
+        for (::std::string line; ::std::getline(file, line);) {
+            const auto ns = bench::field(line, "ns_per_op");
+            if (!ns.empty()) {
+                baseline[bench::field(line, "name") + '/' +
+                         bench::field(line, "cplusplus")] =
+                    ::std::atof(ns.c_str());
+            }
+        }
+    }
+
+    auto regressions = 0;
+    for (const auto &c : bench::registry()) {
+        if (c.name.find(filter) == ::std::string::npos) {
+            continue;
+        }
+        const auto result = bench::measure(c);
+        ::std::printf("{\"name\": \"%s\", \"cplusplus\": %ld, "
+                      "\"ns_per_op\": %.3f, \"bytes_per_sec\": %.0f, "
+                      "\"allocs_per_op\": %.3f}\n",
+                      c.name.c_str(), static_cast<long>(__cplusplus),
+                      result.ns_per_op, result.bytes_per_sec,
+                      result.allocs_per_op);
+        ::std::fflush(stdout);
+        const auto it = baseline.find(
+            c.name + '/' + ::std::to_string(static_cast<long>(__cplusplus)));
+        const auto base = it != baseline.end() ? it->second : 0.0;
+        if (base > 0 && result.ns_per_op > base * (1 + tolerance / 100)) {
+            ::std::fprintf(stderr, "regression: %s (c++ %ld) %.3f -> %.3f ns\n",
+                           c.name.c_str(), static_cast<long>(__cplusplus),
+                           base, result.ns_per_op);
+            ++regressions;
+        }
+    }
+    return regressions == 0 ? 0 : 1;
+}
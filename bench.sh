@@ -0,0 +1,40 @@
+#!/bin/sh
+
+# Build bench.cpp for every supported standard and run it, appending the
+# results to bench_output.txt. Runs are compared against bench_baseline.txt
+# when it exists; `sh bench.sh save` stores the results as the new baseline.
+# CXX, CXXFLAGS, STANDARDS and TOLERANCE (percent) override the defaults.
+
+BASE_DIR=$(dirname $(readlink -f "$0"))
+
+do_bench() {
+    local CXX="${CXX:-c++}"
+    local CXXFLAGS="${CXXFLAGS:--O2}"
+    local STANDARDS="${STANDARDS:-11 14 17 20}"
+    local TOLERANCE="${TOLERANCE:-10}"
+    local OUTPUT="$BASE_DIR/bench_output.txt"
+    local BASELINE="$BASE_DIR/bench_baseline.txt"
+    local BINARY="${TMPDIR:-/tmp}/rusty-bench-$$"
+    local STATUS=0
+
+    rm -f "$OUTPUT"
+    for STD in $STANDARDS; do
+        echo "c++$STD: $CXX $CXXFLAGS" >&2
+        $CXX -std=c++$STD $CXXFLAGS -I"$BASE_DIR" "$BASE_DIR/bench.cpp" \
+            -pthread -o "$BINARY" || return 1
+        if [ "$1" != "save" ] && [ -f "$BASELINE" ]; then
+            "$BINARY" --baseline "$BASELINE" --tolerance "$TOLERANCE" \
+                >> "$OUTPUT" || STATUS=1
+        else
+            "$BINARY" >> "$OUTPUT" || STATUS=1
+        fi
+    done
+    rm -f "$BINARY"
+
+    if [ "$1" = "save" ]; then
+        cp "$OUTPUT" "$BASELINE"
+    fi
+    return $STATUS
+}
+
+do_bench "$@"
@@ -0,0 +1,6 @@
+# SPDX-License-Identifier: MIT
+# Copyright(c) 2021 ur4t
+
+include(CMakeFindDependencyMacro)
+find_dependency(Threads)
+include(${CMAKE_CURRENT_LIST_DIR}/rusty-targets.cmake)
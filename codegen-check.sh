@@ -0,0 +1,59 @@
+#!/bin/sh
+
+# Check that reverse_bytes of every integer width compiles to a byte swap
+# instruction (bswap, rol/ror or rev) without any branch, for every standard.
+# Fails naming the offending function otherwise. CXX, CXXFLAGS (default
+# -O2) and STANDARDS override the defaults.
+
+BASE_DIR=$(dirname $(readlink -f "$0"))
+
+do_codegen_check() {
+    local CXX="${CXX:-c++}"
+    local CXXFLAGS="${CXXFLAGS:--O2}"
+    local STANDARDS="${STANDARDS:-11 14 17 20}"
+    local SOURCE="${TMPDIR:-/tmp}/rusty-codegen-$$.cpp"
+    local STATUS=0
+
+    cat > "$SOURCE" << 'EOF'
+#include "rusty.hpp"
+
+using namespace ::rusty::numeric_types;
+
+#define SWAP_FN(ALIAS)                                                         \
+    extern "C" ALIAS rusty_swap_##ALIAS(ALIAS x) { return x.reverse_bytes(); }
+
+SWAP_FN(u16)
+SWAP_FN(u32)
+SWAP_FN(u64)
+SWAP_FN(i16)
+SWAP_FN(i32)
+SWAP_FN(i64)
+EOF
+
+    for STD in $STANDARDS; do
+        local ASM
+        ASM=$($CXX -std=c++$STD $CXXFLAGS -I"$BASE_DIR" -S -o - "$SOURCE") || {
+            STATUS=1
+            continue
+        }
+        for FN in u16 u32 u64 i16 i32 i64; do
+            # instructions between the label and the end of the function
+            local BODY=$(echo "$ASM" |
+                awk "/^_?rusty_swap_$FN:/ { on = 1; next }
+                     on && /^\t\.(cfi_endproc|size)/ { exit }
+                     on && /^\t[a-z]/ { print \$1 }")
+            if ! echo "$BODY" | grep -Eq '^(bswap|rol|ror|rev|xchg)'; then
+                echo "c++$STD: reverse_bytes of $FN has no byte swap" >&2
+                STATUS=1
+            fi
+            if echo "$BODY" | grep -Eq '^(j[a-z]+|b\.[a-z]+|cbn?z|tbn?z)$'; then
+                echo "c++$STD: reverse_bytes of $FN branches" >&2
+                STATUS=1
+            fi
+        done
+    done
+    rm -f "$SOURCE"
+    return $STATUS
+}
+
+do_codegen_check
@@ -0,0 +1,36 @@
+#!/bin/sh
+
+# Time building a synthetic project of TUS (default 200) translation units
+# including rusty.hpp, plain and with the precompiled header, plus through
+# `import rusty;` with MODULE=1 (CMake 3.28+ and a module capable compiler).
+# CMAKE_GENERATOR, CXX, CXXFLAGS and JOBS are honored.
+
+BASE_DIR=$(dirname $(readlink -f "$0"))
+
+do_compile_bench() {
+    local TUS="${TUS:-200}"
+    local JOBS="${JOBS:-$(nproc 2>/dev/null || echo 1)}"
+    local WORK_DIR="${TMPDIR:-/tmp}/rusty-compile-bench-$$"
+    local VARIANTS="plain pch"
+    if [ "$MODULE" = "1" ]; then
+        VARIANTS="$VARIANTS module"
+    fi
+
+    for VARIANT in $VARIANTS; do
+        local FLAGS="-DRUSTY_BUILD_EXAMPLES=OFF -DRUSTY_COMPILE_BENCH_TUS=$TUS"
+        case $VARIANT in
+        pch) FLAGS="$FLAGS -DRUSTY_PRECOMPILE_HEADER=ON" ;;
+        module) FLAGS="$FLAGS -DRUSTY_BUILD_MODULE=ON" ;;
+        esac
+        cmake -S "$BASE_DIR" -B "$WORK_DIR/$VARIANT" $FLAGS > /dev/null ||
+            return 1
+        local START=$(date +%s%N)
+        cmake --build "$WORK_DIR/$VARIANT" --target rusty_compile_bench \
+            -j "$JOBS" > /dev/null || return 1
+        local END=$(date +%s%N)
+        echo "$VARIANT: $TUS TUs in $(((END - START) / 1000000)) ms"
+    done
+    rm -rf "$WORK_DIR"
+}
+
+do_compile_bench
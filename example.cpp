@@ -1,9 +1,22 @@
 // SPDX-License-Identifier: MIT
 // Copyright(c) 2021 ur4t
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+// dbg_time, dbg_count and dbg_hist record, test_metrics dumps them
+#define RUSTY_DBG_METRICS
+#define RUSTY_DBG_METRICS_AT_EXIT 0
 
 #include "rusty.hpp"
 
@@ -38,19 +51,19 @@ void test_numeric_type_length() {
 
 void test_integer_literals() {
     using namespace ::rusty::numeric_types::literal;
+    using ::rusty::numeric_types::i32;
+    using ::rusty::numeric_types::i64;
     banner("testing integer literals");
     dbg(-0x123456789abcdef0_i64, << ::std::showpos);
     dbg(+0x123456789abcdef0_i64, << ::std::showpos);
-    dbg(-0xfedcba9876543210_i64, << ::std::showpos);
-    dbg(+0xfedcba9876543210_i64, << ::std::showpos);
+    dbg((0xfedcba9876543210_u64).as<i64>(), << ::std::showpos);
     dbg(-0x8000000000000000_i64, << ::std::showpos);
-    dbg(+0x8000000000000000_i64, << ::std::showpos);
+    dbg((0x8000000000000000_u64).as<i64>(), << ::std::showpos);
     dbg(-0x12345678_i32, << ::std::showpos);
     dbg(+0x12345678_i32, << ::std::showpos);
-    dbg(-0x87654321_i32, << ::std::showpos);
-    dbg(+0x87654321_i32, << ::std::showpos);
+    dbg((0x87654321_u32).as<i32>(), << ::std::showpos);
     dbg(-0x80000000_i32, << ::std::showpos);
-    dbg(+0x80000000_i32, << ::std::showpos);
+    dbg((0x80000000_u32).as<i32>(), << ::std::showpos);
 }
 
 void test_floating_literals() {
@@ -89,6 +102,418 @@ void test_floating_literals() {
     dbg((1.1_f64).reverse_bytes());
 }
 
+void test_reverse_bytes() {
+    using namespace ::rusty::numeric_types;
+    using namespace ::rusty::numeric_types::literal;
+    banner("testing reverse bytes");
+#ifdef RUSTY_HAS_BUILTIN_BIT_CAST
+    // evaluated at compile time, a loop could not survive here
+    static_assert(0x1122_u16 .reverse_bytes() == 0x2211_u16, "u16 swap");
+    static_assert(0x11223344_u32 .reverse_bytes() == 0x44332211_u32,
+                  "u32 swap");
+    static_assert(u32::from_be_bytes({0x11, 0x22, 0x33, 0x44}) == 0x11223344,
+                  "u32 from_be_bytes");
+#endif
+    dbg(0x1122334455667788_u64 .reverse_bytes(),
+        << ::std::showbase << ::std::hex);
+    dbg((1.1_f64).reverse_bytes().reverse_bytes());
+}
+
+void test_slice_conversion() {
+    using namespace ::rusty::numeric_types;
+    using namespace ::rusty::collections::ostream;
+    using ::rusty::collections::Vec;
+    banner("testing slice conversion");
+    const auto bytes = Vec<::std::uint8_t>{
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a,
+        0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15,
+        0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20,
+        0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b};
+    auto v32 = Vec<u32>(bytes.size() / sizeof(u32));
+    u32::from_be_slice(bytes.data(), v32.size(), v32.data());
+    dbg(v32, << ::std::showbase << ::std::hex);
+    u32::swap_bytes_inplace(v32);
+    dbg(v32, << ::std::showbase << ::std::hex);
+    auto v16 = Vec<u16>(bytes.size() / sizeof(u16));
+    u16::from_be_slice(bytes.data(), v16.size(), v16.data());
+    dbg(v16, << ::std::showbase << ::std::hex);
+    auto v64 = Vec<u64>(bytes.size() / sizeof(u64));
+    u64::from_be_slice(bytes.data(), v64.size(), v64.data());
+    dbg(v64, << ::std::showbase << ::std::hex);
+    auto out = Vec<::std::uint8_t>(v64.size() * sizeof(u64));
+    u64::to_be_slice(v64.data(), v64.size(), out.data());
+    dbg(::std::equal(out.begin(), out.end(), bytes.begin()),
+        << ::std::boolalpha);
+}
+
+void test_endian_slice() {
+    using namespace ::rusty::numeric_types;
+    using namespace ::rusty::collections::ostream;
+    using ::rusty::collections::Vec;
+    banner("testing endian slice");
+    // odd offset to exercise unaligned loads
+    const auto bytes = Vec<::std::uint8_t>{0xff, 0x00, 0x00, 0x00, 0x03, 0x00,
+                                           0x00, 0x00, 0x01, 0x00, 0x00,
+                                           0x00, 0x02, 0x00, 0x00, 0x01, 0x00};
+    const auto be = BeSlice<u32>{bytes.data() + 1, 4};
+    const auto le = LeSlice<u32>{bytes.data() + 1, 4};
+    dbg(be);
+    dbg(le, << ::std::showbase << ::std::hex);
+    dbg(be[2]);
+    dbg(be.end() - be.begin());
+    dbg(::std::accumulate(be.begin(), be.end(), u64{0}));
+    dbg(*::std::max_element(be.begin(), be.end()));
+    dbg(::std::is_sorted(be.subslice(0, 3).begin(), be.subslice(0, 3).end()),
+        << ::std::boolalpha);
+#if __cplusplus >= 202002L
+    // decoded by value, yet random access to the C++20 iterator concepts
+    static_assert(::std::random_access_iterator<decltype(be.begin())>);
+    dbg(*::std::ranges::max_element(be.begin(), be.end()));
+    dbg(::std::ranges::is_sorted(be.begin() + 1, be.end()),
+        << ::std::boolalpha);
+#endif
+}
+
+void test_byte_io() {
+    using namespace ::rusty::numeric_types;
+    using namespace ::rusty::numeric_types::literal;
+    using namespace ::rusty::collections::ostream;
+    using namespace ::rusty::io;
+    using ::rusty::collections::Vec;
+    banner("testing byte io");
+    auto writer = ByteWriter{};
+    writer.write_u8(0xab_u8);
+    writer.write_u16_be(0x1234_u16);
+    writer.write_u32_le(0x12345678_u32);
+    writer.write_f64_be(1.1_f64);
+    const auto values = Vec<u32>{1, 2, 3, 4, 5};
+    writer.write_from<u32, true>(values.data(), values.size());
+    dbg(writer.bytes(), << ::std::showbase << ::std::hex);
+
+    auto reader = ByteReader{writer.bytes().data(), writer.bytes().size()};
+    dbg(reader.read_u8(), << ::std::showbase << ::std::hex);
+    dbg(reader.read_u16_be(), << ::std::showbase << ::std::hex);
+    dbg(reader.read_u32_le(), << ::std::showbase << ::std::hex);
+    dbg(reader.read_f64_be());
+    dbg((reader.read_slice<u32, true>(2)));
+    auto rest = Vec<u32>(3);
+    reader.read_into<u32, true>(rest.data(), rest.size());
+    dbg(rest);
+    dbg(reader.is_empty(), << ::std::boolalpha);
+    try {
+        reader.read_u8();
+    } catch (const ::std::out_of_range &e) {
+        dbg(e.what());
+    }
+
+    auto stream = ::std::stringstream{};
+    {
+        auto out = StreamWriter{OstreamSink{stream}, 16};
+        for (auto i = 0_u32; i < 10_u32; ++i) {
+            out.write_u32_be(i);
+        }
+    }
+    auto in = StreamReader{IstreamSource{stream}, 8};
+    auto sum = 0_u32;
+    for (auto i = 0; i < 10; ++i) {
+        sum += in.read_u32_be();
+    }
+    dbg(sum);
+}
+
+void test_serialization() {
+    using namespace ::rusty::numeric_types;
+    using namespace ::rusty::numeric_types::literal;
+    using namespace ::rusty::collections;
+    using namespace ::rusty::collections::ostream;
+    using namespace ::rusty::io;
+    banner("testing serialization");
+    const auto values = Vec<u32>{1, 2, 3};
+    const auto prices = HashMap<u64, f64>{{7_u64, 0.5_f64}};
+    auto writer = ByteWriter{};
+    save(writer, values);
+    save(writer, prices);
+    dbg(writer.bytes(), << ::std::showbase << ::std::hex);
+
+    auto reader = ByteReader{writer.bytes().data(), writer.bytes().size()};
+    dbg(load<Vec<u32>>(reader));
+    dbg((load<HashMap<u64, f64>>(reader)));
+    reader.seek(0);
+    dbg(view<u32>(reader));
+    dbg((view_map<u64, f64>(reader).second));
+    reader.seek(0);
+    try {
+        load<Vec<i32>>(reader);
+    } catch (const ::std::invalid_argument &e) {
+        dbg(e.what());
+    }
+
+    // foreign endian: view() leaves the reader at the column for load()
+    auto swapped = writer.bytes();
+    swapped[4] = 1;
+    reader = ByteReader{swapped.data(), swapped.size()};
+    try {
+        view<u32>(reader);
+    } catch (const ::std::invalid_argument &e) {
+        dbg(e.what());
+    }
+    dbg(reader.position());
+    dbg(load<Vec<u32>>(reader), << ::std::hex);
+
+    // corrupt count 2 ** 61 + 1, whose byte size wraps to 4
+    auto corrupt = writer.bytes();
+    corrupt[15] = 0x20;
+    reader = ByteReader{corrupt.data(), corrupt.size()};
+    try {
+        view<u32>(reader);
+    } catch (const ::std::out_of_range &e) {
+        dbg(e.what());
+    }
+    auto stream = ::std::stringstream{
+        ::std::string(corrupt.begin(), corrupt.end())};
+    auto streamed = StreamReader{IstreamSource{stream}};
+    try {
+        load<Vec<u32>>(streamed);
+    } catch (const ::std::out_of_range &e) {
+        dbg(e.what());
+    }
+    // 2 ** 63 + 1 elements do not even fit in memory
+    corrupt[15] = 0x80;
+    reader = ByteReader{corrupt.data(), corrupt.size()};
+    try {
+        load<Vec<u32>>(reader);
+    } catch (const ::std::invalid_argument &e) {
+        dbg(e.what());
+    }
+}
+
+// digits grouped by three, ';' as the decimal point
+struct GroupingPunct : ::std::numpunct<char> {
+    char do_thousands_sep() const override { return ','; }
+    ::std::string do_grouping() const override { return "\3"; }
+    char do_decimal_point() const override { return ';'; }
+};
+
+void test_formatting() {
+    using namespace ::rusty::numeric_types;
+    using namespace ::rusty::numeric_types::literal;
+    banner("testing formatting");
+    char buffer[detail::MAX_FORMAT_CHARS]; // NOLINT(modernize-avoid-c-arrays)
+    dbg(::std::string(buffer, (0xffffffffffffffff_u64).write_to(buffer)));
+    dbg(::std::string(buffer, i64(-0x8000000000000000_i64).write_to(buffer)));
+    dbg((0.1_f32).to_string());
+    dbg((0.1_f64).to_string());
+    dbg((1e300_f64).to_string());
+    dbg((100.0_f64).to_string());
+    dbg(i8(-128_i8).to_string());
+    ::std::cerr << "display: " << (0.3_f64).display() << ", "
+                << f64(1.0_f64 / 3.0_f64).display() << '\n';
+    // a grouping locale goes through num_put, display() never does
+    ::std::ostringstream grouped;
+    grouped.imbue(::std::locale(grouped.getloc(), new GroupingPunct));
+    grouped << 1234567_u32 << ' ' << (1234567_u32).display() << ' ' << 1.5_f64;
+    dbg(grouped.str());
+}
+
+void test_parsing() {
+    using namespace ::rusty::numeric_types;
+    using namespace ::rusty::collections::ostream;
+    using ::rusty::collections::Vec;
+    using ::std::string;
+    banner("testing parsing");
+    dbg(u64::from_str(string("18446744073709551615")).unwrap());
+    dbg(to_str(u64::from_str(string("18446744073709551616")).error));
+    dbg(i8::from_str(string("-128")).unwrap());
+    dbg(to_str(i8::from_str(string("-129")).error));
+    dbg(to_str(u32::from_str(string("12a")).error));
+    dbg(i32::from_str_radix(string("-zz"), 36).unwrap());
+    dbg(f64::from_str(string("-2.5e-3")).unwrap());
+    dbg(f32::from_str(string("0.1")).unwrap());
+    const auto text = string("1,22,333,4444,55555");
+    auto values = Vec<u32>{};
+    dbg(to_str(u32::parse_delimited(text.data(), text.data() + text.size(),
+                                    ',', values)));
+    dbg(values);
+}
+
+void test_i128() {
+    using namespace ::rusty::collections::ostream;
+    using namespace ::rusty::numeric_types;
+    using namespace ::rusty::numeric_types::literal;
+    using ::std::string;
+    banner("testing 128 bit integers");
+    const auto max = 340282366920938463463374607431768211455_u128;
+    dbg(max);
+    dbg(0xffffffffffffffffffffffffffffffff_u128 == max);
+    dbg(u128(max / 10_u128 * 10_u128 + 5_u128) == max);
+    dbg(i128(-170141183460469231731687303715884105727_i128 - 1_i128));
+    dbg(u128(u128(~0ULL) * u128(~0ULL)));
+    dbg(0x0102030405060708090a0b0c0d0e0f10_u128, << ::std::hex << ::std::showbase);
+    dbg((0x0102030405060708090a0b0c0d0e0f10_u128).to_be_bytes());
+    dbg(i128(-1_i128).to_string());
+    dbg(u128::from_str(string("100000000000000000000000000000000000000"))
+            .unwrap());
+    dbg(to_str(u128::from_str(string("340282366920938463463374607431768211456"))
+                   .error));
+    // divisors below 2^64 split the quotient into two 64-bit halves
+    dbg(u128(1_u128 << 127) / u128(1_u128 << 33) == 1_u128 << 94);
+    dbg(u128(max / 0xfedcba9876543210_u128));
+    dbg(u128(max % 0xfedcba9876543210_u128));
+    dbg(i128(-170141183460469231731687303715884105727_i128 / 0x123456789_i128));
+#if !defined(RUSTY_HAS_INT128) && defined(__SIZEOF_INT128__)
+    // the two limb division against the native one
+    __extension__ using native = unsigned __int128;
+    const auto to_native = [](u128 v) {
+        return native(u128(v >> 64).as<u64>()) << 64 | v.as<u64>();
+    };
+    auto random = ::std::mt19937_64{42};
+    auto mismatches = 0;
+    for (auto i = 0; i < 100000; ++i) {
+        const auto n = u128(random()) << 64 | u128(random());
+        // divisors of every width, most of them below 2^64
+        auto d = u128(random()) << 64 | u128(random());
+        d >>= random() % 128;
+        if (d == 0_u128) {
+            continue;
+        }
+        if (to_native(n / d) != to_native(n) / to_native(d) ||
+            to_native(n % d) != to_native(n) % to_native(d)) {
+            ++mismatches;
+        }
+    }
+    dbg(mismatches);
+#endif
+}
+
+void test_overflow() {
+    using namespace ::rusty::collections::ostream;
+    using namespace ::rusty::numeric_types;
+    using namespace ::rusty::numeric_types::literal;
+    using ::rusty::collections::Array;
+    banner("testing overflow aware arithmetic");
+    dbg(u8(250).checked_add(5).unwrap());
+    dbg(u8(250).checked_add(6).is_none());
+    dbg(u8(250).wrapping_add(10));
+    dbg(u8(250).saturating_add(10));
+    dbg(i8(-100).saturating_sub(100));
+    dbg(i32(0x7fffffff_i32).overflowing_mul(2).second);
+    dbg(i64(-0x8000000000000000_i64).checked_div(-1).is_none());
+    dbg(i64(-0x8000000000000000_i64).wrapping_neg());
+    auto a = Array<u8, 20>{};
+    auto b = Array<u8, 20>{};
+    auto c = Array<u8, 20>{};
+    for (u8 i = 0; i < 20; ++i) {
+        a[i] = u8(i * 13);
+        b[i] = 200;
+    }
+    u8::saturating_add_slice(a.data(), b.data(), c.data(), c.size());
+    dbg(c);
+}
+
+void test_conversions() {
+    using namespace ::rusty::numeric_types;
+    using namespace ::rusty::numeric_types::literal;
+    banner("testing conversions");
+    dbg(u8::try_from(300).is_none());
+    dbg(u8::try_from(255_u32).unwrap());
+    dbg(u32::try_from(i64(-1)).unwrap_or(0_u32));
+    dbg(i64::try_from(0xffffffff_u32).unwrap());
+    dbg(u64::from(0xffffffff_u32));
+    dbg(f64::from(i32(-0x7fffffff - 1)));
+    dbg((300_u32).as<u8>());
+    dbg(i8(-1).as<u32>());
+    dbg((1e10_f64).as<i32>());
+    dbg(f64(-1.5).as<u8>());
+    dbg(f64(::std::nan("")).as<i32>());
+    dbg((7_i32).as<double>());
+}
+
+void test_bits() {
+    using namespace ::rusty::collections::ostream;
+    using namespace ::rusty::numeric_types;
+    using ::rusty::collections::Array;
+    banner("testing bit operations");
+    dbg(u32(0xf0).count_ones());
+    dbg(u32(0xf0).leading_zeros());
+    dbg(u32(0xf0).trailing_zeros());
+    dbg(i8(-1).leading_ones());
+    dbg(u8(0x81).rotate_left(1));
+    dbg(u16(1).rotate_right(1));
+    dbg(u64(1000).next_power_of_two());
+    dbg(u8(129).checked_next_power_of_two().is_none());
+    auto bitmap = Array<u64, 5>{};
+    bitmap.fill(0x0123456789abcdefULL);
+    dbg(u64::count_ones_slice(bitmap.data(), bitmap.size()));
+}
+
+void test_parallel() {
+    using namespace ::rusty::collections::ostream;
+    using namespace ::rusty::numeric_types;
+    using namespace ::rusty::parallel;
+    using ::rusty::collections::Vec;
+    banner("testing parallel algorithms");
+    ThreadPool pool(4); // oversubscribed on fewer cores, still correct
+    auto v = Vec<u32>(100000);
+    for (usize i = 0; i < v.size(); ++i) {
+        v[i] = u32((i * 2654435761U) % 1000);
+    }
+    dbg(par_iter(v, pool).map([](u32 x) { return u64(x); }).sum());
+    const auto max_square =
+        par_iter(v, pool)
+            .map([](u32 x) { return x * x; })
+            .reduce(0, [](u32 a, u32 b) { return a > b ? a : b; });
+    dbg(max_square);
+    auto sorted = v;
+    par_sort_unstable(sorted, pool);
+    dbg(::std::is_sorted(sorted.begin(), sorted.end()));
+    const auto quarters = par_histogram(
+        v, 4, [](u32 x) { return static_cast<usize>(x / 250); }, pool);
+    dbg(quarters);
+    auto ones = Vec<u64>(10, 1);
+    par_prefix_sum(ones, pool);
+    dbg(ones);
+    par_iter(ones, pool).for_each([](u64 &x) { x *= 2; });
+    const auto odd =
+        par_iter(ones, pool).map([](u64 x) { return x + 1; }).collect();
+    dbg(odd, << max_items(4));
+}
+
+void test_iter() {
+    using namespace ::rusty::collections::ostream;
+    using namespace ::rusty::numeric_types;
+    using namespace ::rusty::iter;
+    using ::rusty::collections::Pair;
+    using ::rusty::collections::Slice;
+    using ::rusty::collections::Vec;
+    banner("testing iterator adapters");
+    auto v = Vec<u32>{3, 1, 4, 1, 5, 9, 2, 6};
+    // one loop, no intermediate container
+    const auto big = iter(v)
+                         .filter([](const u32 &x) { return x > 2; })
+                         .map([](const u32 &x) { return x * 10; })
+                         .collect<Vec>();
+    dbg(big);
+    const auto firsts = iter(v).enumerate().skip(2).take(3).collect();
+    dbg(firsts);
+    const auto sums = chunks(v, 3)
+                          .map([](Slice<u32> s) { return iter(s).sum(); })
+                          .collect();
+    dbg(sums);
+    const auto rising =
+        windows(v, 2)
+            .filter([](const Slice<u32> &w) { return w[0] < w[1]; })
+            .count();
+    dbg(rising);
+    const auto weights = Vec<f64>{0.5, 0.25};
+    const auto dot = iter(v).zip(weights).fold(
+        0.0, [](double acc, Pair<u32 &, const f64 &> p) {
+            return acc + p.first * p.second;
+        });
+    dbg(dot);
+    iter(v).for_each([](u32 &x) { x += 1; });
+    dbg(v);
+}
+
 void test_collections() {
     using namespace ::rusty::numeric_types;
     using namespace ::rusty::collections::ostream;
@@ -100,8 +525,271 @@ void test_collections() {
     dbg((Vec<i32>{1, 2, 3}));
     dbg((Array<string, 4>{"11", "22", "33", "44"}));
     dbg((HashMap<i32, string>{{1, "str1"}, {2, "str2"}}));
+    dbg((Vec<Vec<f64>>{{0.5, 1.0 / 3}, {}, {2.0}}));
+    const auto large = Vec<string>(1000000, "str");
+    dbg(large.size());
+    dbg(large, << max_items(4));
+    dbg((Vec<Vec<u32>>{{1, 2, 3}, {4, 5, 6}, {7, 8, 9}}),
+        << max_items(0) << max_bytes(12));
+    // elements follow the stream locale like single numbers
+    ::std::ostringstream grouped;
+    grouped.imbue(::std::locale(grouped.getloc(), new GroupingPunct));
+    grouped << Vec<u32>{1234567} << Vec<f64>{1.5};
+    dbg(grouped.str());
+}
+
+void test_flat_hash_map() {
+    using namespace ::rusty::collections::ostream;
+    using namespace ::rusty::numeric_types;
+    using ::rusty::collections::FlatHashMap;
+    using ::rusty::hash::RandomHash;
+    banner("testing flat hash map");
+    auto map = FlatHashMap<u32, ::std::string>{{1, "one"}, {2, "two"}};
+    map[3] = "three";
+    map.try_emplace(4, 4, '4');
+    dbg(map.size());
+    dbg(map.at(4));
+    dbg(map.erase(2));
+    dbg(map.count(2));
+    dbg(map.contains(3));
+    auto squares = FlatHashMap<u64, u64>{};
+    for (u64 i = 0; i < 100000; ++i) {
+        squares[i] = i * i;
+    }
+    for (u64 i = 0; i < 100000; i += 2) {
+        squares.erase(i);
+    }
+    dbg(squares.size());
+    dbg(squares.find(99999)->second);
+    dbg(squares.find(99998) == squares.end());
+    dbg((FlatHashMap<i32, f64>{{-1, 0.5}}));
+    // two integers are a capacity and a hasher, never an iterator range
+    static_assert(!::std::is_constructible<FlatHashMap<u32, u32>, int,
+                                           int>::value,
+                  "integers are not iterators");
+    const auto seeded =
+        FlatHashMap<u32, u32, RandomHash<u32>>(16, RandomHash<u32>{0});
+    dbg(seeded.capacity() >= 16);
+}
+
+void test_hashers() {
+    using namespace ::rusty::collections::ostream;
+    using namespace ::rusty::numeric_types;
+    using namespace ::rusty::hash;
+    using ::rusty::collections::HashMap;
+    banner("testing hashers");
+    dbg(FastHash<u64>{}(1) != FastHash<u64>{}(2));
+    dbg(FastHash<f64>{}(0.0) == FastHash<f64>{}(-0.0));
+    dbg(RandomHash<u64>{}(1) != RandomHash<u64>{}(1)); // seeded per instance
+    dbg(RandomHash<u64>{42}(1) == RandomHash<u64>{42}(1));
+    auto ids = HashMap<u64, u32, FastHash>{};
+    for (u32 i = 0; i < 1000; ++i) {
+        ids[u64(i) << 32] = i;
+    }
+    dbg(ids.at(u64(999) << 32));
+    auto names = HashMap<::std::string, u8, RandomHash>{{"one", 1}};
+    dbg(names);
+}
+
+// copyable and throwing-movable, so growth copies until the budget runs out
+struct Fragile {
+    static int copies_left;
+    int value;
+    explicit Fragile(int value) : value{value} {}
+    Fragile(const Fragile &other) : value{other.value} {
+        if (copies_left == 0) {
+            throw ::std::runtime_error("copy failed");
+        }
+        --copies_left;
+    }
+    Fragile(Fragile &&other) : Fragile(static_cast<const Fragile &>(other)) {}
+    Fragile &operator=(const Fragile &) = default;
+};
+
+int Fragile::copies_left = -1;
+
+void test_small_vec() {
+    using namespace ::rusty::collections::ostream;
+    using namespace ::rusty::numeric_types;
+    using ::rusty::collections::SmallVec;
+    banner("testing small vec");
+    auto v = SmallVec<u16, 4>{1, 2, 3};
+    dbg(v.spilled());
+    v.push_back(4);
+    v.insert(v.begin(), 0);
+    dbg(v);
+    dbg(v.spilled());
+    v.erase(v.begin() + 1, v.end() - 1);
+    v.shrink_to_fit();
+    dbg(v);
+    dbg(v.spilled());
+    auto words = SmallVec<::std::string, 2>{"moved", "inline"};
+    const auto taken = ::std::move(words);
+    dbg(taken);
+    dbg(words.size());
+    // an empty range erases nothing, spilled past the inline capacity
+    auto names = SmallVec<::std::string, 3>{};
+    for (auto i = 0; i < 13; ++i) {
+        names.push_back(::std::string(20, static_cast<char>('a' + i)));
+    }
+    names.erase(names.begin() + 12, names.begin() + 12);
+    dbg(names.size());
+    dbg(names.back());
+    // a copy throwing mid-growth leaves the elements where they were
+    auto fragile = SmallVec<Fragile, 2>{};
+    fragile.emplace_back(1);
+    fragile.emplace_back(2);
+    Fragile::copies_left = 1;
+    try {
+        fragile.emplace_back(3);
+    } catch (const ::std::runtime_error &) {
+        dbg(fragile.spilled());
+        dbg(fragile.size());
+        dbg(fragile[1].value);
+    }
+    Fragile::copies_left = -1;
+}
+
+void test_arena() {
+    using namespace ::rusty::collections::ostream;
+    using namespace ::rusty::numeric_types;
+    using ::rusty::alloc::Arena;
+    namespace arena = ::rusty::alloc::arena;
+    banner("testing arena");
+    Arena pool;
+    for (u32 request = 0; request < 3; ++request) {
+        const Arena::Scope scope(pool); // released at the end of a request
+        auto v = arena::Vec<u32>(&pool);
+        for (u32 i = 0; i < 4; ++i) {
+            v.push_back(request * 10 + i);
+        }
+        dbg(v);
+    }
+    dbg(pool.capacity());
+    pool.reset();
+}
+
+void test_dbg() {
+    using namespace ::rusty::collections::ostream;
+    using ::rusty::collections::Vec;
+    banner("testing dbg");
+    auto v = Vec<int>{1, 2, 3};
+    dbg(v).push_back(4); // forwarded by reference, nothing copied
+    dbg(v);
+    dbg_level(2, v).push_back(5); // above RUSTY_DBG_LEVEL, only evaluated
+    dbg(::std::move(v)).push_back(6); // moved into the result, v is empty
+    dbg(v.size());
+    dbg(::std::max({3, 1, 2}, [](int a, int b) { return a < b; }));
+}
+
+void test_dbg_threads() {
+    using namespace ::rusty::collections::ostream;
+    using ::rusty::collections::Vec;
+    banner("testing dbg from threads");
+    // every record is one write, lines never interleave
+    constexpr auto THREADS = 8;
+    constexpr auto RECORDS = 2000;
+    const auto run = [] {
+        auto threads = Vec<::std::thread>{};
+        for (auto i = 0; i < THREADS; ++i) {
+            threads.emplace_back([i] {
+                const auto v = Vec<int>(16, i);
+                for (auto j = 0; j < RECORDS; ++j) {
+                    dbg(v);
+                }
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+        ::rusty::debug::flush();
+    };
+#if defined(__unix__) || defined(__APPLE__)
+    // capture stderr in a file and check each line is one whole record
+    auto *capture = ::std::tmpfile();
+    const auto saved = ::dup(STDERR_FILENO);
+    ::dup2(::fileno(capture), STDERR_FILENO);
+    run();
+    ::dup2(saved, STDERR_FILENO);
+    ::close(saved);
+    ::std::rewind(capture);
+    auto records = 0;
+    auto torn = 0;
+    auto line = ::std::string{};
+    for (int c; (c = ::std::fgetc(capture)) != EOF;) {
+        if (c != '\n') {
+            line.push_back(static_cast<char>(c));
+            continue;
+        }
+        const auto body = line.find("] v = [");
+        const auto digit =
+            body == ::std::string::npos ? '?' : line[body + 7];
+        auto whole = body != ::std::string::npos && line.front() == '[' &&
+                     line.back() == ']';
+        for (auto k = 0; whole && k < 16; ++k) {
+            const auto at = body + 7 + static_cast<::std::size_t>(k) * 3;
+            whole = line[at] == digit &&
+                    line.compare(at + 1, 2, k == 15 ? "]" : ", ") == 0;
+        }
+        records += 1;
+        torn += whole ? 0 : 1;
+        line.clear();
+    }
+    ::std::fclose(capture);
+    dbg(records);
+    dbg(torn);
+    if (records != THREADS * RECORDS || torn != 0) {
+        ::std::exit(1);
+    }
+#else
+    run();
+#endif
 }
 
+void test_metrics() {
+    banner("testing metrics");
+    auto threads = ::std::vector<::std::thread>{};
+    for (auto i = 0; i < 4; ++i) {
+        threads.emplace_back([] {
+            for (auto j = 0U; j < 1000U; ++j) {
+                dbg_time("work");
+                dbg_count("iterations");
+                dbg_hist("j % 100", j % 100);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    ::rusty::debug::dump_metrics();
+}
+
+#if __cplusplus >= 201402L
+// every mutating operator evaluated at compile time, false on any mismatch
+constexpr bool test_constexpr_operators() {
+    using namespace ::rusty::numeric_types;
+    using namespace ::rusty::numeric_types::literal;
+    auto x = 5_u64;
+    auto ok = (x += 3) == 8_u64;
+    ok = ok && (x -= 2) == 6_u64;
+    ok = ok && (x *= 7) == 42_u64;
+    ok = ok && (x /= 4) == 10_u64;
+    ok = ok && (x %= 4) == 2_u64;
+    ok = ok && (x &= 3) == 2_u64;
+    ok = ok && (x |= 5) == 7_u64;
+    ok = ok && (x ^= 1) == 6_u64;
+    ok = ok && (x <<= 4) == 96_u64;
+    ok = ok && (x >>= 3) == 12_u64;
+    ok = ok && ++x == 13_u64;
+    ok = ok && x++ == 13_u64 && x == 14_u64;
+    ok = ok && --x == 13_u64;
+    ok = ok && x-- == 13_u64 && x == 12_u64;
+    return ok;
+}
+
+static_assert(test_constexpr_operators(), "constexpr operators");
+#endif
+
 void test_operators() {
     using namespace ::rusty::numeric_types;
     using namespace ::rusty::numeric_types::literal;
@@ -130,21 +818,53 @@ void test_operators() {
     dbg(u64_5 |= 3);
     dbg(u64_5 <<= 3);
     dbg(u64_5 >>= 3);
+    dbg(u64_5--);
+    dbg(u64_5);
+    dbg(--u64_5);
+    dbg((u64_5 += 4) *= 2);
+    dbg(&(u64_5 <<= 1) == &u64_5, << ::std::boolalpha);
+    dbg(&++u64_5 == &u64_5, << ::std::boolalpha);
+    // the mutating operators never throw, and all but postfix yield @x
+    auto x = 6_u64;
+    static_assert(noexcept(x += x) && noexcept(x -= x) && noexcept(x *= x) &&
+                      noexcept(x /= x) && noexcept(x %= x) &&
+                      noexcept(x &= x) && noexcept(x |= x) &&
+                      noexcept(x ^= x) && noexcept(x <<= x) &&
+                      noexcept(x >>= x),
+                  "compound assignment is noexcept");
+    static_assert(noexcept(++x) && noexcept(--x) && noexcept(x++) &&
+                      noexcept(x--),
+                  "increment and decrement are noexcept");
+    auto same = &(x += 2) == &x && x == 8_u64;
+    same = same && &(x -= 1) == &x && x == 7_u64;
+    same = same && &(x *= 3) == &x && x == 21_u64;
+    same = same && &(x /= 2) == &x && x == 10_u64;
+    same = same && &(x %= 6) == &x && x == 4_u64;
+    same = same && &(x &= 6) == &x && x == 4_u64;
+    same = same && &(x |= 1) == &x && x == 5_u64;
+    same = same && &(x ^= 3) == &x && x == 6_u64;
+    same = same && &(x <<= 2) == &x && x == 24_u64;
+    same = same && &(x >>= 1) == &x && x == 12_u64;
+    same = same && &++x == &x && x == 13_u64;
+    same = same && &--x == &x && x == 12_u64;
+    same = same && x++ == 12_u64 && x == 13_u64;
+    same = same && x-- == 13_u64 && x == 12_u64;
+    dbg(same, << ::std::boolalpha);
     dbg(1_u64 + 2_u64 * 3_u64 - 4_u64 / 2_u64);
     dbg(100_u64 / 7_u64);
     dbg(100_u64 % 7_u64);
     dbg(f64(100_u64) / 7.0_f64);
     dbg(0.7_f64 * 142.857_f64);
     dbg(0.7_f64 * 142.8571_f64);
-    dbg(0xaa5555aa_i32 ^ 0x01010101, << ::std::showbase << std::hex);
-    dbg(0xaa5555aa_i32 & 0x01010101, << ::std::showbase << std::hex);
-    dbg(0xaa5555aa_i32 | 0x01010101, << ::std::showbase << std::hex);
+    dbg(0xaa5555aa_u32 ^ 0x01010101, << ::std::showbase << std::hex);
+    dbg(0xaa5555aa_u32 & 0x01010101, << ::std::showbase << std::hex);
+    dbg(0xaa5555aa_u32 | 0x01010101, << ::std::showbase << std::hex);
     dbg(0x123_u64 << 2, << ::std::showbase << std::hex);
     dbg(0x123_u64 >> 2, << ::std::showbase << std::hex);
     dbg(0x123_u64 && 0, << ::std::showbase << std::hex);
     dbg(0x123_u64 || 0, << ::std::showbase << std::hex);
-    dbg(-0x80000000_i32 == +0x80000000_i32, << ::std::boolalpha);
-    dbg(-0x80000000_i32 != +0x80000000_i32, << ::std::boolalpha);
+    dbg(-0x80000000_i32 == (0x80000000_u32).as<i32>(), << ::std::boolalpha);
+    dbg(-0x80000000_i32 != (0x80000000_u32).as<i32>(), << ::std::boolalpha);
     dbg(f64(0.1_f32) > 0.1_f64, << ::std::boolalpha);
     dbg(f64(0.1_f32) >= 0.1_f64, << ::std::boolalpha);
     dbg(f64(0.1_f32) < 0.1_f64, << ::std::boolalpha);
@@ -156,6 +876,26 @@ int main() {
     // test_numeric_type_length();
     test_integer_literals();
     test_floating_literals();
+    test_reverse_bytes();
+    test_slice_conversion();
+    test_endian_slice();
+    test_byte_io();
+    test_serialization();
+    test_formatting();
+    test_parsing();
+    test_i128();
+    test_overflow();
+    test_conversions();
+    test_bits();
+    test_parallel();
+    test_iter();
     test_collections();
+    test_flat_hash_map();
+    test_hashers();
+    test_small_vec();
+    test_arena();
+    test_dbg();
+    test_dbg_threads();
+    test_metrics();
     test_operators();
 }
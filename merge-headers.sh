@@ -15,7 +15,7 @@ do_merge_headers() {
     echo "#define __RUSTY_HPP__" >> "$MERGED_HEADER"
 
     for i in $(grep "#include" "$SRC_DIR/rusty.hpp" | sed "s/#include \"\(.*\)\"/\1/g"); do
-        sed "/__RUSTY_.*_HPP__/d;/License-Identifier/d;/Copyright/d" "$SRC_DIR/$i" >> "$MERGED_HEADER"
+        sed "/__RUSTY_.*_HPP__/d;/#include \"/d;/License-Identifier/d;/Copyright/d" "$SRC_DIR/$i" >> "$MERGED_HEADER"
     done
 
     sed "/__RUSTY_HPP__/d;/#include/d;/License-Identifier/d;/Copyright/d" "$SRC_DIR/rusty.hpp" >> "$MERGED_HEADER"
@@ -4,75 +4,34 @@
 #ifndef __RUSTY_HPP__
 #define __RUSTY_HPP__
 
-#include <ostream>
-#include <unordered_map>
-#include <vector>
-
-namespace rusty::collections {
-
-template <typename T1, typename T2> using Pair = ::std::pair<T1, T2>;
-template <typename T, ::std::size_t N> using Array = ::std::array<T, N>;
-template <typename T> using Vec = ::std::vector<T>;
-template <typename K, typename V> using HashMap = ::std::unordered_map<K, V>;
-
-namespace ostream {
-
-inline ::std::string prepare(const ::std::string &s) { return "\"" + s + "\""; }
-inline ::std::int32_t prepare(const ::std::int8_t &t) { return t; }
-inline ::std::int32_t prepare(const ::std::uint8_t &t) { return t; }
-template <typename T> inline const T &prepare(const T &t) { return t; }
-
-template <typename T1, typename T2>
-::std::ostream &operator<<(::std::ostream &s, const Pair<T1, T2> &p) {
-    return s << "(" << prepare(p.first) << ", " << prepare(p.second) << ")";
-}
-
-#define OSTREAM_IMPL(T1, T2)                                                   \
-    template <T1>::std::ostream &operator<<(::std::ostream &s, const T2 &c) {  \
-        auto count = c.size();                                                 \
-        s << "[";                                                              \
-        for (const auto &i : c) {                                              \
-            s << prepare(i);                                                   \
-            if (--count > 0) {                                                 \
-                s << ", ";                                                     \
-            }                                                                  \
-        }                                                                      \
-        return s << "]";                                                       \
-    }
-
-#define COMMA ,
-
-OSTREAM_IMPL(typename T COMMA ::std::size_t size, Array<T COMMA size>)
-OSTREAM_IMPL(typename T, Vec<T>)
-OSTREAM_IMPL(typename K COMMA typename V, HashMap<K COMMA V>)
-
-#undef COMMA
-#undef OSTREAM_IMPL
-
-} // namespace ostream
-
-} // namespace rusty::collections
-
-// use a temporary variable in case that @x contains side effect
-#define dbg(x, ...)                                                            \
-    [&] {                                                                      \
-        auto t = (x);                                                          \
-        auto flag = ::std::cerr.flags();                                       \
-        auto precision = ::std::cerr.precision();                              \
-        ::std::cerr << "[" __FILE__ ":" << __LINE__                            \
-                    << "] " #x " = " __VA_ARGS__ << t << ::std::endl;          \
-        ::std::cerr.flags(flag);                                               \
-        ::std::cerr.precision(precision);                                      \
-        return t;                                                              \
-    }()
-
-#define assert_eq(left, right) assert((left) == (right))
-#define assert_ne(left, right) assert(!((left) == (right)))
-
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <istream>
+#include <iterator>
 #include <limits>
+#include <locale>
 #include <ostream>
+#include <stdexcept>
+
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+#if __cplusplus >= 202002L
+#include <bit>
+#endif
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace rusty::numeric_types {
 
@@ -90,173 +49,5890 @@ constexpr bool is_trivial_v = ::std::is_trivial<T>::value;
 using ::std::is_trivial_v;
 #endif
 
-// bit casting from https://en.cppreference.com/w/cpp/numeric/bit_cast
+// constexpr for functions mutating state, which C++11 does not allow
+#if __cplusplus >= 201402L
+#define RUSTY_CONSTEXPR14 constexpr
+#else
+#define RUSTY_CONSTEXPR14
+#endif
+
+#ifdef __has_builtin
+#if __has_builtin(__builtin_bit_cast)
+#define RUSTY_HAS_BUILTIN_BIT_CAST
+#endif
+#endif
+
+// bit casting from https://en.cppreference.com/w/cpp/numeric/bit_cast,
+// constexpr capable when the compiler provides __builtin_bit_cast
 template <class T1, class T2>
 constexpr enable_if_t<
     sizeof(T1) == sizeof(T2) && is_trivial_v<T2> && is_trivial_v<T1>, T1>
 bit_cast(const T2 &from) noexcept {
+#ifdef RUSTY_HAS_BUILTIN_BIT_CAST
+    return __builtin_bit_cast(T1, from);
+#else
     T1 to;
     ::std::memcpy(&to, &from, sizeof(T1));
     return to;
+#endif
 }
 
-template <typename T> struct Number {
-    template <::std::size_t N>
-    using Bytes = ::std::array<Number<::std::uint8_t>, N>;
-    using Self = Number<T>;
-    T value;
+// i128/u128 map to __int128 when the compiler provides it, otherwise (or
+// with RUSTY_NO_INT128 defined) to a portable two limb implementation
+#if defined(__SIZEOF_INT128__) && !defined(RUSTY_NO_INT128)
+#define RUSTY_HAS_INT128
+#endif
 
-    // NOLINTNEXTLINE(google-explicit-constructor)
-    inline constexpr operator T() const & { return this->value; }
-    // NOLINTNEXTLINE(google-explicit-constructor)
-    inline constexpr Number<T>(const T &value) : value(value){};
-    inline constexpr Number<T>() = default;
-    inline constexpr Number<T>(const Self &) = default;
+namespace detail {
 
-    // compile time endian detection from
-    // https://en.cppreference.com/w/cpp/types/endian
-#ifdef _WIN32
-    static constexpr bool is_le = true;  // NOLINT
-    static constexpr bool is_be = false; // NOLINT
+#ifndef RUSTY_HAS_INT128
+// high 64 bits of the full 64x64 product, from 32-bit partial products
+constexpr ::std::uint64_t mul_hi64(::std::uint64_t a,
+                                   ::std::uint64_t b) noexcept {
+    return (a >> 32) * (b >> 32) + (((a & 0xffffffff) * (b >> 32)) >> 32) +
+           (((a >> 32) * (b & 0xffffffff)) >> 32) +
+           (((((a & 0xffffffff) * (b & 0xffffffff)) >> 32) +
+             (((a & 0xffffffff) * (b >> 32)) & 0xffffffff) +
+             (((a >> 32) * (b & 0xffffffff)) & 0xffffffff)) >>
+            32);
+}
+
+template <typename I> constexpr bool is_negative(I value) noexcept {
+    return ::std::is_signed<I>::value && value < I(0);
+}
+
+// quotient of @hi:@lo by @d, which needs @hi < @d so that it fits in 64 bits:
+// two steps of Knuth's algorithm D over 32-bit digits, @d normalized first
+inline ::std::uint64_t div128_64(::std::uint64_t hi, ::std::uint64_t lo,
+                                 ::std::uint64_t d,
+                                 ::std::uint64_t &rem) noexcept {
+    constexpr auto base = ::std::uint64_t{1} << 32;
+    auto shift = 0U;
+    for (auto bits = 32U; bits != 0; bits /= 2) {
+        if ((d << shift) >> (64 - bits) == 0) {
+            shift += bits;
+        }
+    }
+    d <<= shift;
+    const auto d1 = d >> 32;
+    const auto d0 = d & 0xffffffff;
+    const auto top = shift == 0 ? hi : hi << shift | lo >> (64 - shift);
+    lo <<= shift;
+    // one quotient digit of @u (three digits, the last being @next) by @d,
+    // the estimate from the top digits is at most two too large
+    const auto digit = [&](::std::uint64_t u,
+                           ::std::uint64_t next) -> ::std::uint64_t {
+        auto q = u / d1;
+        auto r = u - q * d1;
+        while (q >= base || q * d0 > (r << 32 | next)) {
+            --q;
+            r += d1;
+            if (r >= base) {
+                break;
+            }
+        }
+        return q;
+    };
+    const auto q1 = digit(top, lo >> 32);
+    const auto mid = (top << 32 | lo >> 32) - q1 * d;
+    const auto q0 = digit(mid, lo & 0xffffffff);
+    rem = ((mid << 32 | (lo & 0xffffffff)) - q0 * d) >> shift;
+    return q1 << 32 | q0;
+}
+
+// two's complement 128-bit integer laid out like a native one
+template <bool Signed> class TwoLimb {
+  public:
+#if defined(_WIN32) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    ::std::uint64_t lo, hi;
+#define TWO_LIMB_INIT(h, l) lo(l), hi(h)
 #else
-    static constexpr bool is_le = // NOLINT
-        __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
-    static constexpr bool is_be = // NOLINT
-        __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__;
+    ::std::uint64_t hi, lo;
+#define TWO_LIMB_INIT(h, l) hi(h), lo(l)
 #endif
-    static_assert(is_le || is_be, "Neither little-endian or big-endian!");
 
-    static constexpr Self from_ne_bytes(const Bytes<sizeof(T)> &bytes) {
-        return bit_cast<Self>(bytes);
+    TwoLimb() = default;
+    constexpr TwoLimb(::std::uint64_t h, ::std::uint64_t l, int /*tag*/)
+        : TWO_LIMB_INIT(h, l) {}
+    template <typename I,
+              enable_if_t<::std::is_integral<I>::value, int> = 0>
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    constexpr TwoLimb(I value) noexcept
+        : TWO_LIMB_INIT(is_negative(value) ? ~0ULL : 0ULL,
+                        static_cast<::std::uint64_t>(value)) {}
+    constexpr explicit TwoLimb(const TwoLimb<!Signed> &other) noexcept
+        : TWO_LIMB_INIT(other.hi, other.lo) {}
+    template <typename F,
+              enable_if_t<::std::is_floating_point<F>::value, int> = 0>
+    explicit TwoLimb(F value) noexcept : TwoLimb(0) {
+        const auto negative = value < 0;
+        value = negative ? -value : value;
+        hi = static_cast<::std::uint64_t>(value / 18446744073709551616.0);
+        lo = static_cast<::std::uint64_t>(
+            value - static_cast<F>(hi) * 18446744073709551616.0);
+        *this = negative ? -*this : *this;
     }
 
-    constexpr Bytes<sizeof(T)> to_ne_bytes() const & {
-        return bit_cast<Bytes<sizeof(T)>>(value);
+#undef TWO_LIMB_INIT
+
+    template <typename I, enable_if_t<::std::is_integral<I>::value, int> = 0>
+    constexpr explicit operator I() const noexcept {
+        return static_cast<I>(lo);
     }
+    template <typename F,
+              enable_if_t<::std::is_floating_point<F>::value, int> = 0>
+    explicit operator F() const noexcept {
+        return is_negative_value()
+                   ? -static_cast<F>(TwoLimb<false>(-*this))
+                   : static_cast<F>(hi) * static_cast<F>(18446744073709551616.0) +
+                         static_cast<F>(lo);
+    }
+    constexpr explicit operator bool() const noexcept { return hi || lo; }
 
-    // Based on https://en.cppreference.com/w/cpp/container/array/rbegin
-    template <::std::size_t N>
-    static constexpr Bytes<N> reverse_bytes(Bytes<N> bytes) noexcept {
-        Bytes<N> reversed_bytes;
-        ::std::copy(bytes.crbegin(), bytes.crend(), reversed_bytes.begin());
-        return reversed_bytes;
+    constexpr bool is_negative_value() const noexcept {
+        return Signed && (hi >> 63) != 0;
     }
 
-    constexpr Self reverse_bytes() const & {
-        return from_ne_bytes(reverse_bytes(to_ne_bytes()));
+    friend constexpr TwoLimb operator+(const TwoLimb &a) noexcept { return a; }
+    friend constexpr TwoLimb operator-(const TwoLimb &a) noexcept {
+        return TwoLimb(0) - a;
+    }
+    friend constexpr TwoLimb operator~(const TwoLimb &a) noexcept {
+        return TwoLimb(~a.hi, ~a.lo, 0);
     }
 
-#define BYTE_CONVERT_IMPL(e)                                                   \
-    static constexpr Self from_##e##_bytes(const Bytes<sizeof(T)> &bytes) {    \
-        return from_ne_bytes(is_##e ? bytes : reverse_bytes(bytes));           \
-    }                                                                          \
-    static constexpr Self from_##e(const Self &source) {                       \
-        return is_##e ? source : source.reverse_bytes();                       \
-    }                                                                          \
-    constexpr Bytes<sizeof(T)> to_##e##_bytes() const & {                      \
-        return is_##e ? to_ne_bytes() : reverse_bytes(to_ne_bytes());          \
-    }                                                                          \
-    constexpr Self to_##e() const & {                                          \
-        return is_##e ? Self{value} : reverse_bytes();                         \
+    friend constexpr TwoLimb operator+(const TwoLimb &a,
+                                       const TwoLimb &b) noexcept {
+        return TwoLimb(a.hi + b.hi + (a.lo + b.lo < a.lo ? 1 : 0),
+                       a.lo + b.lo, 0);
+    }
+    friend constexpr TwoLimb operator-(const TwoLimb &a,
+                                       const TwoLimb &b) noexcept {
+        return TwoLimb(a.hi - b.hi - (a.lo < b.lo ? 1 : 0), a.lo - b.lo, 0);
+    }
+    friend constexpr TwoLimb operator*(const TwoLimb &a,
+                                       const TwoLimb &b) noexcept {
+        return TwoLimb(mul_hi64(a.lo, b.lo) + a.lo * b.hi + a.hi * b.lo,
+                       a.lo * b.lo, 0);
+    }
+    friend TwoLimb operator/(const TwoLimb &a, const TwoLimb &b) noexcept {
+        TwoLimb remainder;
+        return divmod(a, b, remainder);
+    }
+    friend TwoLimb operator%(const TwoLimb &a, const TwoLimb &b) noexcept {
+        TwoLimb remainder;
+        divmod(a, b, remainder);
+        return remainder;
     }
 
-    BYTE_CONVERT_IMPL(le)
-    BYTE_CONVERT_IMPL(be)
+#define BITWISE_IMPL(op)                                                       \
+    friend constexpr TwoLimb operator op(const TwoLimb &a,                     \
+                                         const TwoLimb &b) noexcept {          \
+        return TwoLimb(a.hi op b.hi, a.lo op b.lo, 0);                         \
+    }
 
-#undef BYTE_CONVERT_IMPL
+    BITWISE_IMPL(&)
+    BITWISE_IMPL(|)
+    BITWISE_IMPL(^)
 
-#define INC_DEC_IMPL(op, pos, pre, post)                                       \
-    inline Self operator op(pos) & { return Self{pre value post}; }
+#undef BITWISE_IMPL
 
-    INC_DEC_IMPL(++, , ++, )
-    INC_DEC_IMPL(--, , --, )
-    INC_DEC_IMPL(++, int, , ++) // NOLINT(cert-dcl21-cpp)
-    INC_DEC_IMPL(--, int, , ++) // NOLINT(cert-dcl21-cpp)
+    friend constexpr TwoLimb operator<<(const TwoLimb &a, unsigned n) noexcept {
+        return n == 0    ? a
+               : n < 64  ? TwoLimb(a.hi << n | a.lo >> (64 - n), a.lo << n, 0)
+               : n < 128 ? TwoLimb(a.lo << (n - 64), 0, 0)
+                         : TwoLimb(0);
+    }
+    // arithmetic for signed, logical for unsigned
+    friend constexpr TwoLimb operator>>(const TwoLimb &a, unsigned n) noexcept {
+        return n == 0 ? a
+               : n < 64
+                   ? TwoLimb(a.shifted_hi(n), a.lo >> n | a.hi << (64 - n), 0)
+               : n < 128 ? TwoLimb(a.fill(), a.shifted_hi(n - 64), 0)
+                         : TwoLimb(a.fill(), a.fill(), 0);
+    }
+    friend constexpr TwoLimb operator<<(const TwoLimb &a,
+                                        const TwoLimb &n) noexcept {
+        return a << static_cast<unsigned>(n.lo);
+    }
+    friend constexpr TwoLimb operator>>(const TwoLimb &a,
+                                        const TwoLimb &n) noexcept {
+        return a >> static_cast<unsigned>(n.lo);
+    }
 
-#undef INC_DEC_IMPL
+    friend constexpr bool operator==(const TwoLimb &a,
+                                     const TwoLimb &b) noexcept {
+        return a.hi == b.hi && a.lo == b.lo;
+    }
+    friend constexpr bool operator!=(const TwoLimb &a,
+                                     const TwoLimb &b) noexcept {
+        return !(a == b);
+    }
+    friend constexpr bool operator<(const TwoLimb &a,
+                                    const TwoLimb &b) noexcept {
+        return a.hi != b.hi ? (Signed ? static_cast<::std::int64_t>(a.hi) <
+                                            static_cast<::std::int64_t>(b.hi)
+                                      : a.hi < b.hi)
+                            : a.lo < b.lo;
+    }
+    friend constexpr bool operator>(const TwoLimb &a,
+                                    const TwoLimb &b) noexcept {
+        return b < a;
+    }
+    friend constexpr bool operator<=(const TwoLimb &a,
+                                     const TwoLimb &b) noexcept {
+        return !(b < a);
+    }
+    friend constexpr bool operator>=(const TwoLimb &a,
+                                     const TwoLimb &b) noexcept {
+        return !(a < b);
+    }
 
-#define BINARY_ASSIGN_IMPL(op)                                                 \
-    inline Self operator op##=(const Self &oprand) & {                         \
-        return Self{value op## = oprand.value};                                \
+#define ASSIGN_IMPL(op)                                                        \
+    RUSTY_CONSTEXPR14 TwoLimb &operator op##=(const TwoLimb &other) noexcept { \
+        return *this = *this op other;                                         \
     }
 
-    BINARY_ASSIGN_IMPL(+)
-    BINARY_ASSIGN_IMPL(-)
-    BINARY_ASSIGN_IMPL(*)
-    BINARY_ASSIGN_IMPL(/)
-    BINARY_ASSIGN_IMPL(%)
-    BINARY_ASSIGN_IMPL(&)
-    BINARY_ASSIGN_IMPL(|)
-    BINARY_ASSIGN_IMPL(^)
-    BINARY_ASSIGN_IMPL(<<)
-    BINARY_ASSIGN_IMPL(>>)
+    ASSIGN_IMPL(+)
+    ASSIGN_IMPL(-)
+    ASSIGN_IMPL(*)
+    ASSIGN_IMPL(/)
+    ASSIGN_IMPL(%)
+    ASSIGN_IMPL(&)
+    ASSIGN_IMPL(|)
+    ASSIGN_IMPL(^)
+    ASSIGN_IMPL(<<)
+    ASSIGN_IMPL(>>)
 
-#undef BINARY_ASSIGN_IMPL
+#undef ASSIGN_IMPL
 
-    friend ::std::ostream &operator<<(::std::ostream &s, const Self &number) {
-        return s << +number.value;
+    RUSTY_CONSTEXPR14 TwoLimb &operator++() noexcept { return *this += 1; }
+    RUSTY_CONSTEXPR14 TwoLimb &operator--() noexcept { return *this -= 1; }
+    RUSTY_CONSTEXPR14 TwoLimb
+    operator++(int) noexcept { // NOLINT(cert-dcl21-cpp)
+        const auto old = *this;
+        ++*this;
+        return old;
+    }
+    RUSTY_CONSTEXPR14 TwoLimb
+    operator--(int) noexcept { // NOLINT(cert-dcl21-cpp)
+        const auto old = *this;
+        --*this;
+        return old;
     }
 
-    friend ::std::istream &operator>>(::std::istream &s, Self &number) {
-        return s >> number.value;
+  private:
+    constexpr ::std::uint64_t fill() const noexcept {
+        return is_negative_value() ? ~0ULL : 0ULL;
+    }
+    constexpr ::std::uint64_t shifted_hi(unsigned n) const noexcept {
+        return Signed ? static_cast<::std::uint64_t>(
+                            static_cast<::std::int64_t>(hi) >> n)
+                      : hi >> n;
     }
-};
 
-// TODO(i128/u128)
+    // truncating division of magnitudes, signs fixed up afterwards
+    static TwoLimb divmod(const TwoLimb &a, const TwoLimb &b,
+                          TwoLimb &remainder) noexcept {
+        const auto negative_a = a.is_negative_value();
+        const auto negative_b = b.is_negative_value();
+        const auto n = TwoLimb<false>(negative_a ? -a : a);
+        const auto d = TwoLimb<false>(negative_b ? -b : b);
+        TwoLimb<false> r;
+        const auto q = TwoLimb<false>::divmod_unsigned(n, d, r);
+        remainder = negative_a ? -TwoLimb(r) : TwoLimb(r);
+        return negative_a != negative_b ? -TwoLimb(q) : TwoLimb(q);
+    }
 
-#define GENERAL_INT_IMPL(ALIAS, ORIGIN)                                        \
-    using ALIAS = Number<ORIGIN>;                                              \
-    namespace literal {                                                        \
-    inline constexpr ALIAS operator""_##ALIAS(unsigned long long int val) {    \
-        return static_cast<ALIAS>(val);                                        \
-    }                                                                          \
-    } // namespace literal
+    static TwoLimb divmod_unsigned(const TwoLimb &n, const TwoLimb &d,
+                                   TwoLimb &r) noexcept {
+        if (n.hi == 0 && d.hi == 0) {
+            r = TwoLimb(n.lo % d.lo);
+            return TwoLimb(n.lo / d.lo);
+        }
+        if (d.hi == 0 && d.lo <= 0xffffffff) {
+            // schoolbook over 32-bit limbs, one hardware division each
+            const ::std::uint64_t limbs[] = {n.hi >> 32, n.hi & 0xffffffff,
+                                             n.lo >> 32, n.lo & 0xffffffff};
+            ::std::uint64_t q[4] = {}; // NOLINT(modernize-avoid-c-arrays)
+            ::std::uint64_t rem = 0;
+            for (auto i = 0; i < 4; ++i) {
+                const auto cur = rem << 32 | limbs[i];
+                q[i] = cur / d.lo;
+                rem = cur % d.lo;
+            }
+            r = TwoLimb(rem);
+            return TwoLimb(q[0] << 32 | q[1], q[2] << 32 | q[3], 0);
+        }
+        if (d.hi == 0) {
+            // the high limb alone, then the remainder with the low limb
+            ::std::uint64_t rem = 0;
+            const auto lo = div128_64(n.hi % d.lo, n.lo, d.lo, rem);
+            r = TwoLimb(rem);
+            return TwoLimb(n.hi / d.lo, lo, 0);
+        }
+        // shift-subtract, a divisor of 2^64 or more leaves a 64-bit quotient
+        TwoLimb q(0);
+        r = TwoLimb(0);
+        for (auto i = 127; i >= 0; --i) {
+            r = r << 1U | ((n >> static_cast<unsigned>(i)) & TwoLimb(1));
+            if (r >= d) {
+                r -= d;
+                q = q | (TwoLimb(1) << static_cast<unsigned>(i));
+            }
+        }
+        return q;
+    }
 
-#define FIXED_INT_IMPL(BITS)                                                   \
-    GENERAL_INT_IMPL(i##BITS, int##BITS##_t)                                   \
-    GENERAL_INT_IMPL(u##BITS, uint##BITS##_t)
+    friend class TwoLimb<!Signed>;
+};
+#endif
 
-#define FLOATING_IMPL(BITS, ORIGIN)                                            \
-    using f##BITS = Number<ORIGIN>;                                            \
-    static_assert(::std::numeric_limits<ORIGIN>::is_iec559 &&                  \
-                      sizeof(ORIGIN) == (BITS) / 8,                            \
-                  "f" #BITS " illegal!");                                      \
-    namespace literal {                                                        \
-    inline constexpr f##BITS operator""_f##BITS(long double val) {             \
-        return static_cast<f##BITS>(val);                                      \
-    }                                                                          \
-    } // namespace literal
+} // namespace detail
 
-FIXED_INT_IMPL(8)
-FIXED_INT_IMPL(16)
-FIXED_INT_IMPL(32)
-FIXED_INT_IMPL(64)
+#ifdef RUSTY_HAS_INT128
+__extension__ using int128 = __int128;          // NOLINT
+__extension__ using uint128 = unsigned __int128; // NOLINT
+#else
+using int128 = detail::TwoLimb<true>;
+using uint128 = detail::TwoLimb<false>;
+#endif
 
-GENERAL_INT_IMPL(isize, intptr_t)
-GENERAL_INT_IMPL(usize, uintptr_t)
+namespace detail {
 
-FLOATING_IMPL(32, float)
-FLOATING_IMPL(64, double)
+// std traits extended to the 128-bit integers, which are not integral
+// under strict -std=c++XX modes
+template <typename T> struct IsInteger : ::std::is_integral<T> {};
+template <> struct IsInteger<int128> : ::std::true_type {};
+template <> struct IsInteger<uint128> : ::std::true_type {};
 
-#undef FIXED_INT_IMPL
-#undef FLOATING_IMPL
-#undef GENERAL_INT_IMPL
+template <typename T> struct IsSigned : ::std::is_signed<T> {};
+template <> struct IsSigned<int128> : ::std::true_type {};
+template <> struct IsSigned<uint128> : ::std::false_type {};
 
-} // namespace rusty::numeric_types
+template <typename T, typename = void> struct MakeUnsigned {
+    using Type = T;
+};
+template <typename T>
+struct MakeUnsigned<T, enable_if_t<::std::is_integral<T>::value>> {
+    using Type = typename ::std::make_unsigned<T>::type;
+};
+template <> struct MakeUnsigned<int128> { using Type = uint128; };
+template <> struct MakeUnsigned<uint128> { using Type = uint128; };
 
-template <typename T> struct std::hash<::rusty::numeric_types::Number<T>> {
-    ::std::size_t constexpr operator()(
-        const ::rusty::numeric_types::Number<T> &number) const &noexcept {
-        return ::std::hash<T>{}(number.value);
+template <typename T> struct Limits {
+    static constexpr T max() noexcept { return ::std::numeric_limits<T>::max(); }
+    static constexpr T min() noexcept { return ::std::numeric_limits<T>::min(); }
+};
+template <> struct Limits<uint128> {
+    static constexpr uint128 max() noexcept { return ~uint128(0); }
+    static constexpr uint128 min() noexcept { return uint128(0); }
+};
+template <> struct Limits<int128> {
+    static constexpr int128 max() noexcept {
+        return int128(Limits<uint128>::max() >> 1U);
     }
+    static constexpr int128 min() noexcept { return -max() - int128(1); }
 };
 
+} // namespace detail
+
+namespace detail {
+
+template <::std::size_t N> struct UintOf;
+template <> struct UintOf<1> { using Type = ::std::uint8_t; };
+template <> struct UintOf<2> { using Type = ::std::uint16_t; };
+template <> struct UintOf<4> { using Type = ::std::uint32_t; };
+template <> struct UintOf<8> { using Type = ::std::uint64_t; };
+template <> struct UintOf<16> { using Type = uint128; };
+
+// single bswap instruction, usable in constant expressions
+#if defined(__cpp_lib_byteswap)
+template <typename T> constexpr T byteswap(T value) noexcept {
+    return ::std::byteswap(value);
+}
+#elif defined(__GNUC__) || defined(__clang__)
+constexpr ::std::uint8_t byteswap(::std::uint8_t value) noexcept {
+    return value;
+}
+constexpr ::std::uint16_t byteswap(::std::uint16_t value) noexcept {
+    return __builtin_bswap16(value);
+}
+constexpr ::std::uint32_t byteswap(::std::uint32_t value) noexcept {
+    return __builtin_bswap32(value);
+}
+constexpr ::std::uint64_t byteswap(::std::uint64_t value) noexcept {
+    return __builtin_bswap64(value);
+}
+#else
+// shift patterns recognized by compilers as bswap
+constexpr ::std::uint8_t byteswap(::std::uint8_t value) noexcept {
+    return value;
+}
+constexpr ::std::uint16_t byteswap(::std::uint16_t value) noexcept {
+    return static_cast<::std::uint16_t>((value << 8) | (value >> 8));
+}
+constexpr ::std::uint32_t byteswap(::std::uint32_t value) noexcept {
+    return ((value & 0x000000ffU) << 24) | ((value & 0x0000ff00U) << 8) |
+           ((value & 0x00ff0000U) >> 8) | ((value & 0xff000000U) >> 24);
+}
+constexpr ::std::uint64_t byteswap(::std::uint64_t value) noexcept {
+    return (static_cast<::std::uint64_t>(
+                byteswap(static_cast<::std::uint32_t>(value)))
+            << 32) |
+           byteswap(static_cast<::std::uint32_t>(value >> 32));
+}
+#endif
+constexpr uint128 byteswap(uint128 value) noexcept {
+    return static_cast<uint128>(byteswap(static_cast<::std::uint64_t>(value)))
+               << 64U |
+           static_cast<uint128>(
+               byteswap(static_cast<::std::uint64_t>(value >> 64U)));
+}
+
+// reverse every @W-byte element of @count elements from @src into @dst,
+// @src and @dst may alias exactly (in-place swapping)
+template <::std::size_t W>
+inline void swap_bytes_block(const ::std::uint8_t *src, ::std::uint8_t *dst,
+                             ::std::size_t count) noexcept {
+    static_assert(W == 1 || W == 2 || W == 4 || W == 8 || W == 16,
+                  "unsupported width!");
+    ::std::size_t i = 0;
+    if (W == 1) {
+        if (src != dst) {
+            ::std::memmove(dst, src, count);
+        }
+        return;
+    }
+#if defined(__SSSE3__) || defined(__AVX2__)
+    // pshufb mask mapping byte j to (j / W) * W + (W - 1 - j % W)
+    const __m128i mask =
+        W == 2   ? _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12,
+                                 15, 14)
+        : W == 4 ? _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14,
+                                 13, 12)
+        : W == 8 ? _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11,
+                                 10, 9, 8)
+                 : _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3,
+                                 2, 1, 0);
+#if defined(__AVX2__)
+    // vpshufb shuffles within 128-bit lanes, so the mask is just duplicated
+    const __m256i mask256 = _mm256_broadcastsi128_si256(mask);
+    for (; i + 32 / W <= count; i += 32 / W) {
+        const auto v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(src + i * W)); // NOLINT
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * W), // NOLINT
+                            _mm256_shuffle_epi8(v, mask256));
+    }
+#endif
+    for (; i + 16 / W <= count; i += 16 / W) {
+        const auto v = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src + i * W)); // NOLINT
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * W), // NOLINT
+                         _mm_shuffle_epi8(v, mask));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 / W <= count; i += 16 / W) {
+        const auto v = vld1q_u8(src + i * W);
+        vst1q_u8(dst + i * W,
+                 W == 2   ? vrev16q_u8(v)
+                 : W == 4 ? vrev32q_u8(v)
+                 : W == 8 ? vrev64q_u8(v)
+                          : vextq_u8(vrev64q_u8(v), vrev64q_u8(v), 8));
+    }
+#endif
+    // scalar tail (or whole range without simd)
+    for (; i < count; ++i) {
+        typename UintOf<W>::Type tmp;
+        ::std::memcpy(&tmp, src + i * W, W);
+        tmp = byteswap(tmp);
+        ::std::memcpy(dst + i * W, &tmp, W);
+    }
+}
+
+// bit counts of 64-bit words in single popcnt/lzcnt/tzcnt (or bsr/bsf)
+// instructions, usable in constant expressions; zero counts 64 zeros
+#if defined(__cpp_lib_bitops)
+constexpr unsigned popcount64(::std::uint64_t v) noexcept {
+    return static_cast<unsigned>(::std::popcount(v));
+}
+constexpr unsigned clz64(::std::uint64_t v) noexcept {
+    return static_cast<unsigned>(::std::countl_zero(v));
+}
+constexpr unsigned ctz64(::std::uint64_t v) noexcept {
+    return static_cast<unsigned>(::std::countr_zero(v));
+}
+#elif defined(__GNUC__) || defined(__clang__)
+constexpr unsigned popcount64(::std::uint64_t v) noexcept {
+    return static_cast<unsigned>(__builtin_popcountll(v));
+}
+constexpr unsigned clz64(::std::uint64_t v) noexcept {
+    return v == 0 ? 64 : static_cast<unsigned>(__builtin_clzll(v));
+}
+constexpr unsigned ctz64(::std::uint64_t v) noexcept {
+    return v == 0 ? 64 : static_cast<unsigned>(__builtin_ctzll(v));
+}
+#else
+// swar patterns recognized by compilers as popcnt
+constexpr ::std::uint64_t popcount_pairs(::std::uint64_t v) noexcept {
+    return v - ((v >> 1) & 0x5555555555555555ULL);
+}
+constexpr ::std::uint64_t popcount_nibbles(::std::uint64_t v) noexcept {
+    return (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+}
+constexpr ::std::uint64_t popcount_bytes(::std::uint64_t v) noexcept {
+    return (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+}
+constexpr unsigned popcount64(::std::uint64_t v) noexcept {
+    return static_cast<unsigned>(
+        (popcount_bytes(popcount_nibbles(popcount_pairs(v))) *
+         0x0101010101010101ULL) >>
+        56);
+}
+// every bit below the highest set one set too
+constexpr ::std::uint64_t smear_right(::std::uint64_t v,
+                                      unsigned shift = 1) noexcept {
+    return shift == 64 ? v : smear_right(v | (v >> shift), shift * 2);
+}
+constexpr unsigned clz64(::std::uint64_t v) noexcept {
+    return 64 - popcount64(smear_right(v));
+}
+constexpr unsigned ctz64(::std::uint64_t v) noexcept {
+    return popcount64(~v & (v - 1));
+}
+#endif
+
+constexpr unsigned at_most(unsigned n, unsigned bound) noexcept {
+    return n < bound ? n : bound;
+}
+
+// the same bits as an unsigned integer, the domain of every bit operation
+template <typename I>
+constexpr typename UintOf<sizeof(I)>::Type as_unsigned(const I &v) noexcept {
+    return static_cast<typename UintOf<sizeof(I)>::Type>(v);
+}
+
+template <typename U> constexpr unsigned count_ones(U v) noexcept {
+    return popcount64(v);
+}
+template <typename U> constexpr unsigned leading_zeros(U v) noexcept {
+    return clz64(v) - (64 - 8 * sizeof(U));
+}
+template <typename U> constexpr unsigned trailing_zeros(U v) noexcept {
+    return at_most(ctz64(v), 8 * sizeof(U));
+}
+constexpr unsigned count_ones(uint128 v) noexcept {
+    return popcount64(static_cast<::std::uint64_t>(v)) +
+           popcount64(static_cast<::std::uint64_t>(v >> 64U));
+}
+constexpr unsigned leading_zeros(uint128 v) noexcept {
+    return static_cast<::std::uint64_t>(v >> 64U) == 0
+               ? 64 + clz64(static_cast<::std::uint64_t>(v))
+               : clz64(static_cast<::std::uint64_t>(v >> 64U));
+}
+constexpr unsigned trailing_zeros(uint128 v) noexcept {
+    return static_cast<::std::uint64_t>(v) == 0
+               ? 64 + ctz64(static_cast<::std::uint64_t>(v >> 64U))
+               : ctz64(static_cast<::std::uint64_t>(v));
+}
+
+// shift pattern recognized by compilers as rol
+template <typename U> constexpr U rotate_left(U v, unsigned n) noexcept {
+    return static_cast<U>(v << (n % (8 * sizeof(U))) |
+                          v >> ((8 * sizeof(U) - n % (8 * sizeof(U))) %
+                                (8 * sizeof(U))));
+}
+
+// set bits in @n bytes, in vpopcntq or pshufb nibble lookup lanes when
+// available and a popcnt per 64-bit word otherwise
+inline ::std::uint64_t count_ones_block(const ::std::uint8_t *bytes,
+                                        ::std::size_t n) noexcept {
+    ::std::size_t i = 0;
+    auto total = ::std::uint64_t{0};
+#if defined(__AVX512VPOPCNTDQ__) && defined(__AVX512F__)
+    auto acc512 = _mm512_setzero_si512();
+    for (; i + 64 <= n; i += 64) {
+        acc512 = _mm512_add_epi64(
+            acc512, _mm512_popcnt_epi64(_mm512_loadu_si512(bytes + i)));
+    }
+    total += static_cast<::std::uint64_t>(_mm512_reduce_add_epi64(acc512));
+#elif defined(__AVX2__)
+    // count per nibble with a 16 entry table, summed into 64-bit lanes
+    const auto table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2,
+                                        3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2,
+                                        2, 3, 2, 3, 3, 4);
+    const auto low = _mm256_set1_epi8(0x0f);
+    auto acc256 = _mm256_setzero_si256();
+    for (; i + 32 <= n; i += 32) {
+        const auto v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(bytes + i)); // NOLINT
+        const auto counts = _mm256_add_epi8(
+            _mm256_shuffle_epi8(table, _mm256_and_si256(v, low)),
+            _mm256_shuffle_epi8(
+                table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+        acc256 = _mm256_add_epi64(
+            acc256, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+    total += static_cast<::std::uint64_t>(_mm256_extract_epi64(acc256, 0)) +
+             static_cast<::std::uint64_t>(_mm256_extract_epi64(acc256, 1)) +
+             static_cast<::std::uint64_t>(_mm256_extract_epi64(acc256, 2)) +
+             static_cast<::std::uint64_t>(_mm256_extract_epi64(acc256, 3));
+#elif defined(__ARM_NEON)
+    auto acc = vdupq_n_u64(0);
+    for (; i + 16 <= n; i += 16) {
+        acc = vaddq_u64(acc, vpaddlq_u32(vpaddlq_u16(
+                                 vpaddlq_u8(vcntq_u8(vld1q_u8(bytes + i))))));
+    }
+    total += vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1);
+#endif
+    // scalar tail (or whole range without simd)
+    for (; i + 8 <= n; i += 8) {
+        ::std::uint64_t word;
+        ::std::memcpy(&word, bytes + i, 8);
+        total += popcount64(word);
+    }
+    for (; i < n; ++i) {
+        total += popcount64(bytes[i]);
+    }
+    return total;
+}
+
+// upper bound of characters written by Number<T>::write_to, the longest
+// being the 40 of the minimum i128
+constexpr ::std::size_t MAX_FORMAT_CHARS = 48;
+
+inline const char *digit_pairs() noexcept {
+    static constexpr char TABLE[] = "00010203040506070809"
+                                    "10111213141516171819"
+                                    "20212223242526272829"
+                                    "30313233343536373839"
+                                    "40414243444546474849"
+                                    "50515253545556575859"
+                                    "60616263646566676869"
+                                    "70717273747576777879"
+                                    "80818283848586878889"
+                                    "90919293949596979899";
+    return TABLE;
+}
+
+// two digits per division, written backwards then moved into place
+inline char *write_uint(char *out, ::std::uint64_t value) noexcept {
+    char buffer[20]; // NOLINT(modernize-avoid-c-arrays)
+    auto *p = buffer + sizeof(buffer);
+    while (value >= 100) {
+        p -= 2;
+        ::std::memcpy(p, digit_pairs() + (value % 100) * 2, 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        p -= 2;
+        ::std::memcpy(p, digit_pairs() + value * 2, 2);
+    } else {
+        *--p = static_cast<char>('0' + value);
+    }
+    const auto n = static_cast<::std::size_t>(buffer + sizeof(buffer) - p);
+    ::std::memcpy(out, p, n);
+    return out + n;
+}
+
+// exactly @width digits, zero padded
+inline char *write_uint_padded(char *out, ::std::uint64_t value,
+                               ::std::size_t width) noexcept {
+    char digits[20]; // NOLINT(modernize-avoid-c-arrays)
+    const auto n = static_cast<::std::size_t>(write_uint(digits, value) -
+                                              digits);
+    ::std::memset(out, '0', width - n);
+    ::std::memcpy(out + width - n, digits, n);
+    return out + width;
+}
+
+template <typename T>
+enable_if_t<::std::is_integral<T>::value && sizeof(T) <= 8, char *>
+write_number(char *out, T value) {
+#ifdef __cpp_lib_to_chars
+    return ::std::to_chars(out, out + MAX_FORMAT_CHARS, value).ptr;
+#else
+    auto abs = static_cast<::std::uint64_t>(value);
+    if (value < 0) {
+        *out++ = '-';
+        abs = 0 - abs;
+    }
+    return write_uint(out, abs);
+#endif
+}
+
+// 128-bit division is a slow library call, so peel 19 digits off per
+// division and format the 64-bit pieces with the digit pair table
+template <typename T>
+enable_if_t<IsInteger<T>::value && sizeof(T) == 16, char *>
+write_number(char *out, T value) {
+    using U = typename MakeUnsigned<T>::Type;
+    auto abs = static_cast<U>(value);
+    if (IsSigned<T>::value && value < T(0)) {
+        *out++ = '-';
+        abs = U(0) - abs;
+    }
+    const auto ten19 = U(10000000000000000000ULL);
+    ::std::uint64_t pieces[2]; // NOLINT(modernize-avoid-c-arrays)
+    auto n = 0;
+    while (abs >> 64U) {
+        pieces[n++] = static_cast<::std::uint64_t>(abs % ten19);
+        abs /= ten19;
+    }
+    out = write_uint(out, static_cast<::std::uint64_t>(abs));
+    while (n > 0) {
+        out = write_uint_padded(out, pieces[--n], 19);
+    }
+    return out;
+}
+
+// shortest representation which parses back to the same value
+template <typename T>
+enable_if_t<::std::is_floating_point<T>::value, char *>
+write_number(char *out, T value) {
+#ifdef __cpp_lib_to_chars
+    return ::std::to_chars(out, out + MAX_FORMAT_CHARS, value).ptr;
+#else
+    auto n = 0;
+    for (auto precision = 1;
+         precision <= ::std::numeric_limits<T>::max_digits10; ++precision) {
+        n = ::std::snprintf(out, MAX_FORMAT_CHARS, "%.*g", precision,
+                            static_cast<double>(value));
+        if (static_cast<T>(::std::strtod(out, nullptr)) == value) {
+            break;
+        }
+    }
+    // %g picks exponent form for 100 at precision 1, keep the shorter one
+    const auto *e = ::std::strchr(out, 'e');
+    const auto exp = e ? ::std::atoi(e + 1) : -1;
+    if (exp >= 0 && exp < ::std::numeric_limits<T>::max_digits10) {
+        char fixed[MAX_FORMAT_CHARS]; // NOLINT(modernize-avoid-c-arrays)
+        const auto m = ::std::snprintf(fixed, MAX_FORMAT_CHARS, "%.*g",
+                                       exp + 1, static_cast<double>(value));
+        if (m <= n) {
+            ::std::memcpy(out, fixed, static_cast<::std::size_t>(m));
+            n = m;
+        }
+    }
+    return out + n;
+#endif
+}
+
+} // namespace detail
+
+// Error kinds of Number<T>::from_str, like rust's IntErrorKind and
+// ParseFloatError
+enum class ParseError {
+    None,
+    Empty,
+    InvalidDigit,
+    PosOverflow,
+    NegOverflow,
+    Invalid,
+};
+
+inline const char *to_str(ParseError error) noexcept {
+    switch (error) {
+    case ParseError::None:
+        return "no error";
+    case ParseError::Empty:
+        return "cannot parse number from empty string";
+    case ParseError::InvalidDigit:
+        return "invalid digit found in string";
+    case ParseError::PosOverflow:
+        return "number too large to fit in target type";
+    case ParseError::NegOverflow:
+        return "number too small to fit in target type";
+    case ParseError::Invalid:
+        return "invalid number literal";
+    }
+    return "unknown error";
+}
+
+template <typename N> struct ParseResult {
+    N value{};
+    ParseError error = ParseError::None;
+
+    constexpr bool is_ok() const noexcept { return error == ParseError::None; }
+    constexpr bool is_err() const noexcept { return !is_ok(); }
+    constexpr N unwrap_or(const N &fallback) const noexcept {
+        return is_ok() ? value : fallback;
+    }
+    N unwrap() const {
+        if (is_err()) {
+            throw ::std::invalid_argument(to_str(error));
+        }
+        return value;
+    }
+};
+
+// result of a checked operation, like rust Option of an integer
+template <typename N> struct Checked {
+    N value{};
+    bool overflow = false;
+
+    constexpr Checked() = default;
+    constexpr Checked(const N &value, bool overflow = false) // NOLINT
+        : value(value), overflow(overflow) {}
+
+    constexpr bool is_some() const noexcept { return !overflow; }
+    constexpr bool is_none() const noexcept { return overflow; }
+    constexpr N unwrap_or(const N &fallback) const noexcept {
+        return overflow ? fallback : value;
+    }
+    N unwrap() const {
+        if (overflow) {
+            throw ::std::overflow_error("arithmetic overflow");
+        }
+        return value;
+    }
+};
+
+namespace detail {
+
+#if defined(__GNUC__) || defined(__clang__)
+#define RUSTY_HAS_OVERFLOW_BUILTINS
+#endif
+
+// arithmetic done in an unsigned type wide enough to skip int promotion
+template <typename I>
+using WrappingOf =
+    typename ::std::conditional<(sizeof(I) < sizeof(unsigned)), unsigned,
+                                typename MakeUnsigned<I>::Type>::type;
+
+template <typename I> constexpr bool below_zero(const I &value) noexcept {
+    return IsSigned<I>::value && value < I(0);
+}
+
+// wrapped result in @out, returns whether it overflowed; the builtins
+// compile to the plain instruction and a flag check
+#ifdef RUSTY_HAS_OVERFLOW_BUILTINS
+#define OVERFLOW_BUILTIN_IMPL(op)                                              \
+    template <typename I>                                                      \
+    enable_if_t<!::std::is_class<I>::value, bool> op##_overflow(               \
+        I a, I b, I &out) noexcept {                                           \
+        return __builtin_##op##_overflow(a, b, &out);                          \
+    }
+
+OVERFLOW_BUILTIN_IMPL(add)
+OVERFLOW_BUILTIN_IMPL(sub)
+OVERFLOW_BUILTIN_IMPL(mul)
+
+#undef OVERFLOW_BUILTIN_IMPL
+template <typename I>
+using UseOverflowFallback = enable_if_t<::std::is_class<I>::value, bool>;
+#else
+template <typename I> using UseOverflowFallback = bool;
+#endif
+
+template <typename I>
+UseOverflowFallback<I> add_overflow(I a, I b, I &out) noexcept {
+    using W = WrappingOf<I>;
+    out = static_cast<I>(static_cast<W>(a) + static_cast<W>(b));
+    return IsSigned<I>::value ? below_zero(a) == below_zero(b) &&
+                                    below_zero(out) != below_zero(a)
+                              : out < a;
+}
+template <typename I>
+UseOverflowFallback<I> sub_overflow(I a, I b, I &out) noexcept {
+    using W = WrappingOf<I>;
+    out = static_cast<I>(static_cast<W>(a) - static_cast<W>(b));
+    return IsSigned<I>::value ? below_zero(a) != below_zero(b) &&
+                                    below_zero(out) != below_zero(a)
+                              : a < b;
+}
+template <typename I>
+UseOverflowFallback<I> mul_overflow(I a, I b, I &out) noexcept {
+    using W = WrappingOf<I>;
+    out = static_cast<I>(static_cast<W>(a) * static_cast<W>(b));
+    if (a == I(0)) {
+        return false;
+    }
+    if (IsSigned<I>::value && a == I(-1)) {
+        return b == Limits<I>::min();
+    }
+    return out / a != b;
+}
+
+// division by zero or MIN / -1
+template <typename I> constexpr bool div_overflow(I a, I b) noexcept {
+    return b == I(0) ||
+           (IsSigned<I>::value && a == Limits<I>::min() && b == I(-1));
+}
+
+// the bound an overflowing operation saturates to
+template <typename I> constexpr I saturate(bool below) noexcept {
+    return below ? Limits<I>::min() : Limits<I>::max();
+}
+template <typename I> I saturating_add(I a, I b) noexcept {
+    I out;
+    return add_overflow(a, b, out) ? saturate<I>(below_zero(b)) : out;
+}
+template <typename I> I saturating_sub(I a, I b) noexcept {
+    I out;
+    return sub_overflow(a, b, out)
+               ? saturate<I>(!IsSigned<I>::value || !below_zero(b))
+               : out;
+}
+template <typename I> I saturating_mul(I a, I b) noexcept {
+    I out;
+    return mul_overflow(a, b, out)
+               ? saturate<I>(below_zero(a) != below_zero(b))
+               : out;
+}
+
+// saturating lanes of 8 and 16-bit integers, the tail in scalar code
+#if defined(__AVX2__)
+#define SATURATING_SIMD_IMPL(T, op, epx, neon)                                 \
+    inline void saturating_##op##_block(const T *a, const T *b, T *out,        \
+                                        ::std::size_t count) noexcept {        \
+        const auto lanes = count - count % (32 / sizeof(T));                   \
+        ::std::size_t i = 0;                                                   \
+        for (; i < lanes; i += 32 / sizeof(T)) {                                \
+            const auto x = _mm256_loadu_si256(                                 \
+                reinterpret_cast<const __m256i *>(a + i)); /* NOLINT */        \
+            const auto y = _mm256_loadu_si256(                                 \
+                reinterpret_cast<const __m256i *>(b + i)); /* NOLINT */        \
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),          \
+                                _mm256_##op##s_##epx(x, y)); /* NOLINT */      \
+        }                                                                      \
+        for (; i < count; ++i) {                                               \
+            out[i] = saturating_##op(a[i], b[i]);                              \
+        }                                                                      \
+    }
+#elif defined(__SSE2__)
+#define SATURATING_SIMD_IMPL(T, op, epx, neon)                                 \
+    inline void saturating_##op##_block(const T *a, const T *b, T *out,        \
+                                        ::std::size_t count) noexcept {        \
+        const auto lanes = count - count % (16 / sizeof(T));                   \
+        ::std::size_t i = 0;                                                   \
+        for (; i < lanes; i += 16 / sizeof(T)) {                                \
+            const auto x = _mm_loadu_si128(                                    \
+                reinterpret_cast<const __m128i *>(a + i)); /* NOLINT */        \
+            const auto y = _mm_loadu_si128(                                    \
+                reinterpret_cast<const __m128i *>(b + i)); /* NOLINT */        \
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),             \
+                             _mm_##op##s_##epx(x, y)); /* NOLINT */            \
+        }                                                                      \
+        for (; i < count; ++i) {                                               \
+            out[i] = saturating_##op(a[i], b[i]);                              \
+        }                                                                      \
+    }
+#elif defined(__ARM_NEON)
+#define SATURATING_SIMD_IMPL(T, op, epx, neon)                                 \
+    inline void saturating_##op##_block(const T *a, const T *b, T *out,        \
+                                        ::std::size_t count) noexcept {        \
+        const auto lanes = count - count % (16 / sizeof(T));                   \
+        ::std::size_t i = 0;                                                   \
+        for (; i < lanes; i += 16 / sizeof(T)) {                                \
+            vst1q_##neon(out + i, vq##op##q_##neon(vld1q_##neon(a + i),        \
+                                                   vld1q_##neon(b + i)));      \
+        }                                                                      \
+        for (; i < count; ++i) {                                               \
+            out[i] = saturating_##op(a[i], b[i]);                              \
+        }                                                                      \
+    }
+#endif
+
+#ifdef SATURATING_SIMD_IMPL
+SATURATING_SIMD_IMPL(::std::uint8_t, add, epu8, u8)
+SATURATING_SIMD_IMPL(::std::int8_t, add, epi8, s8)
+SATURATING_SIMD_IMPL(::std::uint16_t, add, epu16, u16)
+SATURATING_SIMD_IMPL(::std::int16_t, add, epi16, s16)
+SATURATING_SIMD_IMPL(::std::uint8_t, sub, epu8, u8)
+SATURATING_SIMD_IMPL(::std::int8_t, sub, epi8, s8)
+SATURATING_SIMD_IMPL(::std::uint16_t, sub, epu16, u16)
+SATURATING_SIMD_IMPL(::std::int16_t, sub, epi16, s16)
+
+#undef SATURATING_SIMD_IMPL
+#endif
+
+// no lanes for the other widths
+template <typename T>
+void saturating_add_block(const T *a, const T *b, T *out,
+                          ::std::size_t count) noexcept {
+    for (::std::size_t i = 0; i < count; ++i) {
+        out[i] = saturating_add(a[i], b[i]);
+    }
+}
+template <typename T>
+void saturating_sub_block(const T *a, const T *b, T *out,
+                          ::std::size_t count) noexcept {
+    for (::std::size_t i = 0; i < count; ++i) {
+        out[i] = saturating_sub(a[i], b[i]);
+    }
+}
+
+} // namespace detail
+
+namespace detail {
+
+constexpr unsigned digit_value(char c) noexcept {
+    return c >= '0' && c <= '9'   ? static_cast<unsigned>(c - '0')
+           : c >= 'a' && c <= 'z' ? static_cast<unsigned>(c - 'a' + 10)
+           : c >= 'A' && c <= 'Z' ? static_cast<unsigned>(c - 'A' + 10)
+                                  : 255U;
+}
+
+// SWAR digit parsing from
+// https://lemire.me/blog/2022/01/21/swar-explained-parsing-eight-digits/
+inline ::std::uint64_t load_eight_chars(const char *p) noexcept {
+    // assembled little-endian on every host, folded into one load
+    ::std::uint64_t v = 0;
+    for (auto i = 0; i < 8; ++i) {
+        v |= static_cast<::std::uint64_t>(static_cast<::std::uint8_t>(p[i]))
+             << (8 * i);
+    }
+    return v;
+}
+
+inline bool is_eight_digits(::std::uint64_t v) noexcept {
+    return ((v & 0xf0f0f0f0f0f0f0f0) |
+            (((v + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4)) ==
+           0x3333333333333333;
+}
+
+inline ::std::uint32_t parse_eight_digits(::std::uint64_t v) noexcept {
+    v = (v & 0x0f0f0f0f0f0f0f0f) * 2561 >> 8;
+    v = (v & 0x00ff00ff00ff00ff) * 6553601 >> 16;
+    return static_cast<::std::uint32_t>((v & 0x0000ffff0000ffff) *
+                                            42949672960001 >>
+                                        32);
+}
+
+// unsigned magnitude of [@p, @last), 8 decimal digits per step when the
+// accumulator is wide enough
+template <typename U>
+ParseError parse_magnitude(const char *p, const char *last, unsigned radix,
+                           U &out) noexcept {
+    const auto max = Limits<U>::max();
+    U acc = 0;
+    if (radix == 10 && sizeof(U) >= 8) {
+        for (; last - p >= 8; p += 8) {
+            const auto chars = load_eight_chars(p);
+            if (!is_eight_digits(chars)) {
+                break;
+            }
+            const U v = parse_eight_digits(chars);
+            if (acc > (max - v) / 100000000U) {
+                return ParseError::PosOverflow;
+            }
+            acc = acc * 100000000U + v;
+        }
+    }
+    for (; p != last; ++p) {
+        const auto d = digit_value(*p);
+        if (d >= radix) {
+            return ParseError::InvalidDigit;
+        }
+        if (acc > (max - d) / radix) {
+            return ParseError::PosOverflow;
+        }
+        acc = static_cast<U>(acc * radix + d);
+    }
+    out = acc;
+    return ParseError::None;
+}
+
+template <typename T>
+enable_if_t<IsInteger<T>::value, ParseError>
+parse_number(const char *first, const char *last, unsigned radix, T &out) {
+    using U = typename MakeUnsigned<T>::Type;
+    if (first == last) {
+        return ParseError::Empty;
+    }
+    const auto negative = *first == '-';
+    if (*first == '+' || negative) {
+        ++first;
+        if (first == last || (negative && !IsSigned<T>::value)) {
+            return ParseError::InvalidDigit;
+        }
+    }
+    U magnitude = 0;
+    const auto error = parse_magnitude(first, last, radix, magnitude);
+    if (error != ParseError::None) {
+        return negative && error == ParseError::PosOverflow
+                   ? ParseError::NegOverflow
+                   : error;
+    }
+    const auto max = static_cast<U>(Limits<T>::max());
+    if (negative) {
+        if (magnitude > static_cast<U>(max + 1U)) {
+            return ParseError::NegOverflow;
+        }
+        out = static_cast<T>(0 - magnitude);
+    } else {
+        if (magnitude > max) {
+            return ParseError::PosOverflow;
+        }
+        out = static_cast<T>(magnitude);
+    }
+    return ParseError::None;
+}
+
+inline void parse_float_slow(const char *s, char **end, float &out) {
+    out = ::std::strtof(s, end);
+}
+inline void parse_float_slow(const char *s, char **end, double &out) {
+    out = ::std::strtod(s, end);
+}
+
+template <typename T>
+enable_if_t<::std::is_floating_point<T>::value, ParseError>
+parse_number(const char *first, const char *last, unsigned radix, T &out) {
+    if (first == last) {
+        return ParseError::Empty;
+    }
+    if (radix != 10) {
+        return ParseError::Invalid;
+    }
+    const auto *p = first + (*first == '+' ? 1 : 0);
+    if (p == last || (p != first && *p == '-')) {
+        return ParseError::Invalid;
+    }
+#ifdef __cpp_lib_to_chars
+    // libstdc++ and msvc implement this with eisel-lemire
+    const auto r = ::std::from_chars(p, last, out);
+    if (r.ec == ::std::errc() && r.ptr == last) {
+        return ParseError::None;
+    }
+    if (r.ec != ::std::errc::result_out_of_range) {
+        return ParseError::Invalid;
+    }
+    // out of range goes on to yield inf or zero like rust
+#else
+    // clinger's fast path: exact when both mantissa and power of ten are
+    // exactly representable
+    const auto negative = *p == '-';
+    const auto *q = p + (negative ? 1 : 0);
+    ::std::uint64_t mantissa = 0;
+    auto digits = 0;
+    auto exponent = 0;
+    auto any = false;
+    for (; q != last && digit_value(*q) < 10; ++q, any = true) {
+        mantissa = mantissa * 10 + digit_value(*q);
+        digits += mantissa ? 1 : 0;
+    }
+    if (q != last && *q == '.') {
+        for (++q; q != last && digit_value(*q) < 10; ++q, any = true) {
+            mantissa = mantissa * 10 + digit_value(*q);
+            digits += mantissa ? 1 : 0;
+            --exponent;
+        }
+    }
+    if (q != last && (*q == 'e' || *q == 'E') && any) {
+        const auto *e = q + 1;
+        const auto exp_negative = e != last && *e == '-';
+        e += e != last && (*e == '-' || *e == '+') ? 1 : 0;
+        auto exp = 0;
+        for (; e != last && digit_value(*e) < 10; ++e) {
+            // saturated, far beyond any finite exponent
+            exp = exp < 100000 ? exp * 10 + static_cast<int>(digit_value(*e))
+                               : exp;
+        }
+        if (e != last || digit_value(e[-1]) >= 10) {
+            return ParseError::Invalid;
+        }
+        exponent += exp_negative ? -exp : exp;
+        q = last;
+    }
+    constexpr auto max_exp = sizeof(T) == 4 ? 10 : 22;
+    if (q == last && any && digits <= 19 &&
+        mantissa <= (1ULL << ::std::numeric_limits<T>::digits) &&
+        exponent >= -max_exp && exponent <= max_exp) {
+        static constexpr double POW10[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+            1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+            1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22}; // NOLINT
+        auto value = static_cast<T>(mantissa);
+        const auto scale = static_cast<T>(POW10[exponent < 0 ? -exponent
+                                                             : exponent]);
+        value = exponent < 0 ? value / scale : value * scale;
+        out = negative ? -value : value;
+        return ParseError::None;
+    }
+#endif
+    if (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r' ||
+        ::std::find(p, last, 'x') != last || ::std::find(p, last, 'X') != last) {
+        return ParseError::Invalid;
+    }
+    const auto copy = ::std::string(p, last);
+    char *end = nullptr;
+    parse_float_slow(copy.c_str(), &end, out);
+    return end == copy.c_str() + copy.size() ? ParseError::None
+                                             : ParseError::Invalid;
+}
+
+// write_to output matches num_put under @loc: no digit grouping and '.'
+// as the decimal point
+inline bool is_plain_locale(const ::std::locale &loc) {
+    if (loc == ::std::locale::classic()) {
+        return true;
+    }
+    const auto &punct = ::std::use_facet<::std::numpunct<char>>(loc);
+    return punct.grouping().empty() && punct.decimal_point() == '.';
+}
+
+// @n bytes as one formatted output: the sentry flushes tie() before and
+// honors unitbuf after, a short write sets badbit
+inline ::std::ostream &write_formatted(::std::ostream &s, const char *data,
+                                       ::std::streamsize n) {
+    const ::std::ostream::sentry sentry(s);
+    if (sentry && s.rdbuf()->sputn(data, n) != n) {
+        s.setstate(::std::ios_base::badbit);
+    }
+    return s;
+}
+
+template <typename T>
+enable_if_t<!(IsInteger<T>::value && sizeof(T) == 16), ::std::ostream &>
+stream_number(::std::ostream &s, const T &value) {
+    return s << +value;
+}
+
+// ostream has no 128-bit overloads, base, showbase, showpos and uppercase
+// are honored here, the padding by the string insertion
+template <typename T>
+enable_if_t<IsInteger<T>::value && sizeof(T) == 16, ::std::ostream &>
+stream_number(::std::ostream &s, const T &value) {
+    const auto flags = s.flags();
+    const auto base = flags & ::std::ios_base::basefield;
+    char buffer[48]; // NOLINT(modernize-avoid-c-arrays)
+    auto *const end = buffer + sizeof(buffer);
+    auto *p = end;
+    if (base == ::std::ios_base::hex || base == ::std::ios_base::oct) {
+        const auto *digits = flags & ::std::ios_base::uppercase
+                                 ? "0123456789ABCDEF"
+                                 : "0123456789abcdef";
+        const auto shift = base == ::std::ios_base::hex ? 4U : 3U;
+        auto bits = static_cast<uint128>(value);
+        do {
+            *--p = digits[static_cast<unsigned>(bits & uint128((1U << shift) -
+                                                               1))];
+            bits = bits >> shift;
+        } while (bits);
+        if (flags & ::std::ios_base::showbase && value != T(0)) {
+            if (base == ::std::ios_base::hex) {
+                *--p = flags & ::std::ios_base::uppercase ? 'X' : 'x';
+            }
+            *--p = '0';
+        }
+    } else {
+        p = buffer + 1;
+        const auto *last = write_number(p, value);
+        if (flags & ::std::ios_base::showpos && IsSigned<T>::value &&
+            !(value < T(0))) {
+            *--p = '+';
+        }
+        return s << ::std::string(p, static_cast<::std::size_t>(last - p));
+    }
+    return s << ::std::string(p, end);
+}
+
+template <typename T>
+enable_if_t<!(IsInteger<T>::value && sizeof(T) == 16), ::std::istream &>
+read_number(::std::istream &s, T &value) {
+    return s >> value;
+}
+
+template <typename T>
+enable_if_t<IsInteger<T>::value && sizeof(T) == 16, ::std::istream &>
+read_number(::std::istream &s, T &value) {
+    auto token = ::std::string{};
+    if (s >> token && parse_number(token.data(), token.data() + token.size(),
+                                   10, value) != ParseError::None) {
+        s.setstate(::std::ios_base::failbit);
+    }
+    return s;
+}
+
+template <typename T> ::std::size_t hash_value(const T &value) noexcept {
+    return ::std::hash<T>{}(value);
+}
+inline ::std::size_t hash_value(const uint128 &value) noexcept {
+    const auto lo = static_cast<::std::uint64_t>(value);
+    const auto hi = static_cast<::std::uint64_t>(value >> 64U);
+    return ::std::hash<::std::uint64_t>{}(lo ^ (hi * 0x9e3779b97f4a7c15ULL +
+                                                (lo << 6) + (lo >> 2)));
+}
+inline ::std::size_t hash_value(const int128 &value) noexcept {
+    return hash_value(static_cast<uint128>(value));
+}
+
+// integer literal of any base with digit separators, for wide integers
+template <typename U>
+constexpr U parse_literal(const char *s, unsigned base, U acc) {
+    return *s == '\0'   ? acc
+           : *s == '\'' ? parse_literal(s + 1, base, acc)
+                        : parse_literal(s + 1, base,
+                                        acc * U(base) + U(digit_value(*s)));
+}
+template <typename U> constexpr U parse_literal(const char *s) {
+    return s[0] == '0' && (s[1] == 'x' || s[1] == 'X')
+               ? parse_literal(s + 2, 16, U(0))
+           : s[0] == '0' && (s[1] == 'b' || s[1] == 'B')
+               ? parse_literal(s + 2, 2, U(0))
+           : s[0] == '0' && s[1] != '\0' ? parse_literal(s + 1, 8, U(0))
+                                         : parse_literal(s, 10, U(0));
+}
+
+// ~0 / base for the literal bases, as TwoLimb cannot divide in constant
+// expressions
+constexpr uint128 max_before_digit(unsigned base) noexcept {
+    return base == 10 ? (uint128(0x1999999999999999ULL) << 64U) |
+                            uint128(0x9999999999999999ULL)
+                      : ~uint128(0) >> (base == 16  ? 4U
+                                        : base == 8 ? 3U
+                                                    : 1U);
+}
+
+// integer literal at most @max, checked digit by digit so nothing wraps;
+// floating literals fail on their point or exponent
+constexpr bool literal_fits(const char *s, unsigned base, uint128 acc,
+                            uint128 max) noexcept {
+    return *s == '\0'   ? acc <= max
+           : *s == '\'' ? literal_fits(s + 1, base, acc, max)
+                        : digit_value(*s) < base &&
+                              acc <= max_before_digit(base) &&
+                              acc * uint128(base) <=
+                                  ~uint128(0) - uint128(digit_value(*s)) &&
+                              literal_fits(s + 1, base,
+                                           acc * uint128(base) +
+                                               uint128(digit_value(*s)),
+                                           max);
+}
+constexpr bool literal_fits(const char *s, uint128 max) noexcept {
+    return s[0] == '0' && (s[1] == 'x' || s[1] == 'X')
+               ? literal_fits(s + 2, 16, uint128(0), max)
+           : s[0] == '0' && (s[1] == 'b' || s[1] == 'B')
+               ? literal_fits(s + 2, 2, uint128(0), max)
+           : s[0] == '0' && s[1] != '\0'
+               ? literal_fits(s + 1, 8, uint128(0), max)
+               : literal_fits(s, 10, uint128(0), max);
+}
+
+// largest literal of T: its MAX, or the magnitude of MIN when signed,
+// which is only usable negated (see MinLiteral)
+template <typename T> constexpr uint128 literal_max() noexcept {
+    return IsSigned<T>::value ? uint128(Limits<T>::max()) + uint128(1)
+                              : uint128(Limits<T>::max());
+}
+
+// the characters of a literal operator template as a string
+template <char... Cs> struct LiteralChars {
+    static constexpr char value[sizeof...(Cs) + 1] = {Cs..., '\0'};
+};
+// value of an integer literal of T, a constant even at -O0
+template <typename T, char... Cs> struct Literal {
+    static constexpr T value =
+        static_cast<T>(parse_literal<uint128>(LiteralChars<Cs...>::value));
+};
+#if __cplusplus < 201703L
+template <char... Cs>
+constexpr char LiteralChars<Cs...>::value[sizeof...(Cs) + 1];
+template <typename T, char... Cs> constexpr T Literal<T, Cs...>::value;
+#endif
+
+} // namespace detail
+
+template <typename T> struct Number;
+
+namespace detail {
+
+// The magnitude of a signed MIN, e.g. 0x80000000_i32, out of range by
+// itself and MIN once negated: no conversion, only unary minus.
+template <typename T> struct MinLiteral {
+    constexpr Number<T> operator-() const noexcept {
+        return Number<T>{Limits<T>::min()};
+    }
+};
+
+template <typename T, char... Cs>
+struct IsMinLiteral
+    : ::std::integral_constant<
+          bool, IsSigned<T>::value &&
+                    parse_literal<uint128>(LiteralChars<Cs...>::value) ==
+                        literal_max<T>()> {};
+
+template <typename T, char... Cs>
+using LiteralType =
+    typename ::std::conditional<IsMinLiteral<T, Cs...>::value, MinLiteral<T>,
+                                Number<T>>::type;
+
+template <typename T, char... Cs>
+constexpr Number<T> make_literal(::std::false_type /*min*/) noexcept {
+    return Number<T>{Literal<T, Cs...>::value};
+}
+template <typename T, char... Cs>
+constexpr MinLiteral<T> make_literal(::std::true_type /*min*/) noexcept {
+    return MinLiteral<T>{};
+}
+
+template <typename N> struct ValueOf {
+    using Type = N;
+};
+template <typename T> struct ValueOf<Number<T>> {
+    using Type = T;
+};
+
+// T holds every value of U
+template <typename T, typename U>
+struct Contains
+    : ::std::integral_constant<
+          bool,
+          IsInteger<T>::value && IsInteger<U>::value
+              ? (IsSigned<T>::value == IsSigned<U>::value
+                     ? sizeof(T) >= sizeof(U)
+                     : IsSigned<T>::value && sizeof(T) > sizeof(U))
+          : ::std::is_floating_point<T>::value &&
+                  ::std::is_floating_point<U>::value
+              ? sizeof(T) >= sizeof(U)
+          : ::std::is_floating_point<T>::value && IsInteger<U>::value
+              ? 8 * sizeof(U) - IsSigned<U>::value <=
+                    static_cast<::std::size_t>(
+                        ::std::numeric_limits<T>::digits)
+              : false> {};
+
+// none out of range, nothing to check when T holds every value of U
+template <typename T, typename U>
+constexpr enable_if_t<Contains<T, U>::value, Checked<Number<T>>>
+try_convert(const U &value) noexcept {
+    return Checked<Number<T>>{Number<T>{static_cast<T>(value)}};
+}
+template <typename T, typename U>
+constexpr enable_if_t<!Contains<T, U>::value, Checked<Number<T>>>
+try_convert(const U &value) noexcept {
+    // in range when the round trip gives the value back with its sign
+    return Checked<Number<T>>{
+        Number<T>{static_cast<T>(value)},
+        static_cast<U>(static_cast<T>(value)) != value ||
+            below_zero(value) != below_zero(static_cast<T>(value))};
+}
+
+// 2 ** @n in F
+template <typename F> constexpr F power_of_two(unsigned n) noexcept {
+    return n == 0 ? F(1) : F(2) * power_of_two<F>(n - 1);
+}
+
+// rust `as`: integers wrap, floats to integers saturate with NaN as 0
+template <typename T, typename U>
+constexpr enable_if_t<
+    !(IsInteger<T>::value && ::std::is_floating_point<U>::value), T>
+as_cast(const U &value) noexcept {
+    return static_cast<T>(value);
+}
+template <typename T, typename U>
+constexpr enable_if_t<IsInteger<T>::value && ::std::is_floating_point<U>::value,
+                      T>
+as_cast(const U &value) noexcept {
+    return value != value ? T(0) // NOLINT(misc-redundant-expression)
+           : value <= static_cast<U>(Limits<T>::min()) ? Limits<T>::min()
+           : value >= power_of_two<U>(8 * sizeof(T) - IsSigned<T>::value)
+               ? Limits<T>::max()
+               : static_cast<T>(value);
+}
+
+} // namespace detail
+
+template <typename T> struct Number {
+    template <::std::size_t N>
+    using Bytes = ::std::array<Number<::std::uint8_t>, N>;
+    using Self = Number<T>;
+    T value;
+
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    inline constexpr operator T() const & { return this->value; }
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    inline constexpr Number<T>(const T &value) : value(value){};
+    inline constexpr Number<T>() = default;
+    inline constexpr Number<T>(const Self &) = default;
+
+    // compile time endian detection from
+    // https://en.cppreference.com/w/cpp/types/endian
+#ifdef _WIN32
+    static constexpr bool is_le = true;  // NOLINT
+    static constexpr bool is_be = false; // NOLINT
+#else
+    static constexpr bool is_le = // NOLINT
+        __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+    static constexpr bool is_be = // NOLINT
+        __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__;
+#endif
+    static_assert(is_le || is_be, "Neither little-endian or big-endian!");
+
+    static constexpr Self from_ne_bytes(const Bytes<sizeof(T)> &bytes) {
+        return bit_cast<Self>(bytes);
+    }
+
+    constexpr Bytes<sizeof(T)> to_ne_bytes() const & {
+        return bit_cast<Bytes<sizeof(T)>>(value);
+    }
+
+    // Based on https://en.cppreference.com/w/cpp/container/array/rbegin
+    template <::std::size_t N>
+    static constexpr Bytes<N> reverse_bytes(Bytes<N> bytes) noexcept {
+        Bytes<N> reversed_bytes;
+        ::std::copy(bytes.crbegin(), bytes.crend(), reversed_bytes.begin());
+        return reversed_bytes;
+    }
+
+    // floating values are swapped through the unsigned integer of same width
+    constexpr Self reverse_bytes() const & {
+        return bit_cast<Self>(detail::byteswap(
+            bit_cast<typename detail::UintOf<sizeof(T)>::Type>(value)));
+    }
+
+#define BYTE_CONVERT_IMPL(e)                                                   \
+    static constexpr Self from_##e##_bytes(const Bytes<sizeof(T)> &bytes) {    \
+        return is_##e ? from_ne_bytes(bytes)                                   \
+                      : from_ne_bytes(bytes).reverse_bytes();                  \
+    }                                                                          \
+    static constexpr Self from_##e(const Self &source) {                       \
+        return is_##e ? source : source.reverse_bytes();                       \
+    }                                                                          \
+    constexpr Bytes<sizeof(T)> to_##e##_bytes() const & {                      \
+        return is_##e ? to_ne_bytes() : reverse_bytes().to_ne_bytes();         \
+    }                                                                          \
+    constexpr Self to_##e() const & {                                          \
+        return is_##e ? Self{value} : reverse_bytes();                         \
+    }
+
+    BYTE_CONVERT_IMPL(le)
+    BYTE_CONVERT_IMPL(be)
+
+#undef BYTE_CONVERT_IMPL
+
+    // bulk conversion of @count elements, native endian is a plain memcpy
+    static void swap_bytes_inplace(Self *data, ::std::size_t count) noexcept {
+        auto *bytes = reinterpret_cast<::std::uint8_t *>(data); // NOLINT
+        detail::swap_bytes_block<sizeof(T)>(bytes, bytes, count);
+    }
+
+    // works with any contiguous container, e.g. Vec<Self> and Array<Self, N>
+    template <typename C> static void swap_bytes_inplace(C &container) noexcept {
+        swap_bytes_inplace(container.data(), container.size());
+    }
+
+#define SLICE_CONVERT_IMPL(e)                                                  \
+    static void from_##e##_slice(const ::std::uint8_t *bytes,                  \
+                                 ::std::size_t count, Self *out) noexcept {    \
+        auto *dst = reinterpret_cast<::std::uint8_t *>(out); /* NOLINT */      \
+        if (is_##e) {                                                          \
+            ::std::memmove(dst, bytes, count * sizeof(T));                     \
+        } else {                                                               \
+            detail::swap_bytes_block<sizeof(T)>(bytes, dst, count);            \
+        }                                                                      \
+    }                                                                          \
+    static void to_##e##_slice(const Self *in, ::std::size_t count,            \
+                               ::std::uint8_t *bytes) noexcept {               \
+        const auto *src =                                                      \
+            reinterpret_cast<const ::std::uint8_t *>(in); /* NOLINT */         \
+        if (is_##e) {                                                          \
+            ::std::memmove(bytes, src, count * sizeof(T));                     \
+        } else {                                                               \
+            detail::swap_bytes_block<sizeof(T)>(src, bytes, count);            \
+        }                                                                      \
+    }
+
+    SLICE_CONVERT_IMPL(le)
+    SLICE_CONVERT_IMPL(be)
+
+#undef SLICE_CONVERT_IMPL
+
+    // rust integer arithmetic: overflowing_X returns the wrapped result and
+    // whether it overflowed, checked_X reports overflow, wrapping_X wraps
+    // and saturating_X clamps to the bounds of T
+#define OVERFLOW_IMPL(op)                                                      \
+    ::std::pair<Self, bool> overflowing_##op(const Self &rhs) const & {        \
+        T out;                                                                 \
+        const auto overflow = detail::op##_overflow(value, rhs.value, out);    \
+        return {Self{out}, overflow};                                          \
+    }                                                                          \
+    Checked<Self> checked_##op(const Self &rhs) const & {                      \
+        T out;                                                                 \
+        const auto overflow = detail::op##_overflow(value, rhs.value, out);    \
+        return {Self{out}, overflow};                                          \
+    }                                                                          \
+    Self wrapping_##op(const Self &rhs) const & {                              \
+        T out;                                                                 \
+        detail::op##_overflow(value, rhs.value, out);                          \
+        return out;                                                            \
+    }                                                                          \
+    Self saturating_##op(const Self &rhs) const & {                            \
+        return detail::saturating_##op(value, rhs.value);                      \
+    }
+
+    OVERFLOW_IMPL(add)
+    OVERFLOW_IMPL(sub)
+    OVERFLOW_IMPL(mul)
+
+#undef OVERFLOW_IMPL
+
+    // none on division by zero and on MIN / -1
+    Checked<Self> checked_div(const Self &rhs) const & {
+        return detail::div_overflow(value, rhs.value)
+                   ? Checked<Self>{Self{}, true}
+                   : Checked<Self>{Self{value / rhs.value}};
+    }
+    Checked<Self> checked_rem(const Self &rhs) const & {
+        return detail::div_overflow(value, rhs.value)
+                   ? Checked<Self>{Self{}, true}
+                   : Checked<Self>{Self{value % rhs.value}};
+    }
+    Checked<Self> checked_neg() const & { return Self{0}.checked_sub(*this); }
+    Self wrapping_neg() const & { return Self{0}.wrapping_sub(*this); }
+
+    // element wise over @count elements, in simd lanes for 8 and 16-bit
+    // integers; @out may alias either input
+#define SATURATING_SLICE_IMPL(op)                                              \
+    static void saturating_##op##_slice(const Self *a, const Self *b,          \
+                                        Self *out,                             \
+                                        ::std::size_t count) noexcept {        \
+        detail::saturating_##op##_block(                                       \
+            reinterpret_cast<const T *>(a), /* NOLINT */                       \
+            reinterpret_cast<const T *>(b), /* NOLINT */                       \
+            reinterpret_cast<T *>(out), count); /* NOLINT */                   \
+    }
+
+    SATURATING_SLICE_IMPL(add)
+    SATURATING_SLICE_IMPL(sub)
+
+#undef SATURATING_SLICE_IMPL
+
+    static void wrapping_add_slice(const Self *a, const Self *b, Self *out,
+                                   ::std::size_t count) noexcept {
+        for (::std::size_t i = 0; i < count; ++i) {
+            out[i] = a[i].wrapping_add(b[i]);
+        }
+    }
+    static void wrapping_sub_slice(const Self *a, const Self *b, Self *out,
+                                   ::std::size_t count) noexcept {
+        for (::std::size_t i = 0; i < count; ++i) {
+            out[i] = a[i].wrapping_sub(b[i]);
+        }
+    }
+
+    // rust conversions: from is lossless and compiles only when T holds
+    // every value of U, try_from is none out of range and checks nothing
+    // when T holds every value, as wraps integers and saturates floats to
+    // integers
+    template <typename U>
+    static constexpr Self from(const Number<U> &other) noexcept {
+        static_assert(detail::Contains<T, U>::value,
+                      "lossy conversion, use try_from or as!");
+        return Self{static_cast<T>(other.value)};
+    }
+    template <typename U>
+    static constexpr Checked<Self> try_from(const Number<U> &other) noexcept {
+        static_assert(detail::IsInteger<T>::value &&
+                          detail::IsInteger<U>::value,
+                      "integers only, use as!");
+        return detail::try_convert<T>(other.value);
+    }
+    template <typename U,
+              enable_if_t<detail::IsInteger<U>::value, int> = 0>
+    static constexpr Checked<Self> try_from(const U &other) noexcept {
+        return try_from(Number<U>{other});
+    }
+    // to a Number or to a raw numeric type, e.g. as<u8>() or as<float>()
+    template <typename N>
+    constexpr Number<typename detail::ValueOf<N>::Type> as() const & noexcept {
+        return Number<typename detail::ValueOf<N>::Type>{
+            detail::as_cast<typename detail::ValueOf<N>::Type>(value)};
+    }
+
+    // rust integer bit operations on the two's complement bits of T, each
+    // a single instruction where the target has one
+    static constexpr unsigned BITS = 8 * sizeof(T); // NOLINT
+
+    constexpr unsigned count_ones() const & noexcept {
+        return detail::count_ones(detail::as_unsigned(value));
+    }
+    constexpr unsigned count_zeros() const & noexcept {
+        return BITS - count_ones();
+    }
+    constexpr unsigned leading_zeros() const & noexcept {
+        return detail::leading_zeros(detail::as_unsigned(value));
+    }
+    constexpr unsigned trailing_zeros() const & noexcept {
+        return detail::trailing_zeros(detail::as_unsigned(value));
+    }
+    constexpr unsigned leading_ones() const & noexcept {
+        return detail::leading_zeros(detail::as_unsigned(T(~value)));
+    }
+    constexpr unsigned trailing_ones() const & noexcept {
+        return detail::trailing_zeros(detail::as_unsigned(T(~value)));
+    }
+    constexpr Self rotate_left(unsigned n) const & noexcept {
+        return static_cast<T>(detail::rotate_left(detail::as_unsigned(value), n));
+    }
+    constexpr Self rotate_right(unsigned n) const & noexcept {
+        return rotate_left(BITS - n % BITS);
+    }
+
+    // unsigned only, like rust
+    constexpr bool is_power_of_two() const & noexcept {
+        static_assert(!detail::IsSigned<T>::value, "unsigned integers only!");
+        return count_ones() == 1;
+    }
+    // none when the next power of two does not fit T
+    constexpr Checked<Self> checked_next_power_of_two() const & noexcept {
+        static_assert(!detail::IsSigned<T>::value, "unsigned integers only!");
+        return value <= T(1) ? Checked<Self>{Self{T(1)}}
+               : Self{T(value - T(1))}.leading_zeros() == 0
+                   ? Checked<Self>{Self{}, true}
+                   : Checked<Self>{Self{T(
+                         T(1) << (BITS - Self{T(value - T(1))}
+                                             .leading_zeros()))}};
+    }
+    // 0 when the next power of two does not fit T, like rust release builds
+    constexpr Self next_power_of_two() const & noexcept {
+        return checked_next_power_of_two().unwrap_or(Self{T(0)});
+    }
+
+    // set bits of @count elements, in simd lanes where available
+    static ::std::uint64_t count_ones_slice(const Self *data,
+                                            ::std::size_t count) noexcept {
+        return detail::count_ones_block(
+            reinterpret_cast<const ::std::uint8_t *>(data), // NOLINT
+            count * sizeof(T));
+    }
+
+    // like builtin integers, prefix and compound assignment return the
+    // operand itself and postfix returns the previous value
+#define INC_DEC_IMPL(op)                                                       \
+    RUSTY_CONSTEXPR14 Self &operator op() & noexcept {                         \
+        op value;                                                              \
+        return *this;                                                          \
+    }                                                                          \
+    RUSTY_CONSTEXPR14 Self operator op(int) & noexcept { /* NOLINT */          \
+        const auto old = *this;                                                \
+        op value;                                                              \
+        return old;                                                            \
+    }
+
+    INC_DEC_IMPL(++)
+    INC_DEC_IMPL(--)
+
+#undef INC_DEC_IMPL
+
+#define BINARY_ASSIGN_IMPL(op)                                                 \
+    RUSTY_CONSTEXPR14 Self &operator op##=(const Self &oprand) & noexcept {    \
+        value op## = oprand.value;                                             \
+        return *this;                                                          \
+    }
+
+    BINARY_ASSIGN_IMPL(+)
+    BINARY_ASSIGN_IMPL(-)
+    BINARY_ASSIGN_IMPL(*)
+    BINARY_ASSIGN_IMPL(/)
+    BINARY_ASSIGN_IMPL(%)
+    BINARY_ASSIGN_IMPL(&)
+    BINARY_ASSIGN_IMPL(|)
+    BINARY_ASSIGN_IMPL(^)
+    BINARY_ASSIGN_IMPL(<<)
+    BINARY_ASSIGN_IMPL(>>)
+
+#undef BINARY_ASSIGN_IMPL
+
+    // locale independent decimal formatting, shortest round trip for
+    // floating values, writes at most MAX_FORMAT_CHARS without terminator
+    char *write_to(char *out) const & noexcept {
+        return detail::write_number(out, value);
+    }
+
+    ::std::string to_string() const & {
+        char buffer[detail::MAX_FORMAT_CHARS]; // NOLINT
+        return {buffer, write_to(buffer)};
+    }
+
+    // `s << number.display()` always goes through write_to, whatever the
+    // stream flags are
+    struct Display {
+        const Self &number;
+
+        friend ::std::ostream &operator<<(::std::ostream &s,
+                                          const Display &d) {
+            char buffer[detail::MAX_FORMAT_CHARS]; // NOLINT
+            return detail::write_formatted(s, buffer,
+                                           d.number.write_to(buffer) - buffer);
+        }
+    };
+
+    Display display() const & noexcept { return Display{*this}; }
+
+    // integers skip num_put when the stream is plain decimal and its locale
+    // groups no digits
+    friend ::std::ostream &operator<<(::std::ostream &s, const Self &number) {
+        const auto flags = s.flags();
+        const auto base = flags & ::std::ios_base::basefield;
+        if (detail::IsInteger<T>::value && s.width() == 0 &&
+            (base == ::std::ios_base::dec || base == 0) &&
+            !(flags & ::std::ios_base::showpos) &&
+            detail::is_plain_locale(s.getloc())) {
+            return s << number.display();
+        }
+        return detail::stream_number(s, number.value);
+    }
+
+    // rust style parsing, no whitespace allowed, a leading '+' accepted
+    static ParseResult<Self> from_str_radix(const char *first,
+                                            const char *last,
+                                            unsigned radix) {
+        auto result = ParseResult<Self>{};
+        result.error =
+            detail::parse_number(first, last, radix, result.value.value);
+        return result;
+    }
+    static ParseResult<Self> from_str(const char *first, const char *last) {
+        return from_str_radix(first, last, 10);
+    }
+    // @S could be ::std::string, ::std::string_view, or anything with
+    // data() and size()
+    template <typename S>
+    static ParseResult<Self> from_str_radix(const S &s, unsigned radix) {
+        return from_str_radix(s.data(), s.data() + s.size(), radix);
+    }
+    template <typename S> static ParseResult<Self> from_str(const S &s) {
+        return from_str(s.data(), s.data() + s.size());
+    }
+
+    // parse every @delimiter separated field into @out (e.g. a Vec<Self>),
+    // stops at the first failing field whose index is then out.size()
+    template <typename C>
+    static ParseError parse_delimited(const char *first, const char *last,
+                                      char delimiter, C &out) {
+        while (first != last) {
+            const auto *end = static_cast<const char *>(
+                ::std::memchr(first, delimiter, last - first));
+            end = end ? end : last;
+            const auto result = from_str(first, end);
+            if (result.is_err()) {
+                return result.error;
+            }
+            out.push_back(result.value);
+            first = end == last ? last : end + 1;
+        }
+        return ParseError::None;
+    }
+
+    friend ::std::istream &operator>>(::std::istream &s, Self &number) {
+        return detail::read_number(s, number.value);
+    }
+};
+
+// Zero-copy view of @count encoded @N (a Number<T>) laid out in @BigEndian
+// order, elements are decoded on access with unaligned-safe loads
+template <typename N, bool BigEndian> class EndianSlice {
+  public:
+    // dereferencing decodes a value rather than referring to storage, so
+    // it is only an input iterator to the C++17 requirements, while C++20
+    // algorithms see the random access it really provides
+    class Iterator {
+      public:
+        using iterator_category = ::std::input_iterator_tag;
+#if __cplusplus >= 202002L
+        using iterator_concept = ::std::random_access_iterator_tag;
+#endif
+        using value_type = N;
+        using difference_type = ::std::ptrdiff_t;
+        using pointer = void;
+        using reference = N; // by value, no storage to refer to
+
+        constexpr Iterator() = default;
+        constexpr explicit Iterator(const ::std::uint8_t *ptr) : ptr(ptr) {}
+
+        N operator*() const { return decode(ptr); }
+        N operator[](difference_type n) const {
+            return decode(ptr + n * static_cast<difference_type>(sizeof(N)));
+        }
+
+        Iterator &operator++() { return *this += 1; }
+        Iterator &operator--() { return *this -= 1; }
+        Iterator operator++(int) { // NOLINT(cert-dcl21-cpp)
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+        Iterator operator--(int) { // NOLINT(cert-dcl21-cpp)
+            auto it = *this;
+            --*this;
+            return it;
+        }
+        Iterator &operator+=(difference_type n) {
+            ptr += n * static_cast<difference_type>(sizeof(N));
+            return *this;
+        }
+        Iterator &operator-=(difference_type n) { return *this += -n; }
+        friend Iterator operator+(Iterator it, difference_type n) {
+            return it += n;
+        }
+        friend Iterator operator+(difference_type n, Iterator it) {
+            return it += n;
+        }
+        friend Iterator operator-(Iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(const Iterator &a,
+                                         const Iterator &b) {
+            return (a.ptr - b.ptr) / static_cast<difference_type>(sizeof(N));
+        }
+
+#define COMPARE_IMPL(op)                                                       \
+    friend bool operator op(const Iterator &a, const Iterator &b) {            \
+        return a.ptr op b.ptr;                                                 \
+    }
+
+        COMPARE_IMPL(==)
+        COMPARE_IMPL(!=)
+        COMPARE_IMPL(<)
+        COMPARE_IMPL(<=)
+        COMPARE_IMPL(>)
+        COMPARE_IMPL(>=)
+
+#undef COMPARE_IMPL
+
+      private:
+        const ::std::uint8_t *ptr = nullptr;
+    };
+
+    using value_type = N;
+    using size_type = ::std::size_t;
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+
+    constexpr EndianSlice() = default;
+    constexpr EndianSlice(const ::std::uint8_t *bytes, ::std::size_t count)
+        : bytes(bytes), count(count) {}
+
+    constexpr ::std::size_t size() const { return count; }
+    constexpr bool empty() const { return count == 0; }
+    constexpr const ::std::uint8_t *data() const { return bytes; }
+
+    N operator[](::std::size_t i) const {
+        return decode(bytes + i * sizeof(N));
+    }
+    N front() const { return (*this)[0]; }
+    N back() const { return (*this)[count - 1]; }
+
+    Iterator begin() const { return Iterator{bytes}; }
+    Iterator end() const { return Iterator{bytes + count * sizeof(N)}; }
+
+    // sub view of @len elements starting from @start
+    EndianSlice subslice(::std::size_t start, ::std::size_t len) const {
+        return EndianSlice{bytes + start * sizeof(N), len};
+    }
+
+  private:
+    static N decode(const ::std::uint8_t *ptr) {
+        N number;
+        ::std::memcpy(&number, ptr, sizeof(N));
+        return BigEndian ? N::from_be(number) : N::from_le(number);
+    }
+
+    const ::std::uint8_t *bytes = nullptr;
+    ::std::size_t count = 0;
+};
+
+template <typename N> using LeSlice = EndianSlice<N, false>;
+template <typename N> using BeSlice = EndianSlice<N, true>;
+
+// wrappers must stay trivially copyable and laid out exactly like the
+// wrapped type, so that Vec<u32> memcpys and vectorizes like a raw array
+#define LAYOUT_CHECK(ALIAS, ORIGIN)                                            \
+    static_assert(is_trivial_v<ALIAS> &&                                       \
+                      ::std::is_trivially_copyable<ALIAS>::value &&            \
+                      ::std::is_standard_layout<ALIAS>::value,                 \
+                  #ALIAS " not trivial!");                                     \
+    static_assert(sizeof(ALIAS) == sizeof(ORIGIN) &&                           \
+                      alignof(ALIAS) == alignof(ORIGIN),                       \
+                  #ALIAS " not layout compatible with " #ORIGIN "!");
+
+// integer literals of any base and width, out of range ones rejected at
+// compile time instead of wrapping
+#define GENERAL_INT_IMPL(ALIAS, ORIGIN)                                        \
+    using ALIAS = Number<ORIGIN>;                                              \
+    LAYOUT_CHECK(ALIAS, ORIGIN)                                                \
+    namespace literal {                                                        \
+    template <char... Cs>                                                      \
+    constexpr detail::LiteralType<ORIGIN, Cs...> operator""_##ALIAS() {        \
+        static_assert(                                                         \
+            detail::literal_fits(detail::LiteralChars<Cs...>::value,           \
+                                 detail::literal_max<ORIGIN>()),               \
+            "_" #ALIAS " literal out of range or not an integer!");            \
+        return detail::make_literal<ORIGIN, Cs...>(                            \
+            detail::IsMinLiteral<ORIGIN, Cs...>{});                            \
+    }                                                                          \
+    } // namespace literal
+
+#define FIXED_INT_IMPL(BITS)                                                   \
+    GENERAL_INT_IMPL(i##BITS, int##BITS##_t)                                   \
+    GENERAL_INT_IMPL(u##BITS, uint##BITS##_t)
+
+#define FLOATING_IMPL(BITS, ORIGIN)                                            \
+    using f##BITS = Number<ORIGIN>;                                            \
+    LAYOUT_CHECK(f##BITS, ORIGIN)                                              \
+    static_assert(::std::numeric_limits<ORIGIN>::is_iec559 &&                  \
+                      sizeof(ORIGIN) == (BITS) / 8,                            \
+                  "f" #BITS " illegal!");                                      \
+    namespace literal {                                                        \
+    inline constexpr f##BITS operator""_f##BITS(long double val) {             \
+        return static_cast<f##BITS>(val);                                      \
+    }                                                                          \
+    } // namespace literal
+
+FIXED_INT_IMPL(8)
+FIXED_INT_IMPL(16)
+FIXED_INT_IMPL(32)
+FIXED_INT_IMPL(64)
+
+GENERAL_INT_IMPL(i128, int128)
+GENERAL_INT_IMPL(u128, uint128)
+
+GENERAL_INT_IMPL(isize, intptr_t)
+GENERAL_INT_IMPL(usize, uintptr_t)
+
+FLOATING_IMPL(32, float)
+FLOATING_IMPL(64, double)
+
+#undef FIXED_INT_IMPL
+#undef FLOATING_IMPL
+#undef GENERAL_INT_IMPL
+#undef LAYOUT_CHECK
+
+} // namespace rusty::numeric_types
+
+template <typename T> struct std::hash<::rusty::numeric_types::Number<T>> {
+    ::std::size_t constexpr operator()(
+        const ::rusty::numeric_types::Number<T> &number) const &noexcept {
+        return ::rusty::numeric_types::detail::hash_value(number.value);
+    }
+};
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <type_traits>
+
+namespace rusty::hash {
+
+namespace detail {
+
+using numeric_types::enable_if_t;
+using numeric_types::int128;
+using numeric_types::uint128;
+
+// wyhash secrets
+constexpr ::std::uint64_t SECRET0 = 0xa0761d6478bd642fULL;
+constexpr ::std::uint64_t SECRET1 = 0xe7037ed1a0b428dbULL;
+
+// folded 128-bit product, a single mul instruction with native uint128
+inline ::std::uint64_t mum(::std::uint64_t a, ::std::uint64_t b) noexcept {
+    const auto product = uint128(a) * uint128(b);
+    return static_cast<::std::uint64_t>(product) ^
+           static_cast<::std::uint64_t>(product >> 64U);
+}
+
+inline ::std::uint64_t read64(const char *p) noexcept {
+    ::std::uint64_t v;
+    ::std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline ::std::uint64_t hash_bytes(const char *p, ::std::size_t n,
+                                  ::std::uint64_t seed) noexcept {
+    seed ^= SECRET0;
+    auto a = ::std::uint64_t{0};
+    auto b = ::std::uint64_t{0};
+    auto rest = n;
+    for (; rest > 16; rest -= 16, p += 16) {
+        seed = mum(read64(p) ^ SECRET1, read64(p + 8) ^ seed);
+    }
+    if (rest > 8) {
+        a = read64(p);
+        b = read64(p + rest - 8);
+    } else if (rest > 0) {
+        ::std::memcpy(&a, p, rest);
+    }
+    return mum(SECRET1 ^ n, mum(a ^ SECRET1, b ^ seed));
+}
+
+// equal keys give equal hashes, numbers hash their bits in one multiply
+template <typename T>
+enable_if_t<(::std::is_integral<T>::value || ::std::is_enum<T>::value) &&
+                sizeof(T) <= 8,
+            ::std::uint64_t>
+hash_with(const T &value, ::std::uint64_t seed) noexcept {
+    return mum(static_cast<::std::uint64_t>(value) ^ seed ^ SECRET0, SECRET1);
+}
+
+template <typename T>
+enable_if_t<::std::is_floating_point<T>::value && sizeof(T) <= 8,
+            ::std::uint64_t>
+hash_with(const T &value, ::std::uint64_t seed) noexcept {
+    using Bits = typename numeric_types::detail::UintOf<sizeof(T)>::Type;
+    // +0.0 and -0.0 compare equal
+    return hash_with(value == T(0) ? Bits{0}
+                                   : numeric_types::bit_cast<Bits>(value),
+                     seed);
+}
+
+inline ::std::uint64_t hash_with(const uint128 &value,
+                                 ::std::uint64_t seed) noexcept {
+    return mum(static_cast<::std::uint64_t>(value) ^ seed ^ SECRET0,
+               static_cast<::std::uint64_t>(value >> 64U) ^ SECRET1);
+}
+inline ::std::uint64_t hash_with(const int128 &value,
+                                 ::std::uint64_t seed) noexcept {
+    return hash_with(static_cast<uint128>(value), seed);
+}
+
+inline ::std::uint64_t hash_with(const ::std::string &value,
+                                 ::std::uint64_t seed) noexcept {
+    return hash_bytes(value.data(), value.size(), seed);
+}
+
+template <typename T>
+::std::uint64_t hash_with(const numeric_types::Number<T> &number,
+                          ::std::uint64_t seed) noexcept {
+    return hash_with(number.value, seed);
+}
+
+// anything else is remixed from its std::hash
+template <typename T>
+enable_if_t<!::std::is_arithmetic<T>::value && !::std::is_enum<T>::value &&
+                !numeric_types::detail::IsInteger<T>::value,
+            ::std::uint64_t>
+hash_with(const T &value, ::std::uint64_t seed) {
+    return mum(static_cast<::std::uint64_t>(::std::hash<T>{}(value)) ^ seed ^
+                   SECRET0,
+               SECRET1);
+}
+
+// distinct per call, unpredictable across processes
+inline ::std::uint64_t next_seed() {
+    static const auto key = [] {
+        ::std::random_device device;
+        return (::std::uint64_t{device()} << 32U) ^ device();
+    }();
+    static ::std::atomic<::std::uint64_t> counter{0};
+    return mum(key ^ counter.fetch_add(1, ::std::memory_order_relaxed),
+               SECRET1);
+}
+
+} // namespace detail
+
+// Hasher families, picked per map like `HashMap<u64, V, FastHash>`. Like
+// rust BuildHasher, each map default constructs its own hasher.
+
+// std::hash, the identity for integers in libstdc++ and libc++
+template <typename T> using StdHash = ::std::hash<T>;
+
+// deterministic, a single wide multiply for numbers
+template <typename T> struct FastHash {
+    using is_avalanching = ::std::true_type; // no remixing needed by tables
+
+    ::std::size_t operator()(const T &value) const noexcept {
+        return static_cast<::std::size_t>(detail::hash_with(value, 0));
+    }
+};
+
+// seeded per instance from a per-process random key like rust RandomState,
+// so colliding key sets cannot be precomputed
+template <typename T> class RandomHash {
+  public:
+    using is_avalanching = ::std::true_type;
+
+    RandomHash() : seed(detail::next_seed()) {}
+    explicit RandomHash(::std::uint64_t seed) : seed(seed) {}
+
+    ::std::size_t operator()(const T &value) const noexcept {
+        return static_cast<::std::size_t>(detail::hash_with(value, seed));
+    }
+
+  private:
+    ::std::uint64_t seed;
+};
+
+} // namespace rusty::hash
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define RUSTY_ALLOC_HAS_PMR
+#endif
+#endif
+
+namespace rusty::alloc {
+
+// Bump allocator: allocation moves a pointer, deallocation does nothing and
+// everything is released at once by reset() or a Scope. Chunks are kept
+// and reused after a reset, so steady state allocates no memory at all.
+#ifdef RUSTY_ALLOC_HAS_PMR
+class Arena : public ::std::pmr::memory_resource {
+#else
+class Arena {
+#endif
+  public:
+    static constexpr ::std::size_t DEFAULT_CHUNK = 64 << 10;
+
+    // position to rewind to
+    struct Mark {
+        ::std::size_t chunk;
+        ::std::size_t offset;
+    };
+
+    // rewinds the arena on destruction, releasing what the scope allocated
+    class Scope {
+      public:
+        explicit Scope(Arena &arena) : arena(arena), mark(arena.mark()) {}
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+        ~Scope() { arena.rewind(mark); }
+
+      private:
+        Arena &arena;
+        Mark mark;
+    };
+
+    explicit Arena(::std::size_t chunk_size = DEFAULT_CHUNK)
+        : chunk_size(chunk_size) {}
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+#ifdef RUSTY_ALLOC_HAS_PMR
+    ~Arena() override {
+#else
+    ~Arena() {
+#endif
+        for (const auto &chunk : chunks) {
+            ::operator delete(chunk.data);
+        }
+    }
+
+    void *allocate(::std::size_t bytes,
+                   ::std::size_t align = alignof(::std::max_align_t)) {
+        const auto p = align_up(cur, align);
+        if (cur != 0 && p + bytes <= end) {
+            cur = p + bytes;
+            return reinterpret_cast<void *>(p); // NOLINT
+        }
+        return allocate_slow(bytes, align);
+    }
+
+    Mark mark() const noexcept {
+        return {current, chunks.empty() ? 0
+                                        : static_cast<::std::size_t>(
+                                              cur - as_int(chunks[current]))};
+    }
+    void rewind(const Mark &mark) noexcept {
+        if (!chunks.empty()) {
+            current = mark.chunk;
+            cur = as_int(chunks[current]) + mark.offset;
+            end = as_int(chunks[current]) + chunks[current].size;
+        }
+    }
+    // release everything in O(1), chunks stay for reuse
+    void reset() noexcept { rewind(Mark{0, 0}); }
+
+    // bytes reserved from the system
+    ::std::size_t capacity() const noexcept {
+        auto total = ::std::size_t{0};
+        for (const auto &chunk : chunks) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+#ifdef RUSTY_ALLOC_HAS_PMR
+  protected:
+    void *do_allocate(::std::size_t bytes, ::std::size_t align) override {
+        return allocate(bytes, align);
+    }
+    void do_deallocate(void * /*p*/, ::std::size_t /*bytes*/,
+                       ::std::size_t /*align*/) override {}
+    bool do_is_equal(const ::std::pmr::memory_resource &other)
+        const noexcept override {
+        return this == &other;
+    }
+#endif
+
+  private:
+    struct Chunk {
+        void *data;
+        ::std::size_t size;
+    };
+
+    static ::std::uintptr_t as_int(const Chunk &chunk) noexcept {
+        return reinterpret_cast<::std::uintptr_t>(chunk.data); // NOLINT
+    }
+    static ::std::uintptr_t align_up(::std::uintptr_t p,
+                                     ::std::size_t align) noexcept {
+        return (p + align - 1) & ~static_cast<::std::uintptr_t>(align - 1);
+    }
+
+    // next chunk with room, reused after a rewind or freshly allocated
+    void *allocate_slow(::std::size_t bytes, ::std::size_t align) {
+        const auto needed = bytes + align - 1;
+        auto next = chunks.empty() ? 0 : current + 1;
+        if (next == chunks.size() || chunks[next].size < needed) {
+            const auto size = ::std::max(chunk_size, needed);
+            chunks.insert(chunks.begin() + static_cast<::std::ptrdiff_t>(next),
+                          Chunk{::operator new(size), size});
+        }
+        current = next;
+        cur = as_int(chunks[current]);
+        end = cur + chunks[current].size;
+        const auto p = align_up(cur, align);
+        cur = p + bytes;
+        return reinterpret_cast<void *>(p); // NOLINT
+    }
+
+    ::std::size_t chunk_size;
+    ::std::vector<Chunk> chunks;
+    ::std::size_t current = 0;
+    ::std::uintptr_t cur = 0;
+    ::std::uintptr_t end = 0;
+};
+
+// std allocator drawing from an Arena, for containers without pmr
+template <typename T> class ArenaAllocator {
+  public:
+    using value_type = T;
+
+    ArenaAllocator(Arena *arena) noexcept // NOLINT(google-explicit-constructor)
+        : arena(arena) {}
+    template <typename U>
+    ArenaAllocator( // NOLINT(google-explicit-constructor)
+        const ArenaAllocator<U> &other) noexcept
+        : arena(other.arena) {}
+
+    T *allocate(::std::size_t n) {
+        return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T * /*p*/, ::std::size_t /*n*/) noexcept {}
+
+    template <typename U>
+    friend bool operator==(const ArenaAllocator &a,
+                           const ArenaAllocator<U> &b) noexcept {
+        return a.arena == b.arena;
+    }
+    template <typename U>
+    friend bool operator!=(const ArenaAllocator &a,
+                           const ArenaAllocator<U> &b) noexcept {
+        return a.arena != b.arena;
+    }
+
+    Arena *arena;
+};
+
+// Collections allocating from an Arena, constructed like `Vec<T> v(&arena)`,
+// pmr containers when available
+namespace arena {
+
+#ifdef RUSTY_ALLOC_HAS_PMR
+template <typename T> using Allocator = ::std::pmr::polymorphic_allocator<T>;
+#else
+template <typename T> using Allocator = ArenaAllocator<T>;
+#endif
+
+template <typename T> using Vec = ::std::vector<T, Allocator<T>>;
+template <typename K, typename V, template <typename> class H = ::std::hash>
+using HashMap = ::std::unordered_map<K, V, H<K>, ::std::equal_to<K>,
+                                     Allocator<::std::pair<const K, V>>>;
+using String =
+    ::std::basic_string<char, ::std::char_traits<char>, Allocator<char>>;
+
+} // namespace arena
+
+} // namespace rusty::alloc
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace rusty::collections {
+
+template <typename T1, typename T2> using Pair = ::std::pair<T1, T2>;
+template <typename T, ::std::size_t N> using Array = ::std::array<T, N>;
+template <typename T> using Vec = ::std::vector<T>;
+
+namespace detail {
+
+// FlatHashMap control bytes: free slots have the sign bit set, full slots
+// hold the low 7 bits of their hash
+constexpr ::std::int8_t CTRL_EMPTY = -128;
+constexpr ::std::int8_t CTRL_DELETED = -2;
+
+inline unsigned trailing_zeros(::std::uint32_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctz(bits));
+#else
+    auto n = 0U;
+    for (; !(bits & 1U); bits >>= 1U) {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// 16 control bytes probed at once, bit i of a match is set for byte i
+struct Group {
+    static constexpr ::std::size_t WIDTH = 16;
+
+#ifdef __SSE2__
+    explicit Group(const ::std::int8_t *ctrl)
+        : ctrl(_mm_load_si128(
+              reinterpret_cast<const __m128i *>(ctrl))) {} // NOLINT
+
+    ::std::uint32_t match(::std::int8_t h2) const {
+        return static_cast<::std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2))));
+    }
+    ::std::uint32_t match_free() const {
+        return static_cast<::std::uint32_t>(_mm_movemask_epi8(ctrl));
+    }
+
+    __m128i ctrl;
+#else
+    // plain loops, left for the compiler to vectorize
+    explicit Group(const ::std::int8_t *ctrl) : ctrl(ctrl) {}
+
+    ::std::uint32_t match(::std::int8_t h2) const {
+        auto bits = ::std::uint32_t{0};
+        for (::std::size_t i = 0; i < WIDTH; ++i) {
+            bits |= static_cast<::std::uint32_t>(ctrl[i] == h2) << i;
+        }
+        return bits;
+    }
+    ::std::uint32_t match_free() const {
+        auto bits = ::std::uint32_t{0};
+        for (::std::size_t i = 0; i < WIDTH; ++i) {
+            bits |= static_cast<::std::uint32_t>(ctrl[i] < 0) << i;
+        }
+        return bits;
+    }
+
+    const ::std::int8_t *ctrl;
+#endif
+
+    ::std::uint32_t match_empty() const { return match(CTRL_EMPTY); }
+};
+
+// hashers declaring is_avalanching already spread every input bit
+template <typename H, typename = void>
+struct IsAvalanching : ::std::false_type {};
+template <typename H>
+struct IsAvalanching<H, decltype(void(typename H::is_avalanching{}))>
+    : H::is_avalanching {};
+
+// control bytes of every table without storage, never written
+inline ::std::int8_t *empty_group() {
+    alignas(Group::WIDTH) static ::std::int8_t group[Group::WIDTH] = { // NOLINT
+        CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY,
+        CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY,
+        CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY,
+        CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY};
+    return group;
+}
+
+} // namespace detail
+
+// Open addressing hash map with the std::unordered_map interface subset we
+// use. Entries live inline in one allocation next to a control byte each;
+// lookups compare 16 control bytes per probe and touch an entry only on a
+// 7-bit hash match. Iterators and references are invalidated by rehashing.
+template <typename K, typename V, typename Hash = ::std::hash<K>,
+          typename KeyEqual = ::std::equal_to<K>>
+class FlatHashMap {
+  public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = Pair<const K, V>;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+
+    template <bool Const> class Iter {
+      public:
+        using iterator_category = ::std::forward_iterator_tag;
+        using value_type = FlatHashMap::value_type;
+        using difference_type = ::std::ptrdiff_t;
+        using pointer = typename ::std::conditional<Const, const value_type *,
+                                                    value_type *>::type;
+        using reference = typename ::std::conditional<Const, const value_type &,
+                                                      value_type &>::type;
+
+        Iter() = default;
+        template <bool C = Const, typename = numeric_types::enable_if_t<C>>
+        Iter(const Iter<false> &other) // NOLINT(google-explicit-constructor)
+            : ctrl(other.ctrl), end(other.end), slot(other.slot) {}
+
+        reference operator*() const { return *slot; }
+        pointer operator->() const { return slot; }
+
+        Iter &operator++() {
+            ++ctrl;
+            ++slot;
+            skip();
+            return *this;
+        }
+        Iter operator++(int) {
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+
+        friend bool operator==(const Iter &a, const Iter &b) {
+            return a.slot == b.slot;
+        }
+        friend bool operator!=(const Iter &a, const Iter &b) {
+            return a.slot != b.slot;
+        }
+
+      private:
+        friend class FlatHashMap;
+        template <bool> friend class Iter;
+
+        Iter(const ::std::int8_t *ctrl, const ::std::int8_t *end, pointer slot)
+            : ctrl(ctrl), end(end), slot(slot) {
+            skip();
+        }
+
+        void skip() {
+            while (ctrl != end && *ctrl < 0) {
+                ++ctrl;
+                ++slot;
+            }
+        }
+
+        const ::std::int8_t *ctrl = nullptr;
+        const ::std::int8_t *end = nullptr;
+        pointer slot = nullptr;
+    };
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+
+    FlatHashMap() = default;
+    explicit FlatHashMap(size_type n, const Hash &hash = Hash{},
+                         const KeyEqual &eq = KeyEqual{})
+        : hash(hash), eq(eq) {
+        reserve(n);
+    }
+    template <typename It,
+              typename = numeric_types::enable_if_t<!::std::is_integral<It>::value>>
+    FlatHashMap(It first, It last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+    FlatHashMap(::std::initializer_list<value_type> list)
+        : FlatHashMap(list.size()) {
+        for (const auto &i : list) {
+            insert(i);
+        }
+    }
+    FlatHashMap(const FlatHashMap &other)
+        : FlatHashMap(other.len, other.hash, other.eq) {
+        for (const auto &i : other) {
+            insert(i);
+        }
+    }
+    FlatHashMap(FlatHashMap &&other) noexcept
+        : hash(other.hash), eq(other.eq) {
+        swap(other);
+    }
+    FlatHashMap &operator=(FlatHashMap other) noexcept {
+        swap(other);
+        return *this;
+    }
+    ~FlatHashMap() {
+        destroy();
+        deallocate(ctrl, cap);
+    }
+
+    iterator begin() { return {ctrl, ctrl + cap, slots}; }
+    iterator end() { return {ctrl + cap, ctrl + cap, slots + cap}; }
+    const_iterator begin() const { return {ctrl, ctrl + cap, slots}; }
+    const_iterator end() const { return {ctrl + cap, ctrl + cap, slots + cap}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    bool empty() const noexcept { return len == 0; }
+    size_type size() const noexcept { return len; }
+    size_type capacity() const noexcept { return cap; }
+    hasher hash_function() const { return hash; }
+    key_equal key_eq() const { return eq; }
+
+    void clear() noexcept {
+        destroy();
+        if (cap > 0) {
+            ::std::memset(ctrl, detail::CTRL_EMPTY, cap);
+        }
+        len = 0;
+        growth_left = max_load(cap);
+    }
+
+    // room for @n entries without rehashing
+    void reserve(size_type n) {
+        if (n > len + growth_left) {
+            auto capacity = detail::Group::WIDTH;
+            while (max_load(capacity) < n) {
+                capacity *= 2;
+            }
+            rehash(capacity);
+        }
+    }
+
+    iterator find(const K &key) {
+        const auto i = find_index(key, hash_of(key));
+        return i == NPOS ? end() : iterator_at(i);
+    }
+    const_iterator find(const K &key) const {
+        const auto i = find_index(key, hash_of(key));
+        return i == NPOS ? end() : const_iterator{ctrl + i, ctrl + cap,
+                                                  slots + i};
+    }
+    size_type count(const K &key) const {
+        return find_index(key, hash_of(key)) != NPOS ? 1 : 0;
+    }
+    bool contains(const K &key) const { return count(key) != 0; }
+
+    V &at(const K &key) {
+        const auto i = find_index(key, hash_of(key));
+        if (i == NPOS) {
+            throw ::std::out_of_range("rusty::collections: key not found");
+        }
+        return slots[i].second;
+    }
+    const V &at(const K &key) const {
+        return const_cast<FlatHashMap &>(*this).at(key); // NOLINT
+    }
+    V &operator[](const K &key) { return try_emplace(key).first->second; }
+    V &operator[](K &&key) {
+        return try_emplace(::std::move(key)).first->second;
+    }
+
+    template <typename... Args>
+    Pair<iterator, bool> try_emplace(const K &key, Args &&...args) {
+        return emplace_key(key, ::std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    Pair<iterator, bool> try_emplace(K &&key, Args &&...args) {
+        return emplace_key(::std::move(key), ::std::forward<Args>(args)...);
+    }
+    template <typename... Args> Pair<iterator, bool> emplace(Args &&...args) {
+        auto value = value_type(::std::forward<Args>(args)...);
+        return emplace_key(value.first, ::std::move(value.second));
+    }
+    Pair<iterator, bool> insert(const value_type &value) {
+        return emplace_key(value.first, value.second);
+    }
+    Pair<iterator, bool> insert(value_type &&value) {
+        return emplace_key(value.first, ::std::move(value.second));
+    }
+    template <typename M>
+    Pair<iterator, bool> insert_or_assign(const K &key, M &&value) {
+        auto result = emplace_key(key, ::std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = ::std::forward<M>(value);
+        }
+        return result;
+    }
+
+    size_type erase(const K &key) {
+        const auto i = find_index(key, hash_of(key));
+        if (i == NPOS) {
+            return 0;
+        }
+        erase_at(i);
+        return 1;
+    }
+    iterator erase(const_iterator pos) {
+        const auto i = static_cast<size_type>(pos.slot - slots);
+        erase_at(i);
+        return {ctrl + i, ctrl + cap, slots + i};
+    }
+
+    void swap(FlatHashMap &other) noexcept {
+        using ::std::swap;
+        swap(ctrl, other.ctrl);
+        swap(slots, other.slots);
+        swap(cap, other.cap);
+        swap(len, other.len);
+        swap(growth_left, other.growth_left);
+        swap(group_mask, other.group_mask);
+        swap(hash, other.hash);
+        swap(eq, other.eq);
+    }
+
+    friend bool operator==(const FlatHashMap &a, const FlatHashMap &b) {
+        if (a.len != b.len) {
+            return false;
+        }
+        for (const auto &i : a) {
+            const auto it = b.find(i.first);
+            if (it == b.end() || !(it->second == i.second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    friend bool operator!=(const FlatHashMap &a, const FlatHashMap &b) {
+        return !(a == b);
+    }
+
+  private:
+    static constexpr size_type NPOS = ~size_type{0};
+    static constexpr size_type WIDTH = detail::Group::WIDTH;
+
+    // storage unit keeping control bytes aligned for group loads
+    struct alignas(WIDTH) Block {
+        unsigned char bytes[WIDTH]; // NOLINT(modernize-avoid-c-arrays)
+    };
+    static_assert(alignof(value_type) <= alignof(Block),
+                  "over-aligned entries are not supported");
+
+    // 7/8 load factor, always leaving empty slots to end probing
+    static size_type max_load(size_type capacity) {
+        return capacity - capacity / 8;
+    }
+    static size_type blocks(size_type capacity) {
+        return (capacity + capacity * sizeof(value_type) + WIDTH - 1) / WIDTH;
+    }
+
+    // multiplicative fold, so identity hashes of integers still spread
+    // over both the probe start and the 7 bits kept in control bytes
+    ::std::uint64_t hash_of(const K &key) const {
+        const auto h = static_cast<::std::uint64_t>(hash(key));
+        if (detail::IsAvalanching<Hash>::value) {
+            return h;
+        }
+        const auto folded = h * 0x9e3779b97f4a7c15ULL;
+        return folded ^ (folded >> 32U);
+    }
+    static ::std::int8_t h2_of(::std::uint64_t h) {
+        return static_cast<::std::int8_t>(h & 0x7fU);
+    }
+    size_type first_group(::std::uint64_t h) const {
+        return static_cast<size_type>(h >> 7U) & group_mask;
+    }
+
+    iterator iterator_at(size_type i) {
+        return {ctrl + i, ctrl + cap, slots + i};
+    }
+
+    // triangular probing over groups visits each group once
+    size_type find_index(const K &key, ::std::uint64_t h) const {
+        const auto h2 = h2_of(h);
+        auto group = first_group(h);
+        for (size_type step = 1;; ++step) {
+            const detail::Group probe(ctrl + group * WIDTH);
+            for (auto bits = probe.match(h2); bits; bits &= bits - 1) {
+                const auto i = group * WIDTH + detail::trailing_zeros(bits);
+                if (eq(slots[i].first, key)) {
+                    return i;
+                }
+            }
+            if (probe.match_empty()) {
+                return NPOS;
+            }
+            group = (group + step) & group_mask;
+        }
+    }
+
+    size_type find_free(::std::uint64_t h) const {
+        auto group = first_group(h);
+        for (size_type step = 1;; ++step) {
+            const auto bits = detail::Group(ctrl + group * WIDTH).match_free();
+            if (bits) {
+                return group * WIDTH + detail::trailing_zeros(bits);
+            }
+            group = (group + step) & group_mask;
+        }
+    }
+
+    template <typename Key, typename... Args>
+    Pair<iterator, bool> emplace_key(Key &&key, Args &&...args) {
+        const auto h = hash_of(key);
+        auto i = find_index(key, h);
+        if (i != NPOS) {
+            return {iterator_at(i), false};
+        }
+        i = find_free(h);
+        if (growth_left == 0 && ctrl[i] == detail::CTRL_EMPTY) {
+            // mostly tombstones: clean up in place, otherwise double
+            rehash(len * 2 < max_load(cap) ? cap
+                   : cap > 0                ? cap * 2
+                                            : WIDTH);
+            i = find_free(h);
+        }
+        new (slots + i) value_type(
+            ::std::piecewise_construct,
+            ::std::forward_as_tuple(::std::forward<Key>(key)),
+            ::std::forward_as_tuple(::std::forward<Args>(args)...));
+        growth_left -= ctrl[i] == detail::CTRL_EMPTY ? 1 : 0;
+        ctrl[i] = h2_of(h);
+        ++len;
+        return {iterator_at(i), true};
+    }
+
+    void erase_at(size_type i) {
+        slots[i].~value_type();
+        --len;
+        // probing already stops at this group when it has an empty slot
+        if (detail::Group(ctrl + i / WIDTH * WIDTH).match_empty()) {
+            ctrl[i] = detail::CTRL_EMPTY;
+            ++growth_left;
+        } else {
+            ctrl[i] = detail::CTRL_DELETED;
+        }
+    }
+
+    void rehash(size_type capacity) {
+        auto *const old_ctrl = ctrl;
+        auto *const old_slots = slots;
+        const auto old_cap = cap;
+        auto *const block = ::std::allocator<Block>{}.allocate(blocks(capacity));
+        ctrl = reinterpret_cast<::std::int8_t *>(block); // NOLINT
+        slots = reinterpret_cast<value_type *>(ctrl + capacity); // NOLINT
+        cap = capacity;
+        group_mask = capacity / WIDTH - 1;
+        growth_left = max_load(capacity) - len;
+        ::std::memset(ctrl, detail::CTRL_EMPTY, capacity);
+        for (size_type i = 0; i < old_cap; ++i) {
+            if (old_ctrl[i] >= 0) {
+                const auto h = hash_of(old_slots[i].first);
+                const auto j = find_free(h);
+                new (slots + j) value_type(::std::move(old_slots[i]));
+                ctrl[j] = h2_of(h);
+                old_slots[i].~value_type();
+            }
+        }
+        deallocate(old_ctrl, old_cap);
+    }
+
+    void destroy() noexcept {
+        if (!::std::is_trivially_destructible<value_type>::value) {
+            for (size_type i = 0; i < cap; ++i) {
+                if (ctrl[i] >= 0) {
+                    slots[i].~value_type();
+                }
+            }
+        }
+    }
+
+    static void deallocate(::std::int8_t *ctrl, size_type capacity) {
+        if (capacity > 0) {
+            ::std::allocator<Block>{}.deallocate(
+                reinterpret_cast<Block *>(ctrl), // NOLINT
+                blocks(capacity));
+        }
+    }
+
+    ::std::int8_t *ctrl = detail::empty_group();
+    value_type *slots = nullptr;
+    size_type cap = 0;
+    size_type len = 0;
+    size_type growth_left = 0;
+    size_type group_mask = 0;
+    Hash hash;
+    KeyEqual eq;
+};
+
+// @H is a hasher family from hash.hpp or std::hash, define
+// RUSTY_FAST_HASHMAP to back HashMap by FlatHashMap
+#ifdef RUSTY_FAST_HASHMAP
+template <typename K, typename V, template <typename> class H = ::std::hash>
+using HashMap = FlatHashMap<K, V, H<K>>;
+#else
+template <typename K, typename V, template <typename> class H = ::std::hash>
+using HashMap = ::std::unordered_map<K, V, H<K>>;
+#endif
+
+// Vector keeping up to @N elements inline, spilling to the heap beyond.
+// Moving an inline vector moves its elements one by one.
+template <typename T, ::std::size_t N> class SmallVec {
+    static_assert(N > 0, "use Vec without inline storage");
+
+  public:
+    using value_type = T;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using iterator = T *;
+    using const_iterator = const T *;
+    using reverse_iterator = ::std::reverse_iterator<iterator>;
+    using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+
+    SmallVec() noexcept {} // NOLINT(modernize-use-equals-default), no zeroing
+    explicit SmallVec(size_type n) { resize(n); }
+    SmallVec(size_type n, const T &value) { assign(n, value); }
+    template <typename It,
+              typename = numeric_types::enable_if_t<!::std::is_integral<It>::value>>
+    SmallVec(It first, It last) {
+        assign(first, last);
+    }
+    SmallVec(::std::initializer_list<T> list) {
+        assign(list.begin(), list.end());
+    }
+    SmallVec(const SmallVec &other) { assign(other.begin(), other.end()); }
+    SmallVec(SmallVec &&other) noexcept(
+        ::std::is_nothrow_move_constructible<T>::value) {
+        take(other);
+    }
+    SmallVec &operator=(const SmallVec &other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+    SmallVec &operator=(SmallVec &&other) noexcept(
+        ::std::is_nothrow_move_constructible<T>::value) {
+        if (this != &other) {
+            clear();
+            release();
+            take(other);
+        }
+        return *this;
+    }
+    SmallVec &operator=(::std::initializer_list<T> list) {
+        assign(list.begin(), list.end());
+        return *this;
+    }
+    ~SmallVec() {
+        clear();
+        release();
+    }
+
+    template <typename It> void assign(It first, It last) {
+        clear();
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+    void assign(size_type n, const T &value) {
+        clear();
+        reserve(n);
+        for (size_type i = 0; i < n; ++i) {
+            new (ptr + i) T(value);
+            ++len;
+        }
+    }
+
+    iterator begin() noexcept { return ptr; }
+    iterator end() noexcept { return ptr + len; }
+    const_iterator begin() const noexcept { return ptr; }
+    const_iterator end() const noexcept { return ptr + len; }
+    const_iterator cbegin() const noexcept { return ptr; }
+    const_iterator cend() const noexcept { return ptr + len; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    bool empty() const noexcept { return len == 0; }
+    size_type size() const noexcept { return len; }
+    size_type capacity() const noexcept { return cap; }
+    static constexpr size_type inline_capacity() noexcept { return N; }
+    // whether the elements moved to the heap
+    bool spilled() const noexcept { return ptr != inline_data(); }
+
+    T *data() noexcept { return ptr; }
+    const T *data() const noexcept { return ptr; }
+    T &operator[](size_type i) noexcept { return ptr[i]; }
+    const T &operator[](size_type i) const noexcept { return ptr[i]; }
+    T &at(size_type i) {
+        check(i);
+        return ptr[i];
+    }
+    const T &at(size_type i) const {
+        check(i);
+        return ptr[i];
+    }
+    T &front() noexcept { return ptr[0]; }
+    const T &front() const noexcept { return ptr[0]; }
+    T &back() noexcept { return ptr[len - 1]; }
+    const T &back() const noexcept { return ptr[len - 1]; }
+
+    void reserve(size_type n) {
+        if (n > cap) {
+            relocate(n);
+        }
+    }
+    // back to inline storage when the elements fit
+    void shrink_to_fit() {
+        if (spilled() && len < cap) {
+            relocate(len);
+        }
+    }
+
+    void push_back(const T &value) { emplace_back(value); }
+    void push_back(T &&value) { emplace_back(::std::move(value)); }
+    template <typename... Args> T &emplace_back(Args &&...args) {
+        if (len == cap) {
+            // @args may alias an element, construct before relocating
+            T value(::std::forward<Args>(args)...);
+            relocate(cap * 2);
+            new (ptr + len) T(::std::move(value));
+        } else {
+            new (ptr + len) T(::std::forward<Args>(args)...);
+        }
+        return ptr[len++];
+    }
+    void pop_back() noexcept { ptr[--len].~T(); }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args &&...args) {
+        const auto i = static_cast<size_type>(pos - ptr);
+        emplace_back(::std::forward<Args>(args)...);
+        ::std::rotate(ptr + i, ptr + len - 1, ptr + len);
+        return ptr + i;
+    }
+    iterator insert(const_iterator pos, const T &value) {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, T &&value) {
+        return emplace(pos, ::std::move(value));
+    }
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last) {
+        auto *const begin = ptr + (first - ptr);
+        if (first == last) {
+            return begin; // moving onto itself would empty moved-from types
+        }
+        auto *const rest = ::std::move(ptr + (last - ptr), end(), begin);
+        while (end() != rest) {
+            pop_back();
+        }
+        return begin;
+    }
+
+    void resize(size_type n) {
+        reserve(n);
+        while (len < n) {
+            emplace_back();
+        }
+        while (len > n) {
+            pop_back();
+        }
+    }
+    void resize(size_type n, const T &value) {
+        reserve(n);
+        while (len < n) {
+            emplace_back(value);
+        }
+        while (len > n) {
+            pop_back();
+        }
+    }
+    void clear() noexcept {
+        while (len > 0) {
+            pop_back();
+        }
+    }
+
+    void swap(SmallVec &other) noexcept(
+        ::std::is_nothrow_move_constructible<T>::value) {
+        auto tmp = ::std::move(other);
+        other = ::std::move(*this);
+        *this = ::std::move(tmp);
+    }
+
+    friend bool operator==(const SmallVec &a, const SmallVec &b) {
+        return a.len == b.len && ::std::equal(a.begin(), a.end(), b.begin());
+    }
+    friend bool operator!=(const SmallVec &a, const SmallVec &b) {
+        return !(a == b);
+    }
+    friend bool operator<(const SmallVec &a, const SmallVec &b) {
+        return ::std::lexicographical_compare(a.begin(), a.end(), b.begin(),
+                                              b.end());
+    }
+
+  private:
+    T *inline_data() noexcept {
+        return reinterpret_cast<T *>(storage); // NOLINT
+    }
+    const T *inline_data() const noexcept {
+        return reinterpret_cast<const T *>(storage); // NOLINT
+    }
+
+    void check(size_type i) const {
+        if (i >= len) {
+            throw ::std::out_of_range("rusty::collections: index out of range");
+        }
+    }
+
+    // move the elements into inline storage if @n fits, else onto the heap;
+    // a throwing copy leaves the vector unchanged like std::vector
+    void relocate(size_type n) {
+        auto *const next =
+            n <= N ? inline_data() : ::std::allocator<T>{}.allocate(n);
+        auto built = size_type{0};
+        try {
+            for (; built < len; ++built) {
+                new (next + built) T(::std::move_if_noexcept(ptr[built]));
+            }
+        } catch (...) {
+            for (size_type i = 0; i < built; ++i) {
+                next[i].~T();
+            }
+            if (n > N) {
+                ::std::allocator<T>{}.deallocate(next, n);
+            }
+            throw;
+        }
+        for (size_type i = 0; i < len; ++i) {
+            ptr[i].~T();
+        }
+        release();
+        ptr = next;
+        cap = n <= N ? N : n;
+    }
+
+    void release() noexcept {
+        if (spilled()) {
+            ::std::allocator<T>{}.deallocate(ptr, cap);
+        }
+        ptr = inline_data();
+        cap = N;
+    }
+
+    // steal the heap buffer of @other or move its inline elements
+    void take(SmallVec &other) {
+        if (other.spilled()) {
+            ptr = other.ptr;
+            cap = other.cap;
+            len = other.len;
+            other.ptr = other.inline_data();
+            other.cap = N;
+            other.len = 0;
+        } else {
+            for (size_type i = 0; i < other.len; ++i) {
+                new (ptr + i) T(::std::move(other.ptr[i]));
+            }
+            len = other.len;
+            other.clear();
+        }
+    }
+
+    alignas(T) unsigned char storage[N * sizeof(T)]; // NOLINT
+    T *ptr = inline_data();
+    size_type len = 0;
+    size_type cap = N;
+};
+
+// Borrowed view of contiguous elements like rust &[T], const T for a
+// read only one
+template <typename T> class Slice {
+  public:
+    using value_type = typename ::std::remove_const<T>::type;
+    using size_type = ::std::size_t;
+    using iterator = T *;
+    using const_iterator = T *;
+
+    constexpr Slice() noexcept = default;
+    constexpr Slice(T *data, size_type len) noexcept : ptr(data), len(len) {}
+
+    constexpr T *data() const noexcept { return ptr; }
+    constexpr size_type size() const noexcept { return len; }
+    constexpr bool empty() const noexcept { return len == 0; }
+    constexpr T &operator[](size_type i) const noexcept { return ptr[i]; }
+    constexpr T *begin() const noexcept { return ptr; }
+    constexpr T *end() const noexcept { return ptr + len; }
+
+  private:
+    T *ptr = nullptr;
+    size_type len = 0;
+};
+
+// Columnar binary serialization of Number<T> collections through the io
+// readers and writers. A column is a 16 byte header (magic "RCOL", endian
+// tag, element kind and size, little-endian u64 count) followed by the
+// elements as one block padded to 16 bytes, written little-endian (byte
+// swapped on big-endian hosts). A map is its keys column then its values
+// column. Columns saved from a 16 byte aligned offset stay aligned, so a
+// mmap region is read in place by view(). Malformed input throws
+// ::std::invalid_argument, truncated input ::std::out_of_range.
+namespace detail {
+
+constexpr ::std::size_t COLUMN_ALIGN = 16;
+constexpr ::std::uint8_t COLUMN_MAGIC[4] = {'R', 'C', 'O', 'L'};
+
+template <typename N> struct ColumnKind {
+    using T = typename numeric_types::detail::ValueOf<N>::Type;
+    static_assert(!::std::is_same<T, N>::value,
+                  "columns hold Number<T> only!");
+    static constexpr ::std::uint8_t value =
+        ::std::is_floating_point<T>::value            ? 'f'
+        : numeric_types::detail::IsSigned<T>::value ? 'i'
+                                                      : 'u';
+};
+
+inline ::std::size_t column_padding(::std::size_t bytes) noexcept {
+    return (COLUMN_ALIGN - bytes % COLUMN_ALIGN) % COLUMN_ALIGN;
+}
+
+template <typename N, typename W>
+void write_column_header(W &writer, ::std::size_t count) {
+    const ::std::uint8_t head[8] = {COLUMN_MAGIC[0], COLUMN_MAGIC[1],
+                                    COLUMN_MAGIC[2], COLUMN_MAGIC[3],
+                                    0, // little-endian
+                                    ColumnKind<N>::value,
+                                    static_cast<::std::uint8_t>(sizeof(N)),
+                                    0};
+    writer.write_bytes(head, sizeof(head));
+    writer.template write<numeric_types::u64, false>(
+        static_cast<numeric_types::u64>(count));
+}
+
+template <typename W> void write_column_padding(W &writer, ::std::size_t bytes) {
+    const ::std::uint8_t zeros[COLUMN_ALIGN] = {};
+    writer.write_bytes(zeros, column_padding(bytes));
+}
+
+template <typename N, typename W>
+void write_column(W &writer, const N *data, ::std::size_t count) {
+    write_column_header<N>(writer, count);
+    writer.template write_from<N, false>(data, count);
+    write_column_padding(writer, count * sizeof(N));
+}
+
+// column of any iterable, gathered through a bounded chunk
+template <typename N, typename W, typename C, typename Get>
+void write_column(W &writer, const C &container, Get get) {
+    write_column_header<N>(writer, container.size());
+    constexpr ::std::size_t chunk = 4096 / sizeof(N);
+    N buffer[chunk]; // NOLINT
+    auto n = ::std::size_t{0};
+    for (const auto &item : container) {
+        buffer[n++] = get(item);
+        if (n == chunk) {
+            writer.template write_from<N, false>(buffer, n);
+            n = 0;
+        }
+    }
+    writer.template write_from<N, false>(buffer, n);
+    write_column_padding(writer, container.size() * sizeof(N));
+}
+
+struct ColumnHeader {
+    bool big_endian;
+    ::std::size_t count;
+};
+
+// readers over memory know how much input is left, streams do not
+template <typename R, typename = void>
+struct HasRemaining : ::std::false_type {};
+template <typename R>
+struct HasRemaining<R, decltype(void(::std::declval<const R &>().remaining()))>
+    : ::std::true_type {};
+
+template <typename N, typename R>
+numeric_types::enable_if_t<HasRemaining<R>::value>
+check_column_fits(const R &reader, ::std::uint64_t count) {
+    if (count > reader.remaining() / sizeof(N)) {
+        throw ::std::out_of_range("rusty::io: unexpected end of input");
+    }
+}
+template <typename N, typename R>
+numeric_types::enable_if_t<!HasRemaining<R>::value>
+check_column_fits(const R & /*reader*/, ::std::uint64_t /*count*/) {}
+
+template <typename N, typename R> ColumnHeader read_column_header(R &reader) {
+    ::std::uint8_t head[8]; // NOLINT
+    reader.read_exact(head, sizeof(head));
+    if (::std::memcmp(head, COLUMN_MAGIC, sizeof(COLUMN_MAGIC)) != 0 ||
+        head[4] > 1) {
+        throw ::std::invalid_argument("rusty::collections: not a column");
+    }
+    if (head[5] != ColumnKind<N>::value || head[6] != sizeof(N)) {
+        throw ::std::invalid_argument(
+            "rusty::collections: column of another element type");
+    }
+    // never trusted before a multiply, resize or take
+    const auto count = reader.template read<numeric_types::u64, false>().value;
+    if (count > SIZE_MAX / sizeof(N)) {
+        throw ::std::invalid_argument("rusty::collections: column too long");
+    }
+    check_column_fits<N>(reader, count);
+    return {head[4] == 1, static_cast<::std::size_t>(count)};
+}
+
+template <typename R> void read_column_padding(R &reader, ::std::size_t bytes) {
+    ::std::uint8_t padding[COLUMN_ALIGN]; // NOLINT
+    reader.read_exact(padding, column_padding(bytes));
+}
+
+template <typename N, typename R>
+void read_column_elements(R &reader, bool big_endian, N *out,
+                          ::std::size_t count) {
+    if (big_endian) {
+        reader.template read_into<N, true>(out, count);
+    } else {
+        reader.template read_into<N, false>(out, count);
+    }
+}
+
+template <typename N, typename R>
+void read_column_body(R &reader, const ColumnHeader &header, N *out) {
+    read_column_elements(reader, header.big_endian, out, header.count);
+    read_column_padding(reader, header.count * sizeof(N));
+}
+
+// a checked count is allocated at once, a streamed one grows with the
+// input so a corrupt count ends in out_of_range rather than a huge
+// allocation
+template <typename N, typename A, typename R>
+void read_column_body(R &reader, const ColumnHeader &header,
+                      ::std::vector<N, A> &out) {
+    constexpr ::std::size_t chunk = (1 << 20) / sizeof(N);
+    out.clear();
+    if (HasRemaining<R>::value) {
+        out.reserve(header.count);
+    }
+    for (auto done = ::std::size_t{0}; done < header.count;) {
+        const auto n = ::std::min(header.count - done, chunk);
+        out.resize(done + n);
+        read_column_elements(reader, header.big_endian, out.data() + done, n);
+        done += n;
+    }
+    read_column_padding(reader, header.count * sizeof(N));
+}
+
+template <typename N, typename R> Vec<N> read_column(R &reader) {
+    const auto header = read_column_header<N>(reader);
+    auto out = Vec<N>{};
+    read_column_body(reader, header, out);
+    return out;
+}
+
+template <typename M, typename R> void read_map(R &reader, M &map) {
+    using K = typename M::key_type;
+    using V = typename M::mapped_type;
+    const auto keys = read_column<K>(reader);
+    const auto values = read_column<V>(reader);
+    if (keys.size() != values.size()) {
+        throw ::std::invalid_argument(
+            "rusty::collections: key and value columns differ in length");
+    }
+    map.clear();
+    map.reserve(keys.size());
+    for (::std::size_t i = 0; i < keys.size(); ++i) {
+        map.emplace(keys[i], values[i]);
+    }
+}
+
+} // namespace detail
+
+template <typename W, typename N, typename A>
+void save(W &writer, const ::std::vector<N, A> &vec) {
+    detail::write_column(writer, vec.data(), vec.size());
+}
+template <typename W, typename N, ::std::size_t L>
+void save(W &writer, const Array<N, L> &array) {
+    detail::write_column(writer, array.data(), L);
+}
+template <typename W, typename N> void save(W &writer, const Slice<N> &slice) {
+    detail::write_column(writer, slice.data(), slice.size());
+}
+template <typename W, typename K, typename V, typename... Ts>
+void save(W &writer, const ::std::unordered_map<K, V, Ts...> &map) {
+    using E = Pair<const K, V>;
+    detail::write_column<K>(writer, map, [](const E &e) { return e.first; });
+    detail::write_column<V>(writer, map, [](const E &e) { return e.second; });
+}
+template <typename W, typename K, typename V, typename... Ts>
+void save(W &writer, const FlatHashMap<K, V, Ts...> &map) {
+    using E = Pair<const K, V>;
+    detail::write_column<K>(writer, map, [](const E &e) { return e.first; });
+    detail::write_column<V>(writer, map, [](const E &e) { return e.second; });
+}
+
+template <typename R, typename N, typename A>
+void load(R &reader, ::std::vector<N, A> &vec) {
+    const auto header = detail::read_column_header<N>(reader);
+    detail::read_column_body(reader, header, vec);
+}
+template <typename R, typename N, ::std::size_t L>
+void load(R &reader, Array<N, L> &array) {
+    const auto header = detail::read_column_header<N>(reader);
+    if (header.count != L) {
+        throw ::std::invalid_argument(
+            "rusty::collections: column length differs from the array");
+    }
+    detail::read_column_body(reader, header, array.data());
+}
+template <typename R, typename K, typename V, typename... Ts>
+void load(R &reader, ::std::unordered_map<K, V, Ts...> &map) {
+    detail::read_map(reader, map);
+}
+template <typename R, typename K, typename V, typename... Ts>
+void load(R &reader, FlatHashMap<K, V, Ts...> &map) {
+    detail::read_map(reader, map);
+}
+// e.g. `auto v = load<Vec<u32>>(reader);`
+template <typename C, typename R> C load(R &reader) {
+    C container;
+    load(reader, container);
+    return container;
+}
+
+// Zero-copy column of @reader over borrowed memory like io::ByteReader,
+// pointing into it. Throws ::std::invalid_argument when the column is
+// foreign endian or misaligned, with @reader back at the column so load()
+// can copy it instead.
+template <typename N, typename R> Slice<const N> view(R &reader) {
+    const auto start = reader.position();
+    const auto header = detail::read_column_header<N>(reader);
+    const auto *data = reader.data() + reader.position();
+    if (header.big_endian != N::is_be ||
+        reinterpret_cast<::std::uintptr_t>(data) % alignof(N) != 0) { // NOLINT
+        reader.seek(start);
+        throw ::std::invalid_argument(
+            "rusty::collections: column not viewable in place");
+    }
+    const auto bytes = header.count * sizeof(N);
+    reader.take(bytes);
+    reader.take(detail::column_padding(bytes));
+    return {reinterpret_cast<const N *>(data), header.count}; // NOLINT
+}
+// keys and values columns of a saved map, @reader back at the keys when
+// either column is not viewable
+template <typename K, typename V, typename R>
+Pair<Slice<const K>, Slice<const V>> view_map(R &reader) {
+    const auto start = reader.position();
+    auto keys = view<K>(reader);
+    auto values = Slice<const V>{};
+    try {
+        values = view<V>(reader);
+    } catch (const ::std::invalid_argument &) {
+        reader.seek(start);
+        throw;
+    }
+    if (keys.size() != values.size()) {
+        throw ::std::invalid_argument(
+            "rusty::collections: key and value columns differ in length");
+    }
+    return {keys, values};
+}
+
+namespace ostream {
+
+// quoting view, writes without building a temporary string
+struct Quoted {
+    const ::std::string &s;
+
+    friend ::std::ostream &operator<<(::std::ostream &s, const Quoted &q) {
+        return s << '"' << q.s << '"';
+    }
+};
+
+inline Quoted prepare(const ::std::string &s) { return Quoted{s}; }
+inline ::std::int32_t prepare(const ::std::int8_t &t) { return t; }
+inline ::std::int32_t prepare(const ::std::uint8_t &t) { return t; }
+template <typename T> inline const T &prepare(const T &t) { return t; }
+
+#ifndef RUSTY_OSTREAM_MAX_ITEMS
+#define RUSTY_OSTREAM_MAX_ITEMS 0 // elements per container, 0 for no limit
+#endif
+#ifndef RUSTY_OSTREAM_MAX_BYTES
+#define RUSTY_OSTREAM_MAX_BYTES 0 // bytes per printing, 0 for no limit
+#endif
+
+// stream local limits, set by `s << max_items(n)` and `s << max_bytes(n)`
+inline int max_items_index() {
+    static const int index = ::std::ios_base::xalloc();
+    return index;
+}
+inline int max_bytes_index() {
+    static const int index = ::std::ios_base::xalloc();
+    return index;
+}
+
+#define LIMIT_IMPL(NAME, DEFAULT)                                              \
+    struct NAME##_manipulator {                                                \
+        ::std::size_t n;                                                       \
+        friend ::std::ostream &operator<<(::std::ostream &s,                   \
+                                          const NAME##_manipulator &m) {       \
+            s.iword(NAME##_index()) = static_cast<long>(m.n); /* NOLINT */     \
+            return s;                                                          \
+        }                                                                      \
+    };                                                                         \
+    inline NAME##_manipulator NAME(::std::size_t n) {                          \
+        return NAME##_manipulator{n};                                          \
+    }                                                                          \
+    inline ::std::size_t NAME##_of(::std::ostream &s) {                        \
+        const auto n = s.iword(NAME##_index());                                \
+        return n ? static_cast<::std::size_t>(n) : (DEFAULT);                  \
+    }
+
+LIMIT_IMPL(max_items, RUSTY_OSTREAM_MAX_ITEMS)
+LIMIT_IMPL(max_bytes, RUSTY_OSTREAM_MAX_BYTES)
+
+#undef LIMIT_IMPL
+
+// Formats into a thread local growable buffer reused across printings and
+// hands it to the stream buffer in large chunks, under one sentry. Numbers
+// are formatted without the stream unless its flags or locale ask for more
+// than plain output.
+class Printer {
+  public:
+    static constexpr ::std::size_t CHUNK = 1 << 16;
+
+    explicit Printer(::std::ostream &s)
+        : s(s), sentry(s), buffer(thread_buffer()), start(buffer.size()),
+          items(max_items_of(s)), bytes(max_bytes_of(s)) {
+        const auto flags = s.flags();
+        const auto base = flags & ::std::ios_base::basefield;
+        plain_int = s.width() == 0 &&
+                    (base == ::std::ios_base::dec || base == 0) &&
+                    !(flags & ::std::ios_base::showpos) &&
+                    numeric_types::detail::is_plain_locale(s.getloc());
+        plain_float = plain_int &&
+                      !(flags & (::std::ios_base::floatfield |
+                                 ::std::ios_base::showpoint |
+                                 ::std::ios_base::uppercase));
+    }
+    Printer(const Printer &) = delete;
+    Printer &operator=(const Printer &) = delete;
+    // printing ends with flush(), here only when unwinding; the sentry
+    // honors unitbuf afterwards
+    ~Printer() {
+        try {
+            flush();
+        } catch (...) { // NOLINT(bugprone-empty-catch), badbit is set
+        }
+    }
+
+    // output that does not reach the stream buffer sets badbit
+    void flush() {
+        const auto n = static_cast<::std::streamsize>(buffer.size());
+        const auto ok = n == 0 || (sentry && s.good() &&
+                                   s.rdbuf()->sputn(buffer.data(), n) == n);
+        written += buffer.size() - start;
+        buffer.clear();
+        start = 0;
+        if (!ok) {
+            s.setstate(::std::ios_base::badbit);
+        }
+    }
+
+    void append(const char *str, ::std::size_t n) {
+        buffer.append(str, n);
+        if (buffer.size() >= CHUNK) {
+            flush();
+        }
+    }
+    void append(char c) { append(&c, 1); }
+
+    void append(const ::std::string &str) {
+        append('"');
+        append(str.data(), str.size());
+        append('"');
+    }
+
+    void append(bool value) { stream(value); }
+
+    template <typename T>
+    numeric_types::enable_if_t<numeric_types::detail::IsInteger<T>::value &&
+                               !::std::is_same<T, bool>::value>
+    append(T value) {
+        if (plain_int) {
+            char digits[numeric_types::detail::MAX_FORMAT_CHARS]; // NOLINT
+            append(digits, static_cast<::std::size_t>(
+                               numeric_types::detail::write_number(
+                                   digits, value) -
+                               digits));
+        } else {
+            stream(numeric_types::Number<T>{value});
+        }
+    }
+
+    template <typename T>
+    numeric_types::enable_if_t<::std::is_floating_point<T>::value>
+    append(T value) {
+        if (plain_float) {
+            char digits[64]; // NOLINT(modernize-avoid-c-arrays)
+            const auto n = ::std::snprintf(digits, sizeof(digits), "%.*g",
+                                           static_cast<int>(s.precision()),
+                                           static_cast<double>(value));
+            append(digits, static_cast<::std::size_t>(n));
+        } else {
+            stream(value);
+        }
+    }
+
+    template <typename T> void append(const numeric_types::Number<T> &n) {
+        append(n.value);
+    }
+
+    template <typename T1, typename T2> void append(const Pair<T1, T2> &p) {
+        append('(');
+        append(p.first);
+        append(", ", 2);
+        append(p.second);
+        append(')');
+    }
+
+    template <typename T, ::std::size_t N> void append(const Array<T, N> &c) {
+        sequence(c);
+    }
+    template <typename T, typename A>
+    void append(const ::std::vector<T, A> &c) {
+        sequence(c);
+    }
+    template <typename T, ::std::size_t N>
+    void append(const SmallVec<T, N> &c) {
+        sequence(c);
+    }
+    template <typename K, typename V, typename H, typename E, typename A>
+    void append(const ::std::unordered_map<K, V, H, E, A> &c) {
+        sequence(c);
+    }
+    template <typename K, typename V, typename H, typename E>
+    void append(const FlatHashMap<K, V, H, E> &c) {
+        sequence(c);
+    }
+    template <typename T> void append(const Slice<T> &c) { sequence(c); }
+    template <typename N, bool B>
+    void append(const numeric_types::EndianSlice<N, B> &c) {
+        sequence(c);
+    }
+
+    // anything else goes through its own operator<<
+    template <typename T>
+    numeric_types::enable_if_t<!::std::is_arithmetic<T>::value &&
+                               !numeric_types::detail::IsInteger<T>::value>
+    append(const T &value) {
+        stream(value);
+    }
+
+  private:
+    static ::std::string &thread_buffer() {
+        thread_local ::std::string buffer;
+        return buffer;
+    }
+
+    ::std::size_t printed() const { return written + buffer.size() - start; }
+
+    template <typename T> void stream(const T &value) {
+        flush();
+        s << value;
+    }
+
+    template <typename C> void sequence(const C &c) {
+        append('[');
+        ::std::size_t count = 0;
+        for (const auto &i : c) {
+            if (truncated || (items && count == items) ||
+                (bytes && printed() >= bytes)) {
+                append(count ? ", ..." : "...", count ? 5 : 3);
+                truncated = true;
+                break;
+            }
+            if (count++ > 0) {
+                append(", ", 2);
+            }
+            append(i);
+        }
+        append(']');
+    }
+
+    ::std::ostream &s;
+    const ::std::ostream::sentry sentry;
+    ::std::string &buffer;
+    ::std::size_t start; // bytes owned by an enclosing printer
+    ::std::size_t items;
+    ::std::size_t bytes;
+    ::std::size_t written = 0;
+    bool plain_int = false;
+    bool plain_float = false;
+    bool truncated = false;
+};
+
+template <typename T1, typename T2>
+::std::ostream &operator<<(::std::ostream &s, const Pair<T1, T2> &p) {
+    Printer printer{s};
+    printer.append(p);
+    printer.flush();
+    return s;
+}
+
+#define OSTREAM_IMPL(T1, T2)                                                   \
+    template <T1>::std::ostream &operator<<(::std::ostream &s, const T2 &c) {  \
+        Printer printer{s};                                                    \
+        printer.append(c);                                                     \
+        printer.flush();                                                       \
+        return s;                                                              \
+    }
+
+#define COMMA ,
+
+OSTREAM_IMPL(typename T COMMA ::std::size_t size, Array<T COMMA size>)
+OSTREAM_IMPL(typename T COMMA typename A, ::std::vector<T COMMA A>)
+OSTREAM_IMPL(typename T COMMA ::std::size_t N, SmallVec<T COMMA N>)
+OSTREAM_IMPL(typename T, Slice<T>)
+OSTREAM_IMPL(typename K COMMA typename V COMMA typename H COMMA typename E
+                 COMMA typename A,
+             ::std::unordered_map<K COMMA V COMMA H COMMA E COMMA A>)
+OSTREAM_IMPL(typename K COMMA typename V COMMA typename H COMMA typename E,
+             FlatHashMap<K COMMA V COMMA H COMMA E>)
+OSTREAM_IMPL(typename N COMMA bool B,
+             ::rusty::numeric_types::EndianSlice<N COMMA B>)
+
+#undef COMMA
+#undef OSTREAM_IMPL
+
+} // namespace ostream
+
+} // namespace rusty::collections
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+// dbg_level(n, ...) prints only when n <= RUSTY_DBG_LEVEL, dbg is level 1,
+// 0 turns every dbg into its bare expression at preprocessing time
+#ifndef RUSTY_DBG_LEVEL
+#define RUSTY_DBG_LEVEL 1
+#endif
+
+// records per second per call site, 0 for no limit
+#ifndef RUSTY_DBG_RATE_LIMIT
+#define RUSTY_DBG_RATE_LIMIT 0
+#endif
+
+// define RUSTY_DBG_THREAD_ID and/or RUSTY_DBG_TIMESTAMP to tag records with
+// a small sequential thread id and seconds since the first record
+
+// define RUSTY_DBG_ASYNC to hand records to a background thread draining
+// every RUSTY_DBG_ASYNC_INTERVAL_MS, and at exit
+#ifndef RUSTY_DBG_ASYNC_INTERVAL_MS
+#define RUSTY_DBG_ASYNC_INTERVAL_MS 50
+#endif
+
+// define RUSTY_DBG_METRICS to turn on dbg_time, dbg_count and dbg_hist,
+// recorded per thread and written as JSON lines at exit (unless
+// RUSTY_DBG_METRICS_AT_EXIT is 0) or by dump_metrics(). Call sites past
+// RUSTY_DBG_METRICS_MAX_SITES are ignored. Timings use the TSC on x86
+// unless RUSTY_DBG_METRICS_STEADY_CLOCK is defined.
+#ifndef RUSTY_DBG_METRICS_AT_EXIT
+#define RUSTY_DBG_METRICS_AT_EXIT 1
+#endif
+#ifndef RUSTY_DBG_METRICS_MAX_SITES
+#define RUSTY_DBG_METRICS_MAX_SITES 1024
+#endif
+#if (defined(__x86_64__) || defined(__i386__)) &&                              \
+    (defined(__GNUC__) || defined(__clang__)) &&                               \
+    !defined(RUSTY_DBG_METRICS_STEADY_CLOCK)
+#define RUSTY_DBG_METRICS_HAS_TSC
+#endif
+
+namespace rusty::debug {
+
+// streambuf appending to a reusable string
+class StringBuf : public ::std::streambuf {
+  public:
+    ::std::string buffer;
+
+  protected:
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            buffer.push_back(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+    ::std::streamsize xsputn(const char *s, ::std::streamsize n) override {
+        buffer.append(s, static_cast<::std::size_t>(n));
+        return n;
+    }
+};
+
+// a whole record in one write syscall, so concurrent records never tear
+inline void emit(const char *data, ::std::size_t n) {
+#if defined(__unix__) || defined(__APPLE__)
+    while (n > 0) {
+        const auto r = ::write(STDERR_FILENO, data, n);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data += r;
+        n -= static_cast<::std::size_t>(r);
+    }
+#else
+    ::std::fwrite(data, 1, n, stderr);
+#endif
+}
+
+#ifdef RUSTY_DBG_ASYNC
+class AsyncSink {
+  public:
+    struct Pending {
+        ::std::mutex mutex;
+        ::std::string data;
+    };
+
+    static AsyncSink &instance() {
+        static AsyncSink sink;
+        return sink;
+    }
+
+    AsyncSink(const AsyncSink &) = delete;
+    AsyncSink &operator=(const AsyncSink &) = delete;
+    ~AsyncSink() {
+        {
+            const ::std::lock_guard<::std::mutex> lock(mutex);
+            stop = true;
+        }
+        cv.notify_one();
+        worker.join();
+        drain();
+    }
+
+    ::std::shared_ptr<Pending> attach() {
+        auto pending = ::std::make_shared<Pending>();
+        const ::std::lock_guard<::std::mutex> lock(mutex);
+        pendings.push_back(pending);
+        return pending;
+    }
+
+    void notify() { cv.notify_one(); }
+
+    // write out everything pending of every thread, in one go
+    void drain() {
+        auto snapshot = ::std::vector<::std::shared_ptr<Pending>>{};
+        {
+            const ::std::lock_guard<::std::mutex> lock(mutex);
+            snapshot = pendings;
+        }
+        auto out = ::std::string{};
+        for (const auto &pending : snapshot) {
+            const ::std::lock_guard<::std::mutex> lock(pending->mutex);
+            out.append(pending->data);
+            pending->data.clear();
+        }
+        if (!out.empty()) {
+            emit(out.data(), out.size());
+        }
+        // buffers of exited threads are only referenced here now
+        const ::std::lock_guard<::std::mutex> lock(mutex);
+        for (auto it = pendings.begin(); it != pendings.end();) {
+            it = it->use_count() == 1 && (*it)->data.empty()
+                     ? pendings.erase(it)
+                     : it + 1;
+        }
+    }
+
+  private:
+    AsyncSink() : worker([this] { run(); }) {}
+
+    void run() {
+        auto lock = ::std::unique_lock<::std::mutex>(mutex);
+        while (!stop) {
+            cv.wait_for(lock, ::std::chrono::milliseconds(
+                                  RUSTY_DBG_ASYNC_INTERVAL_MS));
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+    }
+
+    ::std::mutex mutex;
+    ::std::condition_variable cv;
+    ::std::vector<::std::shared_ptr<Pending>> pendings;
+    bool stop = false;
+    ::std::thread worker; // last, started once everything else is ready
+};
+#endif
+
+// per thread formatting state, records never touch a shared stream
+struct ThreadState {
+    static unsigned next_id() {
+        static ::std::atomic<unsigned> id{0};
+        return id.fetch_add(1, ::std::memory_order_relaxed);
+    }
+
+    unsigned id = next_id();
+    StringBuf buf;
+    ::std::ostream stream{&buf};
+    ::std::ostream pristine{nullptr}; // default format to restore from
+#ifdef RUSTY_DBG_ASYNC
+    ::std::shared_ptr<AsyncSink::Pending> pending =
+        AsyncSink::instance().attach();
+#endif
+};
+
+inline ThreadState &thread_state() {
+    thread_local ThreadState state;
+    return state;
+}
+
+// per call site limit of records per second
+class RateLimit {
+  public:
+    bool allow(unsigned per_second) noexcept {
+        if (per_second == 0) {
+            return true;
+        }
+        const auto now = ::std::chrono::duration_cast<::std::chrono::seconds>(
+                             ::std::chrono::steady_clock::now()
+                                 .time_since_epoch())
+                             .count();
+        auto current = window.load(::std::memory_order_relaxed);
+        if (current != now &&
+            window.compare_exchange_strong(current, now,
+                                           ::std::memory_order_relaxed)) {
+            count.store(0, ::std::memory_order_relaxed);
+        }
+        if (count.fetch_add(1, ::std::memory_order_relaxed) < per_second) {
+            return true;
+        }
+        dropped.fetch_add(1, ::std::memory_order_relaxed);
+        return false;
+    }
+
+    // records dropped since the last call
+    unsigned long long take_suppressed() noexcept {
+        return dropped.exchange(0, ::std::memory_order_relaxed);
+    }
+
+  private:
+    ::std::atomic<long long> window{-1};
+    ::std::atomic<unsigned> count{0};
+    ::std::atomic<unsigned long long> dropped{0};
+};
+
+inline ::std::ostream &begin_record(const char *file, int line,
+                                    const char *expr,
+                                    unsigned long long suppressed) {
+    auto &state = thread_state();
+    state.buf.buffer.clear();
+    state.stream << '[' << file << ':' << line;
+#ifdef RUSTY_DBG_THREAD_ID
+    state.stream << " T" << state.id;
+#endif
+#ifdef RUSTY_DBG_TIMESTAMP
+    static const auto start = ::std::chrono::steady_clock::now();
+    const auto elapsed =
+        ::std::chrono::duration_cast<::std::chrono::microseconds>(
+            ::std::chrono::steady_clock::now() - start)
+            .count();
+    const auto fill = state.stream.fill('0');
+    state.stream << " +" << elapsed / 1000000 << '.' << ::std::setw(6)
+                 << elapsed % 1000000 << 's';
+    state.stream.fill(fill);
+#endif
+    state.stream << "] ";
+    if (suppressed > 0) {
+        state.stream << '(' << suppressed << " suppressed) ";
+    }
+    state.stream << expr << " = ";
+    return state.stream;
+}
+
+// @formatted tells whether the record changed the stream format
+inline void end_record(bool formatted) {
+    auto &state = thread_state();
+    state.buf.buffer.push_back('\n');
+    if (formatted) {
+        state.stream.copyfmt(state.pristine);
+    }
+#ifdef RUSTY_DBG_ASYNC
+    auto &pending = *state.pending;
+    auto size = ::std::size_t{0};
+    {
+        const ::std::lock_guard<::std::mutex> lock(pending.mutex);
+        pending.data.append(state.buf.buffer);
+        size = pending.data.size();
+    }
+    if (size >= (1U << 16)) {
+        AsyncSink::instance().notify();
+    }
+#else
+    emit(state.buf.buffer.data(), state.buf.buffer.size());
+#endif
+}
+
+// backend of the dbg macro: when @enabled and the rate limit of @site
+// allows, records @value after @manipulate applied the stream format, then
+// hands @value back, lvalues by reference and rvalues moved into the result
+template <typename Site, typename Manipulate, typename T>
+T forward_record(bool enabled, Site site, unsigned rate_limit,
+                 const char *file, int line, const char *expr,
+                 bool formatted, Manipulate manipulate, T &&value) {
+    // printers of std containers, which argument dependent lookup misses
+    using namespace ::rusty::collections::ostream; // NOLINT
+    if (enabled) {
+        auto &limit = site();
+        if (limit.allow(rate_limit)) {
+            manipulate(begin_record(file, line, expr, limit.take_suppressed()))
+                << value;
+            end_record(formatted);
+        }
+    }
+    return static_cast<T &&>(value);
+}
+
+// write out pending records now, a no-op unless RUSTY_DBG_ASYNC
+inline void flush() {
+#ifdef RUSTY_DBG_ASYNC
+    AsyncSink::instance().drain();
+#endif
+}
+
+enum class MetricKind {
+    Count,
+    Time,
+    Hist,
+};
+
+inline const char *to_str(MetricKind kind) noexcept {
+    switch (kind) {
+    case MetricKind::Count:
+        return "count";
+    case MetricKind::Time:
+        return "time";
+    case MetricKind::Hist:
+        return "hist";
+    }
+    return "";
+}
+
+// clock of dbg_time, TSC ticks or steady_clock nanoseconds
+inline ::std::uint64_t ticks() noexcept {
+#ifdef RUSTY_DBG_METRICS_HAS_TSC
+    return __builtin_ia32_rdtsc();
+#else
+    return static_cast<::std::uint64_t>(
+        ::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+            ::std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+#endif
+}
+
+// HDR style log-linear buckets: exact below 2 ** SUB_BITS, then 2 **
+// (SUB_BITS - 1) buckets per power of two, so a bucket spans at most 1/16
+// of its values
+struct HistBuckets {
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr ::std::size_t COUNT =
+        (64 - SUB_BITS) * (::std::size_t{1} << (SUB_BITS - 1)) +
+        (::std::size_t{1} << SUB_BITS);
+
+    static ::std::size_t index(::std::uint64_t value) noexcept {
+        if (value < (::std::uint64_t{1} << SUB_BITS)) {
+            return static_cast<::std::size_t>(value);
+        }
+        const auto shift =
+            63 - numeric_types::detail::clz64(value) - SUB_BITS + 1;
+        return (static_cast<::std::size_t>(shift) << (SUB_BITS - 1)) +
+               static_cast<::std::size_t>(value >> shift);
+    }
+    // smallest value of bucket @i
+    static ::std::uint64_t lower(::std::size_t i) noexcept {
+        if (i < (::std::size_t{1} << SUB_BITS)) {
+            return i;
+        }
+        const auto shift = (i >> (SUB_BITS - 1)) - 1;
+        return static_cast<::std::uint64_t>(i - (shift << (SUB_BITS - 1)))
+               << shift;
+    }
+};
+
+// Metrics of one call site in one thread. Only the owning thread writes,
+// with plain load and store, dump_metrics reads concurrently.
+struct MetricSlot {
+    explicit MetricSlot(MetricKind kind)
+        : buckets(kind == MetricKind::Count
+                      ? nullptr
+                      : new ::std::atomic<::std::uint64_t>[HistBuckets::COUNT]()) {}
+
+    static void add(::std::atomic<::std::uint64_t> &a,
+                    ::std::uint64_t n) noexcept {
+        a.store(a.load(::std::memory_order_relaxed) + n,
+                ::std::memory_order_relaxed);
+    }
+
+    void count(::std::uint64_t n) noexcept { add(total, n); }
+    void record(::std::uint64_t value) noexcept {
+        add(total, 1);
+        add(sum, value);
+        if (value < min.load(::std::memory_order_relaxed)) {
+            min.store(value, ::std::memory_order_relaxed);
+        }
+        if (value > max.load(::std::memory_order_relaxed)) {
+            max.store(value, ::std::memory_order_relaxed);
+        }
+        add(buckets[HistBuckets::index(value)], 1);
+    }
+
+    ::std::atomic<::std::uint64_t> total{0};
+    ::std::atomic<::std::uint64_t> sum{0};
+    ::std::atomic<::std::uint64_t> min{~::std::uint64_t{0}};
+    ::std::atomic<::std::uint64_t> max{0};
+    ::std::unique_ptr<::std::atomic<::std::uint64_t>[]> buckets;
+};
+
+// slots of every call site used by a thread, kept after the thread exits
+// and handed to the next new thread
+struct MetricShard {
+    ::std::atomic<MetricSlot *> slots[RUSTY_DBG_METRICS_MAX_SITES] = {};
+    ::std::vector<::std::unique_ptr<MetricSlot>> owned;
+};
+
+// Never destroyed: threads of other statics (e.g. ThreadPool::global)
+// may still record and release their shards while statics are destroyed.
+class MetricRegistry {
+  public:
+    static MetricRegistry &instance() {
+        static auto *registry = new MetricRegistry(); // NOLINT
+        static const ExitDump exit_dump;
+        return *registry;
+    }
+
+    MetricRegistry(const MetricRegistry &) = delete;
+    MetricRegistry &operator=(const MetricRegistry &) = delete;
+
+    // index of a new call site, RUSTY_DBG_METRICS_MAX_SITES once full
+    ::std::size_t add_site(const char *name, MetricKind kind, const char *file,
+                           int line) {
+        const ::std::lock_guard<::std::mutex> lock(mutex);
+        if (sites.size() == RUSTY_DBG_METRICS_MAX_SITES) {
+            return RUSTY_DBG_METRICS_MAX_SITES;
+        }
+        sites.push_back(Site{name, kind, file, line});
+        return sites.size() - 1;
+    }
+
+    MetricShard *acquire() {
+        const ::std::lock_guard<::std::mutex> lock(mutex);
+        if (!idle.empty()) {
+            auto *shard = idle.back();
+            idle.pop_back();
+            return shard;
+        }
+        shards.emplace_back(new MetricShard{});
+        return shards.back().get();
+    }
+    void release(MetricShard *shard) {
+        const ::std::lock_guard<::std::mutex> lock(mutex);
+        idle.push_back(shard);
+    }
+
+    MetricKind kind(::std::size_t index) {
+        const ::std::lock_guard<::std::mutex> lock(mutex);
+        return sites[index].kind;
+    }
+
+    // one JSON object per call site, aggregated over every thread, times
+    // in nanoseconds
+    void dump(::std::ostream &s) {
+        const ::std::lock_guard<::std::mutex> lock(mutex);
+        const auto scale = ns_per_tick();
+        auto hist = ::std::vector<::std::uint64_t>(HistBuckets::COUNT);
+        for (::std::size_t i = 0; i < sites.size(); ++i) {
+            const auto &site = sites[i];
+            auto total = ::std::uint64_t{0};
+            auto sum = ::std::uint64_t{0};
+            auto min = ~::std::uint64_t{0};
+            auto max = ::std::uint64_t{0};
+            ::std::fill(hist.begin(), hist.end(), 0);
+            for (const auto &shard : shards) {
+                const auto *slot =
+                    shard->slots[i].load(::std::memory_order_acquire);
+                if (slot == nullptr) {
+                    continue;
+                }
+                total += slot->total.load(::std::memory_order_relaxed);
+                sum += slot->sum.load(::std::memory_order_relaxed);
+                min = ::std::min(min,
+                                 slot->min.load(::std::memory_order_relaxed));
+                max = ::std::max(max,
+                                 slot->max.load(::std::memory_order_relaxed));
+                for (::std::size_t b = 0; slot->buckets && b < hist.size();
+                     ++b) {
+                    hist[b] +=
+                        slot->buckets[b].load(::std::memory_order_relaxed);
+                }
+            }
+            s << "{\"name\": ";
+            write_json_string(s, site.name);
+            s << ", \"kind\": \"" << to_str(site.kind) << "\", \"site\": ";
+            write_json_string(s, site.file);
+            s << ", \"line\": " << site.line << ", \"count\": " << total;
+            if (site.kind != MetricKind::Count && total > 0) {
+                const auto unit = site.kind == MetricKind::Time ? scale : 1.0;
+                const auto value = [unit](::std::uint64_t v) {
+                    return static_cast<::std::uint64_t>(
+                        static_cast<double>(v) * unit + 0.5);
+                };
+                s << ", \"sum\": " << value(sum) << ", \"min\": " << value(min)
+                  << ", \"mean\": "
+                  << value(sum / total) << ", \"p50\": "
+                  << value(percentile(hist, total, 0.5, min, max))
+                  << ", \"p90\": "
+                  << value(percentile(hist, total, 0.9, min, max))
+                  << ", \"p99\": "
+                  << value(percentile(hist, total, 0.99, min, max))
+                  << ", \"p999\": "
+                  << value(percentile(hist, total, 0.999, min, max))
+                  << ", \"max\": " << value(max);
+            }
+            s << "}\n";
+        }
+    }
+
+    void dump_to_stderr() {
+        StringBuf buf;
+        ::std::ostream s(&buf);
+        dump(s);
+        emit(buf.buffer.data(), buf.buffer.size());
+    }
+
+  private:
+    struct Site {
+        const char *name;
+        MetricKind kind;
+        const char *file;
+        int line;
+    };
+
+    // the at exit dump, destroyed with the statics created before the
+    // first call site
+    struct ExitDump {
+        ExitDump() = default;
+        ExitDump(const ExitDump &) = delete;
+        ExitDump &operator=(const ExitDump &) = delete;
+        ~ExitDump() {
+            if (RUSTY_DBG_METRICS_AT_EXIT) {
+                instance().dump_to_stderr();
+            }
+        }
+    };
+
+    MetricRegistry() = default;
+
+    // TSC rate against steady_clock since the registry was created
+    double ns_per_tick() const {
+#ifdef RUSTY_DBG_METRICS_HAS_TSC
+        auto now = ::std::chrono::steady_clock::now();
+        while (now - start_time < ::std::chrono::milliseconds(1)) {
+            now = ::std::chrono::steady_clock::now();
+        }
+        const auto ticks_now = ticks();
+        return ::std::chrono::duration<double, ::std::nano>(now - start_time)
+                   .count() /
+               static_cast<double>(ticks_now - start_ticks);
+#else
+        return 1.0;
+#endif
+    }
+
+    // midpoint of the bucket holding the @q quantile, within [min, max]
+    static ::std::uint64_t percentile(const ::std::vector<::std::uint64_t> &hist,
+                                      ::std::uint64_t total, double q,
+                                      ::std::uint64_t min,
+                                      ::std::uint64_t max) {
+        const auto rank = static_cast<::std::uint64_t>(
+            q * static_cast<double>(total - 1));
+        auto seen = ::std::uint64_t{0};
+        for (::std::size_t b = 0; b < hist.size(); ++b) {
+            seen += hist[b];
+            if (seen > rank) {
+                const auto low = HistBuckets::lower(b);
+                const auto high = b + 1 < hist.size()
+                                      ? HistBuckets::lower(b + 1) - 1
+                                      : ~::std::uint64_t{0};
+                const auto mid = low + (high - low) / 2;
+                return ::std::max(min, ::std::min(max, mid));
+            }
+        }
+        return max;
+    }
+
+    static void write_json_string(::std::ostream &s, const char *text) {
+        s << '"';
+        for (; *text != '\0'; ++text) {
+            if (*text == '"' || *text == '\\') {
+                s << '\\';
+            }
+            s << *text;
+        }
+        s << '"';
+    }
+
+    ::std::mutex mutex;
+    ::std::vector<Site> sites;
+    ::std::vector<::std::unique_ptr<MetricShard>> shards;
+    ::std::vector<MetricShard *> idle;
+    ::std::chrono::steady_clock::time_point start_time =
+        ::std::chrono::steady_clock::now();
+    ::std::uint64_t start_ticks = ticks();
+};
+
+// static per call site, trivially destructible so it outlives nothing
+struct MetricSite {
+    MetricSite(const char *name, MetricKind kind, const char *file, int line)
+        : index(MetricRegistry::instance().add_site(name, kind, file, line)) {}
+
+    ::std::size_t index;
+};
+
+// shard of the calling thread, returned to the registry at thread exit
+inline MetricShard *&thread_shard() noexcept {
+    thread_local MetricShard *shard = nullptr;
+    return shard;
+}
+
+inline MetricShard *acquire_thread_shard() {
+    struct Release {
+        ~Release() {
+            MetricRegistry::instance().release(thread_shard());
+            thread_shard() = nullptr;
+        }
+    };
+    thread_local Release release;
+    return thread_shard() = MetricRegistry::instance().acquire();
+}
+
+inline MetricSlot *metric_slot(const MetricSite &site) {
+    if (site.index == RUSTY_DBG_METRICS_MAX_SITES) {
+        return nullptr;
+    }
+    auto *shard = thread_shard();
+    if (shard == nullptr) {
+        shard = acquire_thread_shard();
+    }
+    auto *slot = shard->slots[site.index].load(::std::memory_order_relaxed);
+    if (slot == nullptr) {
+        shard->owned.emplace_back(
+            new MetricSlot(MetricRegistry::instance().kind(site.index)));
+        slot = shard->owned.back().get();
+        shard->slots[site.index].store(slot, ::std::memory_order_release);
+    }
+    return slot;
+}
+
+inline void count_metric(const MetricSite &site, ::std::uint64_t n = 1) {
+    if (auto *slot = metric_slot(site)) {
+        slot->count(n);
+    }
+}
+
+inline void record_metric(const MetricSite &site, ::std::uint64_t value) {
+    if (auto *slot = metric_slot(site)) {
+        slot->record(value);
+    }
+}
+
+// records the ticks from construction to destruction
+class ScopedTimer {
+  public:
+    explicit ScopedTimer(const MetricSite &site) noexcept
+        : site(site), start(ticks()) {}
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+    ~ScopedTimer() { record_metric(site, ticks() - start); }
+
+  private:
+    const MetricSite &site;
+    ::std::uint64_t start;
+};
+
+// JSON lines of every metric so far, to @s or stderr
+inline void dump_metrics(::std::ostream &s) {
+    MetricRegistry::instance().dump(s);
+}
+inline void dump_metrics() { MetricRegistry::instance().dump_to_stderr(); }
+
+} // namespace rusty::debug
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define RUSTY_IO_HAS_FD
+#endif
+
+namespace rusty::io {
+
+// Typed reads shared by every reader, @Derived provides:
+//     const ::std::uint8_t *take(::std::size_t n): n contiguous bytes
+//     void read_exact(::std::uint8_t *out, ::std::size_t n)
+// both throw ::std::out_of_range when input ends early.
+template <typename Derived> class ReadExt {
+  public:
+    template <typename N, bool BigEndian> N read() {
+        N number;
+        ::std::memcpy(&number, self().take(sizeof(N)), sizeof(N));
+        return BigEndian ? N::from_be(number) : N::from_le(number);
+    }
+
+    // batch read of @count elements straight into @out
+    template <typename N, bool BigEndian>
+    void read_into(N *out, ::std::size_t count) {
+        self().read_exact(reinterpret_cast<::std::uint8_t *>(out), // NOLINT
+                          count * sizeof(N));
+        if (BigEndian != N::is_be) {
+            N::swap_bytes_inplace(out, count);
+        }
+    }
+
+    numeric_types::u8 read_u8() { return read<numeric_types::u8, false>(); }
+    numeric_types::i8 read_i8() { return read<numeric_types::i8, false>(); }
+
+#define READ_IMPL(ALIAS)                                                       \
+    numeric_types::ALIAS read_##ALIAS##_le() {                                 \
+        return read<numeric_types::ALIAS, false>();                            \
+    }                                                                          \
+    numeric_types::ALIAS read_##ALIAS##_be() {                                 \
+        return read<numeric_types::ALIAS, true>();                             \
+    }
+
+    READ_IMPL(u16)
+    READ_IMPL(i16)
+    READ_IMPL(u32)
+    READ_IMPL(i32)
+    READ_IMPL(u64)
+    READ_IMPL(i64)
+    READ_IMPL(u128)
+    READ_IMPL(i128)
+    READ_IMPL(f32)
+    READ_IMPL(f64)
+
+#undef READ_IMPL
+
+  private:
+    Derived &self() { return static_cast<Derived &>(*this); }
+};
+
+// Typed writes shared by every writer, @Derived provides:
+//     void write_bytes(const ::std::uint8_t *bytes, ::std::size_t n)
+template <typename Derived> class WriteExt {
+  public:
+    template <typename N, bool BigEndian> void write(const N &number) {
+        const auto bytes =
+            BigEndian ? number.to_be_bytes() : number.to_le_bytes();
+        self().write_bytes(reinterpret_cast<const ::std::uint8_t *>( // NOLINT
+                               bytes.data()),
+                           bytes.size());
+    }
+
+    // batch write of @count elements, converted through a bounded chunk
+    template <typename N, bool BigEndian>
+    void write_from(const N *in, ::std::size_t count) {
+        if (BigEndian == N::is_be) {
+            self().write_bytes(
+                reinterpret_cast<const ::std::uint8_t *>(in), // NOLINT
+                count * sizeof(N));
+            return;
+        }
+        constexpr ::std::size_t chunk = 4096 / sizeof(N);
+        ::std::uint8_t buffer[chunk * sizeof(N)]; // NOLINT
+        while (count > 0) {
+            const auto n = ::std::min(count, chunk);
+            if (BigEndian) {
+                N::to_be_slice(in, n, buffer);
+            } else {
+                N::to_le_slice(in, n, buffer);
+            }
+            self().write_bytes(buffer, n * sizeof(N));
+            in += n;
+            count -= n;
+        }
+    }
+
+    void write_u8(numeric_types::u8 number) {
+        write<numeric_types::u8, false>(number);
+    }
+    void write_i8(numeric_types::i8 number) {
+        write<numeric_types::i8, false>(number);
+    }
+
+#define WRITE_IMPL(ALIAS)                                                      \
+    void write_##ALIAS##_le(numeric_types::ALIAS number) {                     \
+        write<numeric_types::ALIAS, false>(number);                            \
+    }                                                                          \
+    void write_##ALIAS##_be(numeric_types::ALIAS number) {                     \
+        write<numeric_types::ALIAS, true>(number);                             \
+    }
+
+    WRITE_IMPL(u16)
+    WRITE_IMPL(i16)
+    WRITE_IMPL(u32)
+    WRITE_IMPL(i32)
+    WRITE_IMPL(u64)
+    WRITE_IMPL(i64)
+    WRITE_IMPL(u128)
+    WRITE_IMPL(i128)
+    WRITE_IMPL(f32)
+    WRITE_IMPL(f64)
+
+#undef WRITE_IMPL
+
+  private:
+    Derived &self() { return static_cast<Derived &>(*this); }
+};
+
+// Cursor over borrowed memory (e.g. a mmap region), never copies on take
+class ByteReader : public ReadExt<ByteReader> {
+  public:
+    ByteReader(const ::std::uint8_t *bytes, ::std::size_t len)
+        : bytes(bytes), len(len) {}
+
+    // the whole input, position() bytes of it already read
+    const ::std::uint8_t *data() const { return bytes; }
+    ::std::size_t position() const { return pos; }
+    ::std::size_t remaining() const { return len - pos; }
+    bool is_empty() const { return pos == len; }
+
+    void seek(::std::size_t position) {
+        if (position > len) {
+            throw ::std::out_of_range("rusty::io: seek out of range");
+        }
+        pos = position;
+    }
+    void skip(::std::size_t n) { take(n); }
+
+    const ::std::uint8_t *take(::std::size_t n) {
+        if (n > remaining()) {
+            throw ::std::out_of_range("rusty::io: unexpected end of input");
+        }
+        const auto *p = bytes + pos;
+        pos += n;
+        return p;
+    }
+
+    void read_exact(::std::uint8_t *out, ::std::size_t n) {
+        ::std::memcpy(out, take(n), n);
+    }
+
+    // zero-copy view of the next @count encoded elements
+    template <typename N, bool BigEndian>
+    numeric_types::EndianSlice<N, BigEndian> read_slice(::std::size_t count) {
+        return {take(count * sizeof(N)), count};
+    }
+
+  private:
+    const ::std::uint8_t *bytes;
+    ::std::size_t len;
+    ::std::size_t pos = 0;
+};
+
+// Cursor appending to an owned growable buffer
+class ByteWriter : public WriteExt<ByteWriter> {
+  public:
+    void write_bytes(const ::std::uint8_t *bytes, ::std::size_t n) {
+        buffer.insert(buffer.end(), bytes, bytes + n);
+    }
+
+    const ::std::vector<::std::uint8_t> &bytes() const & { return buffer; }
+    ::std::vector<::std::uint8_t> into_inner() && { return ::std::move(buffer); }
+
+  private:
+    ::std::vector<::std::uint8_t> buffer;
+};
+
+// Sources return the count of bytes read, 0 only at end of input
+class IstreamSource {
+  public:
+    explicit IstreamSource(::std::istream &s) : s(&s) {}
+
+    ::std::size_t read(::std::uint8_t *out, ::std::size_t n) {
+        s->read(reinterpret_cast<char *>(out), // NOLINT
+                static_cast<::std::streamsize>(n));
+        if (s->bad()) {
+            throw ::std::runtime_error("rusty::io: istream read failed");
+        }
+        return static_cast<::std::size_t>(s->gcount());
+    }
+
+  private:
+    ::std::istream *s;
+};
+
+class OstreamSink {
+  public:
+    explicit OstreamSink(::std::ostream &s) : s(&s) {}
+
+    void write(const ::std::uint8_t *bytes, ::std::size_t n) {
+        if (!s->write(reinterpret_cast<const char *>(bytes), // NOLINT
+                      static_cast<::std::streamsize>(n))) {
+            throw ::std::runtime_error("rusty::io: ostream write failed");
+        }
+    }
+
+  private:
+    ::std::ostream *s;
+};
+
+#ifdef RUSTY_IO_HAS_FD
+class FdSource {
+  public:
+    explicit FdSource(int fd) : fd(fd) {}
+
+    ::std::size_t read(::std::uint8_t *out, ::std::size_t n) {
+        for (;;) {
+            const auto r = ::read(fd, out, n);
+            if (r >= 0) {
+                return static_cast<::std::size_t>(r);
+            }
+            if (errno != EINTR) {
+                throw ::std::system_error(errno, ::std::generic_category(),
+                                          "rusty::io: read");
+            }
+        }
+    }
+
+  private:
+    int fd;
+};
+
+class FdSink {
+  public:
+    explicit FdSink(int fd) : fd(fd) {}
+
+    void write(const ::std::uint8_t *bytes, ::std::size_t n) {
+        while (n > 0) {
+            const auto r = ::write(fd, bytes, n);
+            if (r < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw ::std::system_error(errno, ::std::generic_category(),
+                                          "rusty::io: write");
+            }
+            bytes += r;
+            n -= static_cast<::std::size_t>(r);
+        }
+    }
+
+  private:
+    int fd;
+};
+#endif
+
+// Reader refilling from @Source in large blocks, reads larger than the
+// buffer bypass it entirely
+template <typename Source> class BufReader : public ReadExt<BufReader<Source>> {
+  public:
+    static constexpr ::std::size_t DEFAULT_CAPACITY = 1 << 20;
+
+    explicit BufReader(Source source,
+                       ::std::size_t capacity = DEFAULT_CAPACITY)
+        : source(::std::move(source)), buffer(capacity) {}
+
+    ::std::size_t buffered() const { return end - begin; }
+
+    const ::std::uint8_t *take(::std::size_t n) {
+        if (buffered() < n) {
+            fill(n);
+        }
+        const auto *p = buffer.data() + begin;
+        begin += n;
+        return p;
+    }
+
+    void read_exact(::std::uint8_t *out, ::std::size_t n) {
+        const auto head = ::std::min(n, buffered());
+        ::std::memcpy(out, buffer.data() + begin, head);
+        begin += head;
+        out += head;
+        n -= head;
+        if (n >= buffer.size()) {
+            while (n > 0) {
+                const auto r = source.read(out, n);
+                if (r == 0) {
+                    throw ::std::out_of_range(
+                        "rusty::io: unexpected end of input");
+                }
+                out += r;
+                n -= r;
+            }
+        } else if (n > 0) {
+            ::std::memcpy(out, take(n), n);
+        }
+    }
+
+  private:
+    // make at least @n bytes contiguous in the buffer
+    void fill(::std::size_t n) {
+        ::std::memmove(buffer.data(), buffer.data() + begin, buffered());
+        end -= begin;
+        begin = 0;
+        if (buffer.size() < n) {
+            buffer.resize(n);
+        }
+        while (end < n) {
+            const auto r =
+                source.read(buffer.data() + end, buffer.size() - end);
+            if (r == 0) {
+                throw ::std::out_of_range("rusty::io: unexpected end of input");
+            }
+            end += r;
+        }
+    }
+
+    Source source;
+    ::std::vector<::std::uint8_t> buffer;
+    ::std::size_t begin = 0;
+    ::std::size_t end = 0;
+};
+
+// Writer flushing to @Sink in large blocks, flushed on destruction too
+template <typename Sink> class BufWriter : public WriteExt<BufWriter<Sink>> {
+  public:
+    static constexpr ::std::size_t DEFAULT_CAPACITY = 1 << 20;
+
+    explicit BufWriter(Sink sink, ::std::size_t capacity = DEFAULT_CAPACITY)
+        : sink(::std::move(sink)) {
+        buffer.reserve(capacity);
+    }
+    BufWriter(BufWriter &&) noexcept = default;
+    BufWriter(const BufWriter &) = delete;
+    BufWriter &operator=(const BufWriter &) = delete;
+    BufWriter &operator=(BufWriter &&) = delete;
+    ~BufWriter() {
+        try {
+            flush();
+        } catch (...) { // NOLINT(bugprone-empty-catch)
+            // errors on drop are ignored like rust, flush explicitly to see
+        }
+    }
+
+    void write_bytes(const ::std::uint8_t *bytes, ::std::size_t n) {
+        if (buffer.size() + n > buffer.capacity()) {
+            flush();
+        }
+        if (n >= buffer.capacity()) {
+            sink.write(bytes, n);
+        } else {
+            buffer.insert(buffer.end(), bytes, bytes + n);
+        }
+    }
+
+    void flush() {
+        if (!buffer.empty()) {
+            sink.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+
+  private:
+    Sink sink;
+    ::std::vector<::std::uint8_t> buffer;
+};
+
+using StreamReader = BufReader<IstreamSource>;
+using StreamWriter = BufWriter<OstreamSink>;
+#ifdef RUSTY_IO_HAS_FD
+using FdReader = BufReader<FdSource>;
+using FdWriter = BufWriter<FdSink>;
+#endif
+
+} // namespace rusty::io
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace rusty::iter {
+
+namespace detail {
+
+using collections::Pair;
+
+// value type stored by collect: references dropped, also inside pairs
+template <typename T> struct Owned {
+    using Type = typename ::std::decay<T>::type;
+};
+template <typename T1, typename T2> struct Owned<Pair<T1, T2>> {
+    using Type = Pair<typename Owned<T1>::Type, typename Owned<T2>::Type>;
+};
+template <typename T1, typename T2> struct Owned<const Pair<T1, T2>> {
+    using Type = Pair<typename Owned<T1>::Type, typename Owned<T2>::Type>;
+};
+
+// push_back for sequences, insert for maps
+template <typename C, typename T>
+auto append(C &c, T &&value, int /*preferred*/)
+    -> decltype(c.push_back(::std::forward<T>(value))) {
+    c.push_back(::std::forward<T>(value));
+}
+template <typename C, typename T>
+void append(C &c, T &&value, long /*fallback*/) {
+    c.insert(::std::forward<T>(value));
+}
+
+template <typename C>
+auto reserve(C &c, ::std::size_t n, int /*preferred*/)
+    -> decltype(c.reserve(n)) {
+    c.reserve(n);
+}
+template <typename C> void reserve(C & /*c*/, ::std::size_t /*n*/, long) {}
+
+// Stages push their items into a sink returning false to stop, so a whole
+// pipeline inlines into one loop. size_hint() is a lower bound, like the
+// first half of rust size_hint.
+
+template <typename It> class RangeStage {
+  public:
+    using Item = decltype(*::std::declval<It>());
+
+    RangeStage(It first, It last, ::std::size_t len)
+        : first(first), last(last), len(len) {}
+
+    template <typename F> void run(F &&sink) const {
+        for (auto it = first; it != last; ++it) {
+            if (!sink(*it)) {
+                return;
+            }
+        }
+    }
+    ::std::size_t size_hint() const noexcept { return len; }
+
+    It begin() const { return first; }
+    It end() const { return last; }
+
+  private:
+    It first;
+    It last;
+    ::std::size_t len;
+};
+
+template <typename S, typename F> class MapStage {
+  public:
+    using Item = decltype(::std::declval<const F &>()(
+        ::std::declval<typename S::Item>()));
+
+    MapStage(S base, F f) : base(::std::move(base)), f(::std::move(f)) {}
+
+    template <typename G> void run(G &&sink) const {
+        using In = typename S::Item;
+        base.run([&](In item) { return sink(f(::std::forward<In>(item))); });
+    }
+    ::std::size_t size_hint() const noexcept { return base.size_hint(); }
+
+  private:
+    S base;
+    F f;
+};
+
+template <typename S, typename P> class FilterStage {
+  public:
+    using Item = typename S::Item;
+
+    FilterStage(S base, P pred)
+        : base(::std::move(base)), pred(::std::move(pred)) {}
+
+    template <typename G> void run(G &&sink) const {
+        using Ref = const typename ::std::decay<Item>::type &;
+        // branching on the predicate itself keeps the loop vectorizable
+        base.run([&](Item item) {
+            if (pred(static_cast<Ref>(item))) {
+                return sink(::std::forward<Item>(item));
+            }
+            return true;
+        });
+    }
+    ::std::size_t size_hint() const noexcept { return 0; }
+
+  private:
+    S base;
+    P pred;
+};
+
+template <typename S> class TakeStage {
+  public:
+    using Item = typename S::Item;
+
+    TakeStage(S base, ::std::size_t n) : base(::std::move(base)), n(n) {}
+
+    template <typename G> void run(G &&sink) const {
+        auto left = n;
+        if (left > 0) {
+            base.run([&](Item item) {
+                return sink(::std::forward<Item>(item)) && --left > 0;
+            });
+        }
+    }
+    ::std::size_t size_hint() const noexcept {
+        return ::std::min(base.size_hint(), n);
+    }
+
+  private:
+    S base;
+    ::std::size_t n;
+};
+
+template <typename S> class SkipStage {
+  public:
+    using Item = typename S::Item;
+
+    SkipStage(S base, ::std::size_t n) : base(::std::move(base)), n(n) {}
+
+    template <typename G> void run(G &&sink) const {
+        auto left = n;
+        base.run([&](Item item) {
+            if (left > 0) {
+                --left;
+                return true;
+            }
+            return sink(::std::forward<Item>(item));
+        });
+    }
+    ::std::size_t size_hint() const noexcept {
+        return base.size_hint() > n ? base.size_hint() - n : 0;
+    }
+
+  private:
+    S base;
+    ::std::size_t n;
+};
+
+template <typename S> class EnumerateStage {
+  public:
+    using Item = Pair<::std::size_t, typename S::Item>;
+
+    explicit EnumerateStage(S base) : base(::std::move(base)) {}
+
+    template <typename G> void run(G &&sink) const {
+        using In = typename S::Item;
+        auto index = ::std::size_t{0};
+        base.run([&](In item) {
+            return sink(Item(index++, ::std::forward<In>(item)));
+        });
+    }
+    ::std::size_t size_hint() const noexcept { return base.size_hint(); }
+
+  private:
+    S base;
+};
+
+// pulls the second range while the first one pushes, ends with the shorter
+template <typename S, typename It> class ZipStage {
+  public:
+    using Item = Pair<typename S::Item, decltype(*::std::declval<It>())>;
+
+    ZipStage(S base, It first, It last, ::std::size_t len)
+        : base(::std::move(base)), first(first), last(last), len(len) {}
+
+    template <typename G> void run(G &&sink) const {
+        using In = typename S::Item;
+        auto it = first;
+        base.run([&](In item) {
+            if (it == last) {
+                return false;
+            }
+            auto pair = Item(::std::forward<In>(item), *it);
+            ++it;
+            return sink(::std::move(pair));
+        });
+    }
+    ::std::size_t size_hint() const noexcept {
+        return ::std::min(base.size_hint(), len);
+    }
+
+  private:
+    S base;
+    It first;
+    It last;
+    ::std::size_t len;
+};
+
+// both random access ranges zipped in one counted loop, which vectorizes
+// unlike the exit on the end of the second range
+template <typename It1, typename It2> class ZipRangeStage {
+  public:
+    using Item = Pair<decltype(*::std::declval<It1>()),
+                      decltype(*::std::declval<It2>())>;
+
+    ZipRangeStage(It1 first1, It1 last1, It2 first2, It2 last2)
+        : first1(first1), first2(first2),
+          len(static_cast<::std::size_t>(
+              ::std::min<::std::ptrdiff_t>(last1 - first1, last2 - first2))) {}
+
+    template <typename G> void run(G &&sink) const {
+        for (::std::size_t i = 0; i < len; ++i) {
+            if (!sink(Item(first1[i], first2[i]))) {
+                return;
+            }
+        }
+    }
+    ::std::size_t size_hint() const noexcept { return len; }
+
+  private:
+    It1 first1;
+    It2 first2;
+    ::std::size_t len;
+};
+
+template <typename It>
+using IsRandomAccess = ::std::is_base_of<
+    ::std::random_access_iterator_tag,
+    typename ::std::iterator_traits<It>::iterator_category>;
+
+template <typename S, typename It>
+ZipStage<S, It> zip_stage(const S &base, It first, It last,
+                          ::std::size_t len) {
+    return {base, first, last, len};
+}
+template <typename It1, typename It2>
+numeric_types::enable_if_t<IsRandomAccess<It1>::value &&
+                               IsRandomAccess<It2>::value,
+                           ZipRangeStage<It1, It2>>
+zip_stage(const RangeStage<It1> &base, It2 first, It2 last,
+          ::std::size_t /*len*/) {
+    return {base.begin(), base.end(), first, last};
+}
+
+template <typename S, typename C>
+using ZipStageOf = decltype(zip_stage(::std::declval<const S &>(),
+                                      ::std::begin(::std::declval<C &>()),
+                                      ::std::end(::std::declval<C &>()),
+                                      ::std::size_t{}));
+
+// slices of @size elements every @step elements, the shorter last one kept
+// only when @partial
+template <typename T> class SliceStage {
+  public:
+    using Item = collections::Slice<T>;
+
+    SliceStage(T *data, ::std::size_t len, ::std::size_t size,
+               ::std::size_t step, bool partial)
+        : data(data), len(len), size(size), step(step), partial(partial) {}
+
+    template <typename G> void run(G &&sink) const {
+        if (size == 0) {
+            return;
+        }
+        for (::std::size_t i = 0; i < len && (partial || len - i >= size);
+             i += step) {
+            if (!sink(Item(data + i, ::std::min(size, len - i)))) {
+                return;
+            }
+        }
+    }
+    ::std::size_t size_hint() const noexcept {
+        if (size == 0) {
+            return 0;
+        }
+        if (partial) {
+            return (len + step - 1) / step;
+        }
+        return len >= size ? (len - size) / step + 1 : 0;
+    }
+
+  private:
+    T *data;
+    ::std::size_t len;
+    ::std::size_t size;
+    ::std::size_t step;
+    bool partial;
+};
+
+template <typename C>
+using IteratorOf = decltype(::std::begin(::std::declval<C &>()));
+
+template <typename C>
+using ElementOf = typename ::std::remove_pointer<decltype(
+    ::std::declval<C &>().data())>::type;
+
+} // namespace detail
+
+// Lazy iterator over a stage like rust Iterator: adapters build a new
+// pipeline without running anything, consumers run it in one fused loop
+// with no intermediate container. Items are references into the source
+// until an adapter makes values.
+template <typename S> class Iter {
+  public:
+    using Item = typename S::Item;
+    using Owned = typename detail::Owned<Item>::Type;
+
+    explicit Iter(S stage) : stage(::std::move(stage)) {}
+
+    // adapters
+
+    template <typename F> Iter<detail::MapStage<S, F>> map(F f) const {
+        return Iter<detail::MapStage<S, F>>({stage, ::std::move(f)});
+    }
+    template <typename P> Iter<detail::FilterStage<S, P>> filter(P pred) const {
+        return Iter<detail::FilterStage<S, P>>({stage, ::std::move(pred)});
+    }
+    Iter<detail::TakeStage<S>> take(::std::size_t n) const {
+        return Iter<detail::TakeStage<S>>({stage, n});
+    }
+    Iter<detail::SkipStage<S>> skip(::std::size_t n) const {
+        return Iter<detail::SkipStage<S>>({stage, n});
+    }
+    // items become Pair<std::size_t, Item>
+    Iter<detail::EnumerateStage<S>> enumerate() const {
+        return Iter<detail::EnumerateStage<S>>(
+            detail::EnumerateStage<S>(stage));
+    }
+    // items become Pair<Item, element of @other>, @other must outlive it
+    template <typename C>
+    Iter<detail::ZipStageOf<S, C>> zip(C &other) const {
+        return Iter<detail::ZipStageOf<S, C>>(detail::zip_stage(
+            stage, ::std::begin(other), ::std::end(other),
+            static_cast<::std::size_t>(other.size())));
+    }
+    template <typename C> void zip(const C &&other) const = delete;
+
+    // consumers
+
+    template <typename F> void for_each(F f) const {
+        stage.run([&](Item item) {
+            f(::std::forward<Item>(item));
+            return true;
+        });
+    }
+
+    template <typename T, typename F> T fold(T init, F f) const {
+        stage.run([&](Item item) {
+            init = f(::std::move(init), ::std::forward<Item>(item));
+            return true;
+        });
+        return init;
+    }
+
+    Owned sum() const {
+        return fold(Owned{}, [](Owned acc, Item item) {
+            return static_cast<Owned>(acc + item);
+        });
+    }
+
+    ::std::size_t count() const {
+        auto n = ::std::size_t{0};
+        stage.run([&n](Item /*item*/) {
+            ++n;
+            return true;
+        });
+        return n;
+    }
+
+    // stop at the first item matching @pred
+    template <typename P> bool any(P pred) const {
+        auto found = false;
+        stage.run([&](Item item) {
+            found = pred(static_cast<const Owned &>(item));
+            return !found;
+        });
+        return found;
+    }
+    template <typename P> bool all(P pred) const {
+        auto ok = true;
+        stage.run([&](Item item) {
+            ok = pred(static_cast<const Owned &>(item));
+            return ok;
+        });
+        return ok;
+    }
+
+    // into any container with push_back or insert, like
+    // `collect<Vec<u32>>()`, `collect<Vec>()` or `collect<HashMap<K, V>>()`
+    template <typename C = collections::Vec<Owned>> C collect() const {
+        C out;
+        detail::reserve(out, stage.size_hint(), 0);
+        stage.run([&out](Item item) {
+            detail::append(out, ::std::forward<Item>(item), 0);
+            return true;
+        });
+        return out;
+    }
+    template <template <typename...> class C> C<Owned> collect() const {
+        return collect<C<Owned>>();
+    }
+
+    ::std::size_t size_hint() const noexcept { return stage.size_hint(); }
+
+  private:
+    S stage;
+};
+
+// items of any container, e.g. Vec, Array, SmallVec and HashMap; mutable
+// references for a non const container
+template <typename C>
+Iter<detail::RangeStage<detail::IteratorOf<C>>> iter(C &container) {
+    return Iter<detail::RangeStage<detail::IteratorOf<C>>>(
+        {::std::begin(container), ::std::end(container),
+         static_cast<::std::size_t>(container.size())});
+}
+template <typename C> void iter(const C &&container) = delete;
+
+// @first to @last, with @len as size hint
+template <typename It>
+Iter<detail::RangeStage<It>> iter(It first, It last, ::std::size_t len = 0) {
+    return Iter<detail::RangeStage<It>>({first, last, len});
+}
+
+// Slices of @size elements from a contiguous container, the last one shorter
+// when @size does not divide its length; none at all for a zero @size
+template <typename C>
+Iter<detail::SliceStage<detail::ElementOf<C>>> chunks(C &container,
+                                                      ::std::size_t size) {
+    return Iter<detail::SliceStage<detail::ElementOf<C>>>(
+        {container.data(), container.size(), size, size, true});
+}
+template <typename C> void chunks(const C &&container, ::std::size_t) = delete;
+
+// every run of @size consecutive elements, overlapping
+template <typename C>
+Iter<detail::SliceStage<detail::ElementOf<C>>> windows(C &container,
+                                                       ::std::size_t size) {
+    return Iter<detail::SliceStage<detail::ElementOf<C>>>(
+        {container.data(), container.size(), size, 1, false});
+}
+template <typename C> void windows(const C &&container, ::std::size_t) = delete;
+
+} // namespace rusty::iter
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// define RUSTY_PARALLEL_STD_EXECUTION to run sorts, for_each and reductions
+// through the std::execution::par algorithms where the standard library
+// provides them (MSVC, libstdc++ with TBB, linked with -ltbb), the pool runs
+// them otherwise; an exception escaping an element then terminates
+#if defined(RUSTY_PARALLEL_STD_EXECUTION) && __cplusplus >= 201703L
+#if defined(__has_include)
+#if __has_include(<execution>)
+#include <execution>
+#endif
+#endif
+#endif
+#if defined(RUSTY_PARALLEL_STD_EXECUTION) &&                                  \
+    defined(__cpp_lib_parallel_algorithm)
+#define RUSTY_PARALLEL_HAS_STD_EXECUTION
+#endif
+
+namespace rusty::parallel {
+
+// Work stealing pool: each thread owns a deque, runs its newest task first
+// and steals the oldest task of another deque when it runs dry. A thread
+// waiting for its tasks runs queued tasks meanwhile, so parallel calls
+// nest without deadlock.
+class ThreadPool {
+  public:
+    // RUSTY_NUM_THREADS when set, like RAYON_NUM_THREADS, otherwise the
+    // hardware concurrency
+    static ::std::size_t default_threads() {
+        if (const char *env = ::std::getenv("RUSTY_NUM_THREADS")) {
+            const auto n = ::std::strtoul(env, nullptr, 10);
+            if (n > 0) {
+                return n;
+            }
+        }
+        const auto n = ::std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+    // shared by every parallel call not given a pool
+    static ThreadPool &global() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // @threads counts the calling thread, which works while it waits, so
+    // ThreadPool(1) runs everything inline
+    explicit ThreadPool(::std::size_t threads = default_threads()) {
+        threads = threads > 0 ? threads : 1;
+        for (::std::size_t i = 0; i < threads; ++i) {
+            queues.emplace_back(new Queue);
+        }
+        for (::std::size_t i = 1; i < threads; ++i) {
+            workers.emplace_back([this, i] { work(i); });
+        }
+    }
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ~ThreadPool() {
+        {
+            const ::std::lock_guard<::std::mutex> lock(sleep_mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    ::std::size_t threads() const noexcept { return queues.size(); }
+
+    // calls @body(chunk, begin, end) for the @chunks contiguous ranges of
+    // [0, @n), returns when all are done and rethrows the first exception
+    template <typename F>
+    void for_each_chunk(::std::size_t n, ::std::size_t chunks,
+                        const F &body) {
+        chunks = ::std::max<::std::size_t>(::std::min(chunks, n), 1);
+        if (chunks == 1 || threads() == 1) {
+            for (::std::size_t i = 0; i < chunks; ++i) {
+                body(i, n * i / chunks, n * (i + 1) / chunks);
+            }
+            return;
+        }
+        Job job;
+        job.remaining.store(chunks, ::std::memory_order_relaxed);
+        const auto self = self_index();
+        // newest first on our own deque, so the first chunks go last
+        for (auto i = chunks - 1; i > 0; --i) {
+            auto task = [&job, &body, n, chunks, i] {
+                job.run([&] { body(i, n * i / chunks, n * (i + 1) / chunks); });
+            };
+            const auto target = self != 0 ? self : i % threads();
+            {
+                const ::std::lock_guard<::std::mutex> lock(
+                    queues[target]->mutex);
+                queues[target]->tasks.emplace_back(::std::move(task));
+            }
+        }
+        pending.fetch_add(chunks - 1, ::std::memory_order_release);
+        {
+            // waiters check pending under the lock, no wakeup is lost
+            const ::std::lock_guard<::std::mutex> lock(sleep_mutex);
+        }
+        wake.notify_all();
+        job.run([&] { body(0, 0, n / chunks); });
+        while (job.remaining.load(::std::memory_order_acquire) > 0) {
+            if (!run_one(self)) {
+                ::std::this_thread::yield();
+            }
+        }
+        if (job.error) {
+            ::std::rethrow_exception(job.error);
+        }
+    }
+
+  private:
+    struct Queue {
+        ::std::mutex mutex;
+        ::std::deque<::std::function<void()>> tasks;
+    };
+
+    struct Job {
+        ::std::atomic<::std::size_t> remaining{0};
+        ::std::atomic<bool> failed{false};
+        ::std::exception_ptr error;
+
+        // the job must not be touched once remaining drops
+        template <typename F> void run(const F &f) {
+            if (!failed.load(::std::memory_order_relaxed)) {
+                try {
+                    f();
+                } catch (...) {
+                    if (!failed.exchange(true)) {
+                        error = ::std::current_exception();
+                    }
+                }
+            }
+            remaining.fetch_sub(1, ::std::memory_order_acq_rel);
+        }
+    };
+
+    // deque of the current thread in this pool, 0 for outside threads
+    ::std::size_t self_index() const noexcept {
+        return current_pool() == this ? current_index() : 0;
+    }
+    static const ThreadPool *&current_pool() noexcept {
+        thread_local const ThreadPool *pool = nullptr;
+        return pool;
+    }
+    static ::std::size_t &current_index() noexcept {
+        thread_local ::std::size_t index = 0;
+        return index;
+    }
+
+    // newest task of our deque, else the oldest of another one
+    bool run_one(::std::size_t self) {
+        ::std::function<void()> task;
+        for (::std::size_t k = 0; k < queues.size() && !task; ++k) {
+            auto &queue = *queues[(self + k) % queues.size()];
+            const ::std::lock_guard<::std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                if (k == 0) {
+                    task = ::std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                } else {
+                    task = ::std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+            }
+        }
+        if (!task) {
+            return false;
+        }
+        pending.fetch_sub(1, ::std::memory_order_relaxed);
+        task();
+        return true;
+    }
+
+    void work(::std::size_t self) {
+        current_pool() = this;
+        current_index() = self;
+        for (;;) {
+            if (run_one(self)) {
+                continue;
+            }
+            auto lock = ::std::unique_lock<::std::mutex>(sleep_mutex);
+            wake.wait(lock, [this] {
+                return stop || pending.load(::std::memory_order_acquire) > 0;
+            });
+            if (stop) {
+                return;
+            }
+        }
+    }
+
+    ::std::vector<::std::unique_ptr<Queue>> queues;
+    ::std::atomic<::std::size_t> pending{0};
+    ::std::mutex sleep_mutex;
+    ::std::condition_variable wake;
+    bool stop = false;
+    ::std::vector<::std::thread> workers; // last, started once all is ready
+};
+
+namespace detail {
+
+// smallest chunk worth a task, in elements
+constexpr ::std::size_t DEFAULT_MIN_LEN = 1024;
+
+// a few chunks per thread, so stealing evens out uneven chunks, and a
+// single pass when there is no other thread
+inline ::std::size_t chunks_for(const ThreadPool &pool, ::std::size_t n,
+                                ::std::size_t min_len) {
+    if (pool.threads() == 1) {
+        return 1;
+    }
+    return ::std::min((n + min_len - 1) / min_len, pool.threads() * 4);
+}
+
+// element type of a contiguous container, const for a const one
+template <typename C>
+using ElementOf = typename ::std::remove_pointer<decltype(
+    ::std::declval<C &>().data())>::type;
+
+struct Identity {
+    template <typename T> T &&operator()(T &&value) const noexcept {
+        return static_cast<T &&>(value);
+    }
+};
+
+template <typename F, typename G> struct Composed {
+    F f;
+    G g;
+
+    template <typename T>
+    auto operator()(T &&value) const
+        -> decltype(g(f(static_cast<T &&>(value)))) {
+        return g(f(static_cast<T &&>(value)));
+    }
+};
+
+struct Plus {
+    template <typename T> T operator()(const T &a, const T &b) const {
+        return static_cast<T>(a + b);
+    }
+};
+
+} // namespace detail
+
+// Parallel view of @len elements from @first, transformed lazily by map
+// and consumed in chunks by for_each, reduce, sum and collect, like rayon
+// par_iter; @F maps each element reference to the item
+template <typename T, typename F = detail::Identity> class ParIter {
+  public:
+    using Item = typename ::std::decay<decltype(::std::declval<const F &>()(
+        ::std::declval<T &>()))>::type;
+
+    ParIter(T *first, ::std::size_t len, F f = F{},
+            ThreadPool *pool = &ThreadPool::global(),
+            ::std::size_t min_len = detail::DEFAULT_MIN_LEN)
+        : first(first), len(len), f(::std::move(f)), pool(pool),
+          min_len(min_len > 0 ? min_len : 1) {}
+
+    template <typename G>
+    ParIter<T, detail::Composed<F, G>> map(G g) const {
+        return {first, len, detail::Composed<F, G>{f, ::std::move(g)}, pool,
+                min_len};
+    }
+
+    // run on @other instead of the global pool
+    ParIter with_pool(ThreadPool &other) const {
+        return {first, len, f, &other, min_len};
+    }
+    // no chunk smaller than @n elements, raise it for cheap items
+    ParIter with_min_len(::std::size_t n) const {
+        return {first, len, f, pool, n};
+    }
+
+    ::std::size_t size() const noexcept { return len; }
+
+    template <typename G> void for_each(const G &g) const {
+#ifdef RUSTY_PARALLEL_HAS_STD_EXECUTION
+        ::std::for_each(::std::execution::par, first, first + len,
+                        [&](T &value) { g(f(value)); });
+#else
+        pool->for_each_chunk(len, chunks(),
+                             [&](::std::size_t, ::std::size_t begin,
+                                 ::std::size_t end) {
+                                 for (auto i = begin; i < end; ++i) {
+                                     g(f(first[i]));
+                                 }
+                             });
+#endif
+    }
+
+    // @op must be associative, and commutative too with std::execution
+    template <typename Op> Item reduce(const Item &identity, Op op) const {
+#ifdef RUSTY_PARALLEL_HAS_STD_EXECUTION
+        return ::std::transform_reduce(
+            ::std::execution::par, first, first + len, identity,
+            [&](const Item &a, const Item &b) { return op(a, b); },
+            [&](T &value) { return static_cast<Item>(f(value)); });
+#else
+        auto partials = ::std::vector<Item>(chunks(), identity);
+        pool->for_each_chunk(len, partials.size(),
+                             [&](::std::size_t chunk, ::std::size_t begin,
+                                 ::std::size_t end) {
+                                 auto acc = identity;
+                                 for (auto i = begin; i < end; ++i) {
+                                     acc = op(acc, f(first[i]));
+                                 }
+                                 partials[chunk] = acc;
+                             });
+        auto acc = identity;
+        for (const auto &partial : partials) {
+            acc = op(acc, partial);
+        }
+        return acc;
+#endif
+    }
+
+    Item sum() const { return reduce(Item{}, detail::Plus{}); }
+
+    // items in order, into any container with a size constructor
+    template <typename C = ::std::vector<Item>> C collect() const {
+        auto out = C(len);
+        pool->for_each_chunk(len, chunks(),
+                             [&](::std::size_t, ::std::size_t begin,
+                                 ::std::size_t end) {
+                                 for (auto i = begin; i < end; ++i) {
+                                     out[i] = f(first[i]);
+                                 }
+                             });
+        return out;
+    }
+
+  private:
+    ::std::size_t chunks() const {
+        return detail::chunks_for(*pool, len, min_len);
+    }
+
+    T *first;
+    ::std::size_t len;
+    F f;
+    ThreadPool *pool;
+    ::std::size_t min_len;
+};
+
+// works with any contiguous container, e.g. Vec<u32> and Array<f64, N>
+template <typename C>
+ParIter<detail::ElementOf<C>> par_iter(C &container) {
+    return {container.data(), container.size()};
+}
+template <typename C>
+ParIter<detail::ElementOf<C>> par_iter(C &container, ThreadPool &pool) {
+    return {container.data(), container.size(), {}, &pool};
+}
+
+// chunks sorted in parallel, then merged pairwise a level at a time
+template <typename C, typename Compare>
+void par_sort_unstable_by(C &container, Compare compare,
+                          ThreadPool &pool = ThreadPool::global()) {
+    auto *first = container.data();
+    const auto n = static_cast<::std::size_t>(container.size());
+#ifdef RUSTY_PARALLEL_HAS_STD_EXECUTION
+    (void)pool;
+    ::std::sort(::std::execution::par, first, first + n, compare);
+#else
+    auto chunks = ::std::size_t{1};
+    while (chunks < pool.threads() && n / (chunks * 2) >= (1U << 14)) {
+        chunks *= 2;
+    }
+    const auto bound = [n, chunks](::std::size_t i) { return n * i / chunks; };
+    pool.for_each_chunk(n, chunks,
+                        [&](::std::size_t, ::std::size_t begin,
+                            ::std::size_t end) {
+                            ::std::sort(first + begin, first + end, compare);
+                        });
+    for (::std::size_t width = 1; width < chunks; width *= 2) {
+        const auto pairs = chunks / (width * 2);
+        pool.for_each_chunk(pairs, pairs,
+                            [&](::std::size_t pair, ::std::size_t,
+                                ::std::size_t) {
+                                const auto lo = pair * width * 2;
+                                ::std::inplace_merge(
+                                    first + bound(lo),
+                                    first + bound(lo + width),
+                                    first + bound(lo + width * 2), compare);
+                            });
+    }
+#endif
+}
+
+template <typename C>
+void par_sort_unstable(C &container, ThreadPool &pool = ThreadPool::global()) {
+    using T = detail::ElementOf<C>;
+    par_sort_unstable_by(container, ::std::less<T>{}, pool);
+}
+
+// in place inclusive scan in two blocked passes: chunk totals, then each
+// chunk rescanned from the total of the chunks before it
+template <typename C, typename Op>
+void par_inclusive_scan(C &container, Op op,
+                        ThreadPool &pool = ThreadPool::global()) {
+    using T = detail::ElementOf<C>;
+    auto *first = container.data();
+    const auto n = static_cast<::std::size_t>(container.size());
+    if (n == 0) {
+        return;
+    }
+    const auto chunks = detail::chunks_for(pool, n, detail::DEFAULT_MIN_LEN);
+    auto totals = ::std::vector<T>(chunks, first[0]);
+    if (chunks > 1) {
+        pool.for_each_chunk(n, chunks,
+                            [&](::std::size_t chunk, ::std::size_t begin,
+                                ::std::size_t end) {
+                                auto acc = first[begin];
+                                for (auto i = begin + 1; i < end; ++i) {
+                                    acc = op(acc, first[i]);
+                                }
+                                totals[chunk] = acc;
+                            });
+        for (::std::size_t i = 1; i < chunks; ++i) {
+            totals[i] = op(totals[i - 1], totals[i]);
+        }
+    }
+    pool.for_each_chunk(n, chunks,
+                        [&](::std::size_t chunk, ::std::size_t begin,
+                            ::std::size_t end) {
+                            auto acc = chunk > 0
+                                           ? op(totals[chunk - 1], first[begin])
+                                           : first[begin];
+                            first[begin] = acc;
+                            for (auto i = begin + 1; i < end; ++i) {
+                                acc = op(acc, first[i]);
+                                first[i] = acc;
+                            }
+                        });
+}
+
+template <typename C>
+void par_prefix_sum(C &container, ThreadPool &pool = ThreadPool::global()) {
+    par_inclusive_scan(container, detail::Plus{}, pool);
+}
+
+// counts of @bins buckets, @bucket maps an element to its index below @bins;
+// a private histogram per thread, summed at the end
+template <typename C, typename B>
+::std::vector<::std::size_t> par_histogram(const C &container,
+                                           ::std::size_t bins, B bucket,
+                                           ThreadPool &pool =
+                                               ThreadPool::global()) {
+    const auto *first = container.data();
+    const auto n = static_cast<::std::size_t>(container.size());
+    const auto chunks = ::std::min(
+        pool.threads(), (n + detail::DEFAULT_MIN_LEN - 1) /
+                            detail::DEFAULT_MIN_LEN);
+    auto counts = ::std::vector<::std::vector<::std::size_t>>(
+        ::std::max<::std::size_t>(chunks, 1),
+        ::std::vector<::std::size_t>(bins));
+    pool.for_each_chunk(n, counts.size(),
+                        [&](::std::size_t chunk, ::std::size_t begin,
+                            ::std::size_t end) {
+                            auto &local = counts[chunk];
+                            for (auto i = begin; i < end; ++i) {
+                                ++local[bucket(first[i])];
+                            }
+                        });
+    for (::std::size_t i = 1; i < counts.size(); ++i) {
+        for (::std::size_t b = 0; b < bins; ++b) {
+            counts[0][b] += counts[i][b];
+        }
+    }
+    return ::std::move(counts[0]);
+}
+
+} // namespace rusty::parallel
+
+// dbg backend lives in debug.hpp, configured by RUSTY_DBG_LEVEL,
+// RUSTY_DBG_RATE_LIMIT, RUSTY_DBG_ASYNC and RUSTY_DBG_METRICS
+
+// defaults of debug.hpp, repeated for `import rusty;` which exports no macro
+#ifndef RUSTY_DBG_LEVEL
+#define RUSTY_DBG_LEVEL 1
+#endif
+#ifndef RUSTY_DBG_RATE_LIMIT
+#define RUSTY_DBG_RATE_LIMIT 0
+#endif
+
+#if RUSTY_DBG_LEVEL <= 0
+#define dbg_level(level, x, ...) (x)
+#define dbg(x, ...) (x)
+#else
+// @x is evaluated once and forwarded: lvalues by reference, temporaries
+// moved; it is never named in an unevaluated context, so it may hold lambdas
+#define RUSTY_DBG_IMPL(level, expr, x, ...)                                    \
+    ::rusty::debug::forward_record(                                            \
+        (level) <= RUSTY_DBG_LEVEL,                                            \
+        []() -> ::rusty::debug::RateLimit & {                                  \
+            static ::rusty::debug::RateLimit limit;                            \
+            return limit;                                                      \
+        },                                                                     \
+        RUSTY_DBG_RATE_LIMIT, __FILE__, __LINE__, expr,                        \
+        sizeof(#__VA_ARGS__) > 1,                                              \
+        [&](::std::ostream &rusty_dbg_stream) -> ::std::ostream & {            \
+            return rusty_dbg_stream __VA_ARGS__;                               \
+        },                                                                     \
+        (x))
+#define dbg_level(level, x, ...) RUSTY_DBG_IMPL(level, #x, x, __VA_ARGS__)
+#define dbg(x, ...) RUSTY_DBG_IMPL(1, #x, x, __VA_ARGS__)
+#endif
+
+// dbg_time(name) times the rest of the enclosing scope, dbg_count(name)
+// counts executions and dbg_hist(name, value) records a distribution of
+// unsigned values. Without RUSTY_DBG_METRICS (see debug.hpp) they expand
+// to nothing and @value is not evaluated.
+#ifdef RUSTY_DBG_METRICS
+#define RUSTY_DBG_CAT_IMPL(a, b) a##b
+#define RUSTY_DBG_CAT(a, b) RUSTY_DBG_CAT_IMPL(a, b)
+#define RUSTY_DBG_SITE(name, kind)                                             \
+    static const ::rusty::debug::MetricSite RUSTY_DBG_CAT(rusty_dbg_site_,    \
+                                                          __LINE__)(           \
+        name, ::rusty::debug::MetricKind::kind, __FILE__, __LINE__)
+#define dbg_time(name)                                                         \
+    RUSTY_DBG_SITE(name, Time);                                                \
+    const ::rusty::debug::ScopedTimer RUSTY_DBG_CAT(rusty_dbg_timer_,          \
+                                                    __LINE__)(                 \
+        RUSTY_DBG_CAT(rusty_dbg_site_, __LINE__))
+#define dbg_count(name)                                                        \
+    do {                                                                       \
+        RUSTY_DBG_SITE(name, Count);                                           \
+        ::rusty::debug::count_metric(RUSTY_DBG_CAT(rusty_dbg_site_, __LINE__)); \
+    } while (false)
+#define dbg_hist(name, value)                                                  \
+    do {                                                                       \
+        RUSTY_DBG_SITE(name, Hist);                                            \
+        ::rusty::debug::record_metric(RUSTY_DBG_CAT(rusty_dbg_site_, __LINE__), \
+                                      static_cast<unsigned long long>(value)); \
+    } while (false)
+#else
+#define dbg_time(name) static_cast<void>(0)
+#define dbg_count(name) static_cast<void>(0)
+#define dbg_hist(name, value) static_cast<void>(sizeof(value))
+#endif
+
+#define assert_eq(left, right) assert((left) == (right))
+#define assert_ne(left, right) assert(!((left) == (right)))
+
 #ifdef RUSTY_USE_DEFAULT_USING
 
 using namespace ::rusty::numeric_types;
 using namespace ::rusty::numeric_types::literal;
+using namespace ::rusty::hash;
+using namespace ::rusty::alloc;
 using namespace ::rusty::collections;
 using namespace ::rusty::collections::ostream;
+using namespace ::rusty::io;
+using namespace ::rusty::iter;
+using namespace ::rusty::parallel;
 
 #endif
 
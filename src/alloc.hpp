@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: MIT
+// Copyright(c) 2021 ur4t
+
+#ifndef __RUSTY_ALLOC_HPP__
+#define __RUSTY_ALLOC_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define RUSTY_ALLOC_HAS_PMR
+#endif
+#endif
+
+namespace rusty::alloc {
+
+// Bump allocator: allocation moves a pointer, deallocation does nothing and
+// everything is released at once by reset() or a Scope. Chunks are kept
+// and reused after a reset, so steady state allocates no memory at all.
+#ifdef RUSTY_ALLOC_HAS_PMR
+class Arena : public ::std::pmr::memory_resource {
+#else
+class Arena {
+#endif
+  public:
+    static constexpr ::std::size_t DEFAULT_CHUNK = 64 << 10;
+
+    // position to rewind to
+    struct Mark {
+        ::std::size_t chunk;
+        ::std::size_t offset;
+    };
+
+    // rewinds the arena on destruction, releasing what the scope allocated
+    class Scope {
+      public:
+        explicit Scope(Arena &arena) : arena(arena), mark(arena.mark()) {}
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+        ~Scope() { arena.rewind(mark); }
+
+      private:
+        Arena &arena;
+        Mark mark;
+    };
+
+    explicit Arena(::std::size_t chunk_size = DEFAULT_CHUNK)
+        : chunk_size(chunk_size) {}
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+#ifdef RUSTY_ALLOC_HAS_PMR
+    ~Arena() override {
+#else
+    ~Arena() {
+#endif
+        for (const auto &chunk : chunks) {
+            ::operator delete(chunk.data);
+        }
+    }
+
+    void *allocate(::std::size_t bytes,
+                   ::std::size_t align = alignof(::std::max_align_t)) {
+        const auto p = align_up(cur, align);
+        if (cur != 0 && p + bytes <= end) {
+            cur = p + bytes;
+            return reinterpret_cast<void *>(p); // NOLINT
+        }
+        return allocate_slow(bytes, align);
+    }
+
+    Mark mark() const noexcept {
+        return {current, chunks.empty() ? 0
+                                        : static_cast<::std::size_t>(
+                                              cur - as_int(chunks[current]))};
+    }
+    void rewind(const Mark &mark) noexcept {
+        if (!chunks.empty()) {
+            current = mark.chunk;
+            cur = as_int(chunks[current]) + mark.offset;
+            end = as_int(chunks[current]) + chunks[current].size;
+        }
+    }
+    // release everything in O(1), chunks stay for reuse
+    void reset() noexcept { rewind(Mark{0, 0}); }
+
+    // bytes reserved from the system
+    ::std::size_t capacity() const noexcept {
+        auto total = ::std::size_t{0};
+        for (const auto &chunk : chunks) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+#ifdef RUSTY_ALLOC_HAS_PMR
+  protected:
+    void *do_allocate(::std::size_t bytes, ::std::size_t align) override {
+        return allocate(bytes, align);
+    }
+    void do_deallocate(void * /*p*/, ::std::size_t /*bytes*/,
+                       ::std::size_t /*align*/) override {}
+    bool do_is_equal(const ::std::pmr::memory_resource &other)
+        const noexcept override {
+        return this == &other;
+    }
+#endif
+
+  private:
+    struct Chunk {
+        void *data;
+        ::std::size_t size;
+    };
+
+    static ::std::uintptr_t as_int(const Chunk &chunk) noexcept {
+        return reinterpret_cast<::std::uintptr_t>(chunk.data); // NOLINT
+    }
+    static ::std::uintptr_t align_up(::std::uintptr_t p,
+                                     ::std::size_t align) noexcept {
+        return (p + align - 1) & ~static_cast<::std::uintptr_t>(align - 1);
+    }
+
+    // next chunk with room, reused after a rewind or freshly allocated
+    void *allocate_slow(::std::size_t bytes, ::std::size_t align) {
+        const auto needed = bytes + align - 1;
+        auto next = chunks.empty() ? 0 : current + 1;
+        if (next == chunks.size() || chunks[next].size < needed) {
+            const auto size = ::std::max(chunk_size, needed);
+            chunks.insert(chunks.begin() + static_cast<::std::ptrdiff_t>(next),
+                          Chunk{::operator new(size), size});
+        }
+        current = next;
+        cur = as_int(chunks[current]);
+        end = cur + chunks[current].size;
+        const auto p = align_up(cur, align);
+        cur = p + bytes;
+        return reinterpret_cast<void *>(p); // NOLINT
+    }
+
+    ::std::size_t chunk_size;
+    ::std::vector<Chunk> chunks;
+    ::std::size_t current = 0;
+    ::std::uintptr_t cur = 0;
+    ::std::uintptr_t end = 0;
+};
+
+// std allocator drawing from an Arena, for containers without pmr
+template <typename T> class ArenaAllocator {
+  public:
+    using value_type = T;
+
+    ArenaAllocator(Arena *arena) noexcept // NOLINT(google-explicit-constructor)
+        : arena(arena) {}
+    template <typename U>
+    ArenaAllocator( // NOLINT(google-explicit-constructor)
+        const ArenaAllocator<U> &other) noexcept
+        : arena(other.arena) {}
+
+    T *allocate(::std::size_t n) {
+        return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T * /*p*/, ::std::size_t /*n*/) noexcept {}
+
+    template <typename U>
+    friend bool operator==(const ArenaAllocator &a,
+                           const ArenaAllocator<U> &b) noexcept {
+        return a.arena == b.arena;
+    }
+    template <typename U>
+    friend bool operator!=(const ArenaAllocator &a,
+                           const ArenaAllocator<U> &b) noexcept {
+        return a.arena != b.arena;
+    }
+
+    Arena *arena;
+};
+
+// Collections allocating from an Arena, constructed like `Vec<T> v(&arena)`,
+// pmr containers when available
+namespace arena {
+
+#ifdef RUSTY_ALLOC_HAS_PMR
+template <typename T> using Allocator = ::std::pmr::polymorphic_allocator<T>;
+#else
+template <typename T> using Allocator = ArenaAllocator<T>;
+#endif
+
+template <typename T> using Vec = ::std::vector<T, Allocator<T>>;
+template <typename K, typename V, template <typename> class H = ::std::hash>
+using HashMap = ::std::unordered_map<K, V, H<K>, ::std::equal_to<K>,
+                                     Allocator<::std::pair<const K, V>>>;
+using String =
+    ::std::basic_string<char, ::std::char_traits<char>, Allocator<char>>;
+
+} // namespace arena
+
+} // namespace rusty::alloc
+
+#endif // __RUSTY_ALLOC_HPP__
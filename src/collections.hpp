@@ -4,47 +4,1372 @@
 #ifndef __RUSTY_COLLECTIONS_HPP__
 #define __RUSTY_COLLECTIONS_HPP__
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <ostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "hash.hpp"
+#include "numeric_types.hpp"
+
 namespace rusty::collections {
 
 template <typename T1, typename T2> using Pair = ::std::pair<T1, T2>;
 template <typename T, ::std::size_t N> using Array = ::std::array<T, N>;
 template <typename T> using Vec = ::std::vector<T>;
-template <typename K, typename V> using HashMap = ::std::unordered_map<K, V>;
+
+namespace detail {
+
+// FlatHashMap control bytes: free slots have the sign bit set, full slots
+// hold the low 7 bits of their hash
+constexpr ::std::int8_t CTRL_EMPTY = -128;
+constexpr ::std::int8_t CTRL_DELETED = -2;
+
+inline unsigned trailing_zeros(::std::uint32_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctz(bits));
+#else
+    auto n = 0U;
+    for (; !(bits & 1U); bits >>= 1U) {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// 16 control bytes probed at once, bit i of a match is set for byte i
+struct Group {
+    static constexpr ::std::size_t WIDTH = 16;
+
+#ifdef __SSE2__
+    explicit Group(const ::std::int8_t *ctrl)
+        : ctrl(_mm_load_si128(
+              reinterpret_cast<const __m128i *>(ctrl))) {} // NOLINT
+
+    ::std::uint32_t match(::std::int8_t h2) const {
+        return static_cast<::std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2))));
+    }
+    ::std::uint32_t match_free() const {
+        return static_cast<::std::uint32_t>(_mm_movemask_epi8(ctrl));
+    }
+
+    __m128i ctrl;
+#else
+    // plain loops, left for the compiler to vectorize
+    explicit Group(const ::std::int8_t *ctrl) : ctrl(ctrl) {}
+
+    ::std::uint32_t match(::std::int8_t h2) const {
+        auto bits = ::std::uint32_t{0};
+        for (::std::size_t i = 0; i < WIDTH; ++i) {
+            bits |= static_cast<::std::uint32_t>(ctrl[i] == h2) << i;
+        }
+        return bits;
+    }
+    ::std::uint32_t match_free() const {
+        auto bits = ::std::uint32_t{0};
+        for (::std::size_t i = 0; i < WIDTH; ++i) {
+            bits |= static_cast<::std::uint32_t>(ctrl[i] < 0) << i;
+        }
+        return bits;
+    }
+
+    const ::std::int8_t *ctrl;
+#endif
+
+    ::std::uint32_t match_empty() const { return match(CTRL_EMPTY); }
+};
+
+// hashers declaring is_avalanching already spread every input bit
+template <typename H, typename = void>
+struct IsAvalanching : ::std::false_type {};
+template <typename H>
+struct IsAvalanching<H, decltype(void(typename H::is_avalanching{}))>
+    : H::is_avalanching {};
+
+// control bytes of every table without storage, never written
+inline ::std::int8_t *empty_group() {
+    alignas(Group::WIDTH) static ::std::int8_t group[Group::WIDTH] = { // NOLINT
+        CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY,
+        CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY,
+        CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY,
+        CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY};
+    return group;
+}
+
+} // namespace detail
+
+// Open addressing hash map with the std::unordered_map interface subset we
+// use. Entries live inline in one allocation next to a control byte each;
+// lookups compare 16 control bytes per probe and touch an entry only on a
+// 7-bit hash match. Iterators and references are invalidated by rehashing.
+template <typename K, typename V, typename Hash = ::std::hash<K>,
+          typename KeyEqual = ::std::equal_to<K>>
+class FlatHashMap {
+  public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = Pair<const K, V>;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+
+    template <bool Const> class Iter {
+      public:
+        using iterator_category = ::std::forward_iterator_tag;
+        using value_type = FlatHashMap::value_type;
+        using difference_type = ::std::ptrdiff_t;
+        using pointer = typename ::std::conditional<Const, const value_type *,
+                                                    value_type *>::type;
+        using reference = typename ::std::conditional<Const, const value_type &,
+                                                      value_type &>::type;
+
+        Iter() = default;
+        template <bool C = Const, typename = numeric_types::enable_if_t<C>>
+        Iter(const Iter<false> &other) // NOLINT(google-explicit-constructor)
+            : ctrl(other.ctrl), end(other.end), slot(other.slot) {}
+
+        reference operator*() const { return *slot; }
+        pointer operator->() const { return slot; }
+
+        Iter &operator++() {
+            ++ctrl;
+            ++slot;
+            skip();
+            return *this;
+        }
+        Iter operator++(int) {
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+
+        friend bool operator==(const Iter &a, const Iter &b) {
+            return a.slot == b.slot;
+        }
+        friend bool operator!=(const Iter &a, const Iter &b) {
+            return a.slot != b.slot;
+        }
+
+      private:
+        friend class FlatHashMap;
+        template <bool> friend class Iter;
+
+        Iter(const ::std::int8_t *ctrl, const ::std::int8_t *end, pointer slot)
+            : ctrl(ctrl), end(end), slot(slot) {
+            skip();
+        }
+
+        void skip() {
+            while (ctrl != end && *ctrl < 0) {
+                ++ctrl;
+                ++slot;
+            }
+        }
+
+        const ::std::int8_t *ctrl = nullptr;
+        const ::std::int8_t *end = nullptr;
+        pointer slot = nullptr;
+    };
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+
+    FlatHashMap() = default;
+    explicit FlatHashMap(size_type n, const Hash &hash = Hash{},
+                         const KeyEqual &eq = KeyEqual{})
+        : hash(hash), eq(eq) {
+        reserve(n);
+    }
+    template <typename It,
+              typename = numeric_types::enable_if_t<!::std::is_integral<It>::value>>
+    FlatHashMap(It first, It last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+    FlatHashMap(::std::initializer_list<value_type> list)
+        : FlatHashMap(list.size()) {
+        for (const auto &i : list) {
+            insert(i);
+        }
+    }
+    FlatHashMap(const FlatHashMap &other)
+        : FlatHashMap(other.len, other.hash, other.eq) {
+        for (const auto &i : other) {
+            insert(i);
+        }
+    }
+    FlatHashMap(FlatHashMap &&other) noexcept
+        : hash(other.hash), eq(other.eq) {
+        swap(other);
+    }
+    FlatHashMap &operator=(FlatHashMap other) noexcept {
+        swap(other);
+        return *this;
+    }
+    ~FlatHashMap() {
+        destroy();
+        deallocate(ctrl, cap);
+    }
+
+    iterator begin() { return {ctrl, ctrl + cap, slots}; }
+    iterator end() { return {ctrl + cap, ctrl + cap, slots + cap}; }
+    const_iterator begin() const { return {ctrl, ctrl + cap, slots}; }
+    const_iterator end() const { return {ctrl + cap, ctrl + cap, slots + cap}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    bool empty() const noexcept { return len == 0; }
+    size_type size() const noexcept { return len; }
+    size_type capacity() const noexcept { return cap; }
+    hasher hash_function() const { return hash; }
+    key_equal key_eq() const { return eq; }
+
+    void clear() noexcept {
+        destroy();
+        if (cap > 0) {
+            ::std::memset(ctrl, detail::CTRL_EMPTY, cap);
+        }
+        len = 0;
+        growth_left = max_load(cap);
+    }
+
+    // room for @n entries without rehashing
+    void reserve(size_type n) {
+        if (n > len + growth_left) {
+            auto capacity = detail::Group::WIDTH;
+            while (max_load(capacity) < n) {
+                capacity *= 2;
+            }
+            rehash(capacity);
+        }
+    }
+
+    iterator find(const K &key) {
+        const auto i = find_index(key, hash_of(key));
+        return i == NPOS ? end() : iterator_at(i);
+    }
+    const_iterator find(const K &key) const {
+        const auto i = find_index(key, hash_of(key));
+        return i == NPOS ? end() : const_iterator{ctrl + i, ctrl + cap,
+                                                  slots + i};
+    }
+    size_type count(const K &key) const {
+        return find_index(key, hash_of(key)) != NPOS ? 1 : 0;
+    }
+    bool contains(const K &key) const { return count(key) != 0; }
+
+    V &at(const K &key) {
+        const auto i = find_index(key, hash_of(key));
+        if (i == NPOS) {
+            throw ::std::out_of_range("rusty::collections: key not found");
+        }
+        return slots[i].second;
+    }
+    const V &at(const K &key) const {
+        return const_cast<FlatHashMap &>(*this).at(key); // NOLINT
+    }
+    V &operator[](const K &key) { return try_emplace(key).first->second; }
+    V &operator[](K &&key) {
+        return try_emplace(::std::move(key)).first->second;
+    }
+
+    template <typename... Args>
+    Pair<iterator, bool> try_emplace(const K &key, Args &&...args) {
+        return emplace_key(key, ::std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    Pair<iterator, bool> try_emplace(K &&key, Args &&...args) {
+        return emplace_key(::std::move(key), ::std::forward<Args>(args)...);
+    }
+    template <typename... Args> Pair<iterator, bool> emplace(Args &&...args) {
+        auto value = value_type(::std::forward<Args>(args)...);
+        return emplace_key(value.first, ::std::move(value.second));
+    }
+    Pair<iterator, bool> insert(const value_type &value) {
+        return emplace_key(value.first, value.second);
+    }
+    Pair<iterator, bool> insert(value_type &&value) {
+        return emplace_key(value.first, ::std::move(value.second));
+    }
+    template <typename M>
+    Pair<iterator, bool> insert_or_assign(const K &key, M &&value) {
+        auto result = emplace_key(key, ::std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = ::std::forward<M>(value);
+        }
+        return result;
+    }
+
+    size_type erase(const K &key) {
+        const auto i = find_index(key, hash_of(key));
+        if (i == NPOS) {
+            return 0;
+        }
+        erase_at(i);
+        return 1;
+    }
+    iterator erase(const_iterator pos) {
+        const auto i = static_cast<size_type>(pos.slot - slots);
+        erase_at(i);
+        return {ctrl + i, ctrl + cap, slots + i};
+    }
+
+    void swap(FlatHashMap &other) noexcept {
+        using ::std::swap;
+        swap(ctrl, other.ctrl);
+        swap(slots, other.slots);
+        swap(cap, other.cap);
+        swap(len, other.len);
+        swap(growth_left, other.growth_left);
+        swap(group_mask, other.group_mask);
+        swap(hash, other.hash);
+        swap(eq, other.eq);
+    }
+
+    friend bool operator==(const FlatHashMap &a, const FlatHashMap &b) {
+        if (a.len != b.len) {
+            return false;
+        }
+        for (const auto &i : a) {
+            const auto it = b.find(i.first);
+            if (it == b.end() || !(it->second == i.second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    friend bool operator!=(const FlatHashMap &a, const FlatHashMap &b) {
+        return !(a == b);
+    }
+
+  private:
+    static constexpr size_type NPOS = ~size_type{0};
+    static constexpr size_type WIDTH = detail::Group::WIDTH;
+
+    // storage unit keeping control bytes aligned for group loads
+    struct alignas(WIDTH) Block {
+        unsigned char bytes[WIDTH]; // NOLINT(modernize-avoid-c-arrays)
+    };
+    static_assert(alignof(value_type) <= alignof(Block),
+                  "over-aligned entries are not supported");
+
+    // 7/8 load factor, always leaving empty slots to end probing
+    static size_type max_load(size_type capacity) {
+        return capacity - capacity / 8;
+    }
+    static size_type blocks(size_type capacity) {
+        return (capacity + capacity * sizeof(value_type) + WIDTH - 1) / WIDTH;
+    }
+
+    // multiplicative fold, so identity hashes of integers still spread
+    // over both the probe start and the 7 bits kept in control bytes
+    ::std::uint64_t hash_of(const K &key) const {
+        const auto h = static_cast<::std::uint64_t>(hash(key));
+        if (detail::IsAvalanching<Hash>::value) {
+            return h;
+        }
+        const auto folded = h * 0x9e3779b97f4a7c15ULL;
+        return folded ^ (folded >> 32U);
+    }
+    static ::std::int8_t h2_of(::std::uint64_t h) {
+        return static_cast<::std::int8_t>(h & 0x7fU);
+    }
+    size_type first_group(::std::uint64_t h) const {
+        return static_cast<size_type>(h >> 7U) & group_mask;
+    }
+
+    iterator iterator_at(size_type i) {
+        return {ctrl + i, ctrl + cap, slots + i};
+    }
+
+    // triangular probing over groups visits each group once
+    size_type find_index(const K &key, ::std::uint64_t h) const {
+        const auto h2 = h2_of(h);
+        auto group = first_group(h);
+        for (size_type step = 1;; ++step) {
+            const detail::Group probe(ctrl + group * WIDTH);
+            for (auto bits = probe.match(h2); bits; bits &= bits - 1) {
+                const auto i = group * WIDTH + detail::trailing_zeros(bits);
+                if (eq(slots[i].first, key)) {
+                    return i;
+                }
+            }
+            if (probe.match_empty()) {
+                return NPOS;
+            }
+            group = (group + step) & group_mask;
+        }
+    }
+
+    size_type find_free(::std::uint64_t h) const {
+        auto group = first_group(h);
+        for (size_type step = 1;; ++step) {
+            const auto bits = detail::Group(ctrl + group * WIDTH).match_free();
+            if (bits) {
+                return group * WIDTH + detail::trailing_zeros(bits);
+            }
+            group = (group + step) & group_mask;
+        }
+    }
+
+    template <typename Key, typename... Args>
+    Pair<iterator, bool> emplace_key(Key &&key, Args &&...args) {
+        const auto h = hash_of(key);
+        auto i = find_index(key, h);
+        if (i != NPOS) {
+            return {iterator_at(i), false};
+        }
+        i = find_free(h);
+        if (growth_left == 0 && ctrl[i] == detail::CTRL_EMPTY) {
+            // mostly tombstones: clean up in place, otherwise double
+            rehash(len * 2 < max_load(cap) ? cap
+                   : cap > 0                ? cap * 2
+                                            : WIDTH);
+            i = find_free(h);
+        }
+        new (slots + i) value_type(
+            ::std::piecewise_construct,
+            ::std::forward_as_tuple(::std::forward<Key>(key)),
+            ::std::forward_as_tuple(::std::forward<Args>(args)...));
+        growth_left -= ctrl[i] == detail::CTRL_EMPTY ? 1 : 0;
+        ctrl[i] = h2_of(h);
+        ++len;
+        return {iterator_at(i), true};
+    }
+
+    void erase_at(size_type i) {
+        slots[i].~value_type();
+        --len;
+        // probing already stops at this group when it has an empty slot
+        if (detail::Group(ctrl + i / WIDTH * WIDTH).match_empty()) {
+            ctrl[i] = detail::CTRL_EMPTY;
+            ++growth_left;
+        } else {
+            ctrl[i] = detail::CTRL_DELETED;
+        }
+    }
+
+    void rehash(size_type capacity) {
+        auto *const old_ctrl = ctrl;
+        auto *const old_slots = slots;
+        const auto old_cap = cap;
+        auto *const block = ::std::allocator<Block>{}.allocate(blocks(capacity));
+        ctrl = reinterpret_cast<::std::int8_t *>(block); // NOLINT
+        slots = reinterpret_cast<value_type *>(ctrl + capacity); // NOLINT
+        cap = capacity;
+        group_mask = capacity / WIDTH - 1;
+        growth_left = max_load(capacity) - len;
+        ::std::memset(ctrl, detail::CTRL_EMPTY, capacity);
+        for (size_type i = 0; i < old_cap; ++i) {
+            if (old_ctrl[i] >= 0) {
+                const auto h = hash_of(old_slots[i].first);
+                const auto j = find_free(h);
+                new (slots + j) value_type(::std::move(old_slots[i]));
+                ctrl[j] = h2_of(h);
+                old_slots[i].~value_type();
+            }
+        }
+        deallocate(old_ctrl, old_cap);
+    }
+
+    void destroy() noexcept {
+        if (!::std::is_trivially_destructible<value_type>::value) {
+            for (size_type i = 0; i < cap; ++i) {
+                if (ctrl[i] >= 0) {
+                    slots[i].~value_type();
+                }
+            }
+        }
+    }
+
+    static void deallocate(::std::int8_t *ctrl, size_type capacity) {
+        if (capacity > 0) {
+            ::std::allocator<Block>{}.deallocate(
+                reinterpret_cast<Block *>(ctrl), // NOLINT
+                blocks(capacity));
+        }
+    }
+
+    ::std::int8_t *ctrl = detail::empty_group();
+    value_type *slots = nullptr;
+    size_type cap = 0;
+    size_type len = 0;
+    size_type growth_left = 0;
+    size_type group_mask = 0;
+    Hash hash;
+    KeyEqual eq;
+};
+
+// @H is a hasher family from hash.hpp or std::hash, define
+// RUSTY_FAST_HASHMAP to back HashMap by FlatHashMap
+#ifdef RUSTY_FAST_HASHMAP
+template <typename K, typename V, template <typename> class H = ::std::hash>
+using HashMap = FlatHashMap<K, V, H<K>>;
+#else
+template <typename K, typename V, template <typename> class H = ::std::hash>
+using HashMap = ::std::unordered_map<K, V, H<K>>;
+#endif
+
+// Vector keeping up to @N elements inline, spilling to the heap beyond.
+// Moving an inline vector moves its elements one by one.
+template <typename T, ::std::size_t N> class SmallVec {
+    static_assert(N > 0, "use Vec without inline storage");
+
+  public:
+    using value_type = T;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using iterator = T *;
+    using const_iterator = const T *;
+    using reverse_iterator = ::std::reverse_iterator<iterator>;
+    using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+
+    SmallVec() noexcept {} // NOLINT(modernize-use-equals-default), no zeroing
+    explicit SmallVec(size_type n) { resize(n); }
+    SmallVec(size_type n, const T &value) { assign(n, value); }
+    template <typename It,
+              typename = numeric_types::enable_if_t<!::std::is_integral<It>::value>>
+    SmallVec(It first, It last) {
+        assign(first, last);
+    }
+    SmallVec(::std::initializer_list<T> list) {
+        assign(list.begin(), list.end());
+    }
+    SmallVec(const SmallVec &other) { assign(other.begin(), other.end()); }
+    SmallVec(SmallVec &&other) noexcept(
+        ::std::is_nothrow_move_constructible<T>::value) {
+        take(other);
+    }
+    SmallVec &operator=(const SmallVec &other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+    SmallVec &operator=(SmallVec &&other) noexcept(
+        ::std::is_nothrow_move_constructible<T>::value) {
+        if (this != &other) {
+            clear();
+            release();
+            take(other);
+        }
+        return *this;
+    }
+    SmallVec &operator=(::std::initializer_list<T> list) {
+        assign(list.begin(), list.end());
+        return *this;
+    }
+    ~SmallVec() {
+        clear();
+        release();
+    }
+
+    template <typename It> void assign(It first, It last) {
+        clear();
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+    void assign(size_type n, const T &value) {
+        clear();
+        reserve(n);
+        for (size_type i = 0; i < n; ++i) {
+            new (ptr + i) T(value);
+            ++len;
+        }
+    }
+
+    iterator begin() noexcept { return ptr; }
+    iterator end() noexcept { return ptr + len; }
+    const_iterator begin() const noexcept { return ptr; }
+    const_iterator end() const noexcept { return ptr + len; }
+    const_iterator cbegin() const noexcept { return ptr; }
+    const_iterator cend() const noexcept { return ptr + len; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    bool empty() const noexcept { return len == 0; }
+    size_type size() const noexcept { return len; }
+    size_type capacity() const noexcept { return cap; }
+    static constexpr size_type inline_capacity() noexcept { return N; }
+    // whether the elements moved to the heap
+    bool spilled() const noexcept { return ptr != inline_data(); }
+
+    T *data() noexcept { return ptr; }
+    const T *data() const noexcept { return ptr; }
+    T &operator[](size_type i) noexcept { return ptr[i]; }
+    const T &operator[](size_type i) const noexcept { return ptr[i]; }
+    T &at(size_type i) {
+        check(i);
+        return ptr[i];
+    }
+    const T &at(size_type i) const {
+        check(i);
+        return ptr[i];
+    }
+    T &front() noexcept { return ptr[0]; }
+    const T &front() const noexcept { return ptr[0]; }
+    T &back() noexcept { return ptr[len - 1]; }
+    const T &back() const noexcept { return ptr[len - 1]; }
+
+    void reserve(size_type n) {
+        if (n > cap) {
+            relocate(n);
+        }
+    }
+    // back to inline storage when the elements fit
+    void shrink_to_fit() {
+        if (spilled() && len < cap) {
+            relocate(len);
+        }
+    }
+
+    void push_back(const T &value) { emplace_back(value); }
+    void push_back(T &&value) { emplace_back(::std::move(value)); }
+    template <typename... Args> T &emplace_back(Args &&...args) {
+        if (len == cap) {
+            // @args may alias an element, construct before relocating
+            T value(::std::forward<Args>(args)...);
+            relocate(cap * 2);
+            new (ptr + len) T(::std::move(value));
+        } else {
+            new (ptr + len) T(::std::forward<Args>(args)...);
+        }
+        return ptr[len++];
+    }
+    void pop_back() noexcept { ptr[--len].~T(); }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args &&...args) {
+        const auto i = static_cast<size_type>(pos - ptr);
+        emplace_back(::std::forward<Args>(args)...);
+        ::std::rotate(ptr + i, ptr + len - 1, ptr + len);
+        return ptr + i;
+    }
+    iterator insert(const_iterator pos, const T &value) {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, T &&value) {
+        return emplace(pos, ::std::move(value));
+    }
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last) {
+        auto *const begin = ptr + (first - ptr);
+        if (first == last) {
+            return begin; // moving onto itself would empty moved-from types
+        }
+        auto *const rest = ::std::move(ptr + (last - ptr), end(), begin);
+        while (end() != rest) {
+            pop_back();
+        }
+        return begin;
+    }
+
+    void resize(size_type n) {
+        reserve(n);
+        while (len < n) {
+            emplace_back();
+        }
+        while (len > n) {
+            pop_back();
+        }
+    }
+    void resize(size_type n, const T &value) {
+        reserve(n);
+        while (len < n) {
+            emplace_back(value);
+        }
+        while (len > n) {
+            pop_back();
+        }
+    }
+    void clear() noexcept {
+        while (len > 0) {
+            pop_back();
+        }
+    }
+
+    void swap(SmallVec &other) noexcept(
+        ::std::is_nothrow_move_constructible<T>::value) {
+        auto tmp = ::std::move(other);
+        other = ::std::move(*this);
+        *this = ::std::move(tmp);
+    }
+
+    friend bool operator==(const SmallVec &a, const SmallVec &b) {
+        return a.len == b.len && ::std::equal(a.begin(), a.end(), b.begin());
+    }
+    friend bool operator!=(const SmallVec &a, const SmallVec &b) {
+        return !(a == b);
+    }
+    friend bool operator<(const SmallVec &a, const SmallVec &b) {
+        return ::std::lexicographical_compare(a.begin(), a.end(), b.begin(),
+                                              b.end());
+    }
+
+  private:
+    T *inline_data() noexcept {
+        return reinterpret_cast<T *>(storage); // NOLINT
+    }
+    const T *inline_data() const noexcept {
+        return reinterpret_cast<const T *>(storage); // NOLINT
+    }
+
+    void check(size_type i) const {
+        if (i >= len) {
+            throw ::std::out_of_range("rusty::collections: index out of range");
+        }
+    }
+
+    // move the elements into inline storage if @n fits, else onto the heap;
+    // a throwing copy leaves the vector unchanged like std::vector
+    void relocate(size_type n) {
+        auto *const next =
+            n <= N ? inline_data() : ::std::allocator<T>{}.allocate(n);
+        auto built = size_type{0};
+        try {
+            for (; built < len; ++built) {
+                new (next + built) T(::std::move_if_noexcept(ptr[built]));
+            }
+        } catch (...) {
+            for (size_type i = 0; i < built; ++i) {
+                next[i].~T();
+            }
+            if (n > N) {
+                ::std::allocator<T>{}.deallocate(next, n);
+            }
+            throw;
+        }
+        for (size_type i = 0; i < len; ++i) {
+            ptr[i].~T();
+        }
+        release();
+        ptr = next;
+        cap = n <= N ? N : n;
+    }
+
+    void release() noexcept {
+        if (spilled()) {
+            ::std::allocator<T>{}.deallocate(ptr, cap);
+        }
+        ptr = inline_data();
+        cap = N;
+    }
+
+    // steal the heap buffer of @other or move its inline elements
+    void take(SmallVec &other) {
+        if (other.spilled()) {
+            ptr = other.ptr;
+            cap = other.cap;
+            len = other.len;
+            other.ptr = other.inline_data();
+            other.cap = N;
+            other.len = 0;
+        } else {
+            for (size_type i = 0; i < other.len; ++i) {
+                new (ptr + i) T(::std::move(other.ptr[i]));
+            }
+            len = other.len;
+            other.clear();
+        }
+    }
+
+    alignas(T) unsigned char storage[N * sizeof(T)]; // NOLINT
+    T *ptr = inline_data();
+    size_type len = 0;
+    size_type cap = N;
+};
+
+// Borrowed view of contiguous elements like rust &[T], const T for a
+// read only one
+template <typename T> class Slice {
+  public:
+    using value_type = typename ::std::remove_const<T>::type;
+    using size_type = ::std::size_t;
+    using iterator = T *;
+    using const_iterator = T *;
+
+    constexpr Slice() noexcept = default;
+    constexpr Slice(T *data, size_type len) noexcept : ptr(data), len(len) {}
+
+    constexpr T *data() const noexcept { return ptr; }
+    constexpr size_type size() const noexcept { return len; }
+    constexpr bool empty() const noexcept { return len == 0; }
+    constexpr T &operator[](size_type i) const noexcept { return ptr[i]; }
+    constexpr T *begin() const noexcept { return ptr; }
+    constexpr T *end() const noexcept { return ptr + len; }
+
+  private:
+    T *ptr = nullptr;
+    size_type len = 0;
+};
+
+// Columnar binary serialization of Number<T> collections through the io
+// readers and writers. A column is a 16 byte header (magic "RCOL", endian
+// tag, element kind and size, little-endian u64 count) followed by the
+// elements as one block padded to 16 bytes, written little-endian (byte
+// swapped on big-endian hosts). A map is its keys column then its values
+// column. Columns saved from a 16 byte aligned offset stay aligned, so a
+// mmap region is read in place by view(). Malformed input throws
+// ::std::invalid_argument, truncated input ::std::out_of_range.
+namespace detail {
+
+constexpr ::std::size_t COLUMN_ALIGN = 16;
+constexpr ::std::uint8_t COLUMN_MAGIC[4] = {'R', 'C', 'O', 'L'};
+
+template <typename N> struct ColumnKind {
+    using T = typename numeric_types::detail::ValueOf<N>::Type;
+    static_assert(!::std::is_same<T, N>::value,
+                  "columns hold Number<T> only!");
+    static constexpr ::std::uint8_t value =
+        ::std::is_floating_point<T>::value            ? 'f'
+        : numeric_types::detail::IsSigned<T>::value ? 'i'
+                                                      : 'u';
+};
+
+inline ::std::size_t column_padding(::std::size_t bytes) noexcept {
+    return (COLUMN_ALIGN - bytes % COLUMN_ALIGN) % COLUMN_ALIGN;
+}
+
+template <typename N, typename W>
+void write_column_header(W &writer, ::std::size_t count) {
+    const ::std::uint8_t head[8] = {COLUMN_MAGIC[0], COLUMN_MAGIC[1],
+                                    COLUMN_MAGIC[2], COLUMN_MAGIC[3],
+                                    0, // little-endian
+                                    ColumnKind<N>::value,
+                                    static_cast<::std::uint8_t>(sizeof(N)),
+                                    0};
+    writer.write_bytes(head, sizeof(head));
+    writer.template write<numeric_types::u64, false>(
+        static_cast<numeric_types::u64>(count));
+}
+
+template <typename W> void write_column_padding(W &writer, ::std::size_t bytes) {
+    const ::std::uint8_t zeros[COLUMN_ALIGN] = {};
+    writer.write_bytes(zeros, column_padding(bytes));
+}
+
+template <typename N, typename W>
+void write_column(W &writer, const N *data, ::std::size_t count) {
+    write_column_header<N>(writer, count);
+    writer.template write_from<N, false>(data, count);
+    write_column_padding(writer, count * sizeof(N));
+}
+
+// column of any iterable, gathered through a bounded chunk
+template <typename N, typename W, typename C, typename Get>
+void write_column(W &writer, const C &container, Get get) {
+    write_column_header<N>(writer, container.size());
+    constexpr ::std::size_t chunk = 4096 / sizeof(N);
+    N buffer[chunk]; // NOLINT
+    auto n = ::std::size_t{0};
+    for (const auto &item : container) {
+        buffer[n++] = get(item);
+        if (n == chunk) {
+            writer.template write_from<N, false>(buffer, n);
+            n = 0;
+        }
+    }
+    writer.template write_from<N, false>(buffer, n);
+    write_column_padding(writer, container.size() * sizeof(N));
+}
+
+struct ColumnHeader {
+    bool big_endian;
+    ::std::size_t count;
+};
+
+// readers over memory know how much input is left, streams do not
+template <typename R, typename = void>
+struct HasRemaining : ::std::false_type {};
+template <typename R>
+struct HasRemaining<R, decltype(void(::std::declval<const R &>().remaining()))>
+    : ::std::true_type {};
+
+template <typename N, typename R>
+numeric_types::enable_if_t<HasRemaining<R>::value>
+check_column_fits(const R &reader, ::std::uint64_t count) {
+    if (count > reader.remaining() / sizeof(N)) {
+        throw ::std::out_of_range("rusty::io: unexpected end of input");
+    }
+}
+template <typename N, typename R>
+numeric_types::enable_if_t<!HasRemaining<R>::value>
+check_column_fits(const R & /*reader*/, ::std::uint64_t /*count*/) {}
+
+template <typename N, typename R> ColumnHeader read_column_header(R &reader) {
+    ::std::uint8_t head[8]; // NOLINT
+    reader.read_exact(head, sizeof(head));
+    if (::std::memcmp(head, COLUMN_MAGIC, sizeof(COLUMN_MAGIC)) != 0 ||
+        head[4] > 1) {
+        throw ::std::invalid_argument("rusty::collections: not a column");
+    }
+    if (head[5] != ColumnKind<N>::value || head[6] != sizeof(N)) {
+        throw ::std::invalid_argument(
+            "rusty::collections: column of another element type");
+    }
+    // never trusted before a multiply, resize or take
+    const auto count = reader.template read<numeric_types::u64, false>().value;
+    if (count > SIZE_MAX / sizeof(N)) {
+        throw ::std::invalid_argument("rusty::collections: column too long");
+    }
+    check_column_fits<N>(reader, count);
+    return {head[4] == 1, static_cast<::std::size_t>(count)};
+}
+
+template <typename R> void read_column_padding(R &reader, ::std::size_t bytes) {
+    ::std::uint8_t padding[COLUMN_ALIGN]; // NOLINT
+    reader.read_exact(padding, column_padding(bytes));
+}
+
+template <typename N, typename R>
+void read_column_elements(R &reader, bool big_endian, N *out,
+                          ::std::size_t count) {
+    if (big_endian) {
+        reader.template read_into<N, true>(out, count);
+    } else {
+        reader.template read_into<N, false>(out, count);
+    }
+}
+
+template <typename N, typename R>
+void read_column_body(R &reader, const ColumnHeader &header, N *out) {
+    read_column_elements(reader, header.big_endian, out, header.count);
+    read_column_padding(reader, header.count * sizeof(N));
+}
+
+// a checked count is allocated at once, a streamed one grows with the
+// input so a corrupt count ends in out_of_range rather than a huge
+// allocation
+template <typename N, typename A, typename R>
+void read_column_body(R &reader, const ColumnHeader &header,
+                      ::std::vector<N, A> &out) {
+    constexpr ::std::size_t chunk = (1 << 20) / sizeof(N);
+    out.clear();
+    if (HasRemaining<R>::value) {
+        out.reserve(header.count);
+    }
+    for (auto done = ::std::size_t{0}; done < header.count;) {
+        const auto n = ::std::min(header.count - done, chunk);
+        out.resize(done + n);
+        read_column_elements(reader, header.big_endian, out.data() + done, n);
+        done += n;
+    }
+    read_column_padding(reader, header.count * sizeof(N));
+}
+
+template <typename N, typename R> Vec<N> read_column(R &reader) {
+    const auto header = read_column_header<N>(reader);
+    auto out = Vec<N>{};
+    read_column_body(reader, header, out);
+    return out;
+}
+
+template <typename M, typename R> void read_map(R &reader, M &map) {
+    using K = typename M::key_type;
+    using V = typename M::mapped_type;
+    const auto keys = read_column<K>(reader);
+    const auto values = read_column<V>(reader);
+    if (keys.size() != values.size()) {
+        throw ::std::invalid_argument(
+            "rusty::collections: key and value columns differ in length");
+    }
+    map.clear();
+    map.reserve(keys.size());
+    for (::std::size_t i = 0; i < keys.size(); ++i) {
+        map.emplace(keys[i], values[i]);
+    }
+}
+
+} // namespace detail
+
+template <typename W, typename N, typename A>
+void save(W &writer, const ::std::vector<N, A> &vec) {
+    detail::write_column(writer, vec.data(), vec.size());
+}
+template <typename W, typename N, ::std::size_t L>
+void save(W &writer, const Array<N, L> &array) {
+    detail::write_column(writer, array.data(), L);
+}
+template <typename W, typename N> void save(W &writer, const Slice<N> &slice) {
+    detail::write_column(writer, slice.data(), slice.size());
+}
+template <typename W, typename K, typename V, typename... Ts>
+void save(W &writer, const ::std::unordered_map<K, V, Ts...> &map) {
+    using E = Pair<const K, V>;
+    detail::write_column<K>(writer, map, [](const E &e) { return e.first; });
+    detail::write_column<V>(writer, map, [](const E &e) { return e.second; });
+}
+template <typename W, typename K, typename V, typename... Ts>
+void save(W &writer, const FlatHashMap<K, V, Ts...> &map) {
+    using E = Pair<const K, V>;
+    detail::write_column<K>(writer, map, [](const E &e) { return e.first; });
+    detail::write_column<V>(writer, map, [](const E &e) { return e.second; });
+}
+
+template <typename R, typename N, typename A>
+void load(R &reader, ::std::vector<N, A> &vec) {
+    const auto header = detail::read_column_header<N>(reader);
+    detail::read_column_body(reader, header, vec);
+}
+template <typename R, typename N, ::std::size_t L>
+void load(R &reader, Array<N, L> &array) {
+    const auto header = detail::read_column_header<N>(reader);
+    if (header.count != L) {
+        throw ::std::invalid_argument(
+            "rusty::collections: column length differs from the array");
+    }
+    detail::read_column_body(reader, header, array.data());
+}
+template <typename R, typename K, typename V, typename... Ts>
+void load(R &reader, ::std::unordered_map<K, V, Ts...> &map) {
+    detail::read_map(reader, map);
+}
+template <typename R, typename K, typename V, typename... Ts>
+void load(R &reader, FlatHashMap<K, V, Ts...> &map) {
+    detail::read_map(reader, map);
+}
+// e.g. `auto v = load<Vec<u32>>(reader);`
+template <typename C, typename R> C load(R &reader) {
+    C container;
+    load(reader, container);
+    return container;
+}
+
+// Zero-copy column of @reader over borrowed memory like io::ByteReader,
+// pointing into it. Throws ::std::invalid_argument when the column is
+// foreign endian or misaligned, with @reader back at the column so load()
+// can copy it instead.
+template <typename N, typename R> Slice<const N> view(R &reader) {
+    const auto start = reader.position();
+    const auto header = detail::read_column_header<N>(reader);
+    const auto *data = reader.data() + reader.position();
+    if (header.big_endian != N::is_be ||
+        reinterpret_cast<::std::uintptr_t>(data) % alignof(N) != 0) { // NOLINT
+        reader.seek(start);
+        throw ::std::invalid_argument(
+            "rusty::collections: column not viewable in place");
+    }
+    const auto bytes = header.count * sizeof(N);
+    reader.take(bytes);
+    reader.take(detail::column_padding(bytes));
+    return {reinterpret_cast<const N *>(data), header.count}; // NOLINT
+}
+// keys and values columns of a saved map, @reader back at the keys when
+// either column is not viewable
+template <typename K, typename V, typename R>
+Pair<Slice<const K>, Slice<const V>> view_map(R &reader) {
+    const auto start = reader.position();
+    auto keys = view<K>(reader);
+    auto values = Slice<const V>{};
+    try {
+        values = view<V>(reader);
+    } catch (const ::std::invalid_argument &) {
+        reader.seek(start);
+        throw;
+    }
+    if (keys.size() != values.size()) {
+        throw ::std::invalid_argument(
+            "rusty::collections: key and value columns differ in length");
+    }
+    return {keys, values};
+}
 
 namespace ostream {
 
-inline ::std::string prepare(const ::std::string &s) { return "\"" + s + "\""; }
+// quoting view, writes without building a temporary string
+struct Quoted {
+    const ::std::string &s;
+
+    friend ::std::ostream &operator<<(::std::ostream &s, const Quoted &q) {
+        return s << '"' << q.s << '"';
+    }
+};
+
+inline Quoted prepare(const ::std::string &s) { return Quoted{s}; }
 inline ::std::int32_t prepare(const ::std::int8_t &t) { return t; }
 inline ::std::int32_t prepare(const ::std::uint8_t &t) { return t; }
 template <typename T> inline const T &prepare(const T &t) { return t; }
 
+#ifndef RUSTY_OSTREAM_MAX_ITEMS
+#define RUSTY_OSTREAM_MAX_ITEMS 0 // elements per container, 0 for no limit
+#endif
+#ifndef RUSTY_OSTREAM_MAX_BYTES
+#define RUSTY_OSTREAM_MAX_BYTES 0 // bytes per printing, 0 for no limit
+#endif
+
+// stream local limits, set by `s << max_items(n)` and `s << max_bytes(n)`
+inline int max_items_index() {
+    static const int index = ::std::ios_base::xalloc();
+    return index;
+}
+inline int max_bytes_index() {
+    static const int index = ::std::ios_base::xalloc();
+    return index;
+}
+
+#define LIMIT_IMPL(NAME, DEFAULT)                                              \
+    struct NAME##_manipulator {                                                \
+        ::std::size_t n;                                                       \
+        friend ::std::ostream &operator<<(::std::ostream &s,                   \
+                                          const NAME##_manipulator &m) {       \
+            s.iword(NAME##_index()) = static_cast<long>(m.n); /* NOLINT */     \
+            return s;                                                          \
+        }                                                                      \
+    };                                                                         \
+    inline NAME##_manipulator NAME(::std::size_t n) {                          \
+        return NAME##_manipulator{n};                                          \
+    }                                                                          \
+    inline ::std::size_t NAME##_of(::std::ostream &s) {                        \
+        const auto n = s.iword(NAME##_index());                                \
+        return n ? static_cast<::std::size_t>(n) : (DEFAULT);                  \
+    }
+
+LIMIT_IMPL(max_items, RUSTY_OSTREAM_MAX_ITEMS)
+LIMIT_IMPL(max_bytes, RUSTY_OSTREAM_MAX_BYTES)
+
+#undef LIMIT_IMPL
+
+// Formats into a thread local growable buffer reused across printings and
+// hands it to the stream buffer in large chunks, under one sentry. Numbers
+// are formatted without the stream unless its flags or locale ask for more
+// than plain output.
+class Printer {
+  public:
+    static constexpr ::std::size_t CHUNK = 1 << 16;
+
+    explicit Printer(::std::ostream &s)
+        : s(s), sentry(s), buffer(thread_buffer()), start(buffer.size()),
+          items(max_items_of(s)), bytes(max_bytes_of(s)) {
+        const auto flags = s.flags();
+        const auto base = flags & ::std::ios_base::basefield;
+        plain_int = s.width() == 0 &&
+                    (base == ::std::ios_base::dec || base == 0) &&
+                    !(flags & ::std::ios_base::showpos) &&
+                    numeric_types::detail::is_plain_locale(s.getloc());
+        plain_float = plain_int &&
+                      !(flags & (::std::ios_base::floatfield |
+                                 ::std::ios_base::showpoint |
+                                 ::std::ios_base::uppercase));
+    }
+    Printer(const Printer &) = delete;
+    Printer &operator=(const Printer &) = delete;
+    // printing ends with flush(), here only when unwinding; the sentry
+    // honors unitbuf afterwards
+    ~Printer() {
+        try {
+            flush();
+        } catch (...) { // NOLINT(bugprone-empty-catch), badbit is set
+        }
+    }
+
+    // output that does not reach the stream buffer sets badbit
+    void flush() {
+        const auto n = static_cast<::std::streamsize>(buffer.size());
+        const auto ok = n == 0 || (sentry && s.good() &&
+                                   s.rdbuf()->sputn(buffer.data(), n) == n);
+        written += buffer.size() - start;
+        buffer.clear();
+        start = 0;
+        if (!ok) {
+            s.setstate(::std::ios_base::badbit);
+        }
+    }
+
+    void append(const char *str, ::std::size_t n) {
+        buffer.append(str, n);
+        if (buffer.size() >= CHUNK) {
+            flush();
+        }
+    }
+    void append(char c) { append(&c, 1); }
+
+    void append(const ::std::string &str) {
+        append('"');
+        append(str.data(), str.size());
+        append('"');
+    }
+
+    void append(bool value) { stream(value); }
+
+    template <typename T>
+    numeric_types::enable_if_t<numeric_types::detail::IsInteger<T>::value &&
+                               !::std::is_same<T, bool>::value>
+    append(T value) {
+        if (plain_int) {
+            char digits[numeric_types::detail::MAX_FORMAT_CHARS]; // NOLINT
+            append(digits, static_cast<::std::size_t>(
+                               numeric_types::detail::write_number(
+                                   digits, value) -
+                               digits));
+        } else {
+            stream(numeric_types::Number<T>{value});
+        }
+    }
+
+    template <typename T>
+    numeric_types::enable_if_t<::std::is_floating_point<T>::value>
+    append(T value) {
+        if (plain_float) {
+            char digits[64]; // NOLINT(modernize-avoid-c-arrays)
+            const auto n = ::std::snprintf(digits, sizeof(digits), "%.*g",
+                                           static_cast<int>(s.precision()),
+                                           static_cast<double>(value));
+            append(digits, static_cast<::std::size_t>(n));
+        } else {
+            stream(value);
+        }
+    }
+
+    template <typename T> void append(const numeric_types::Number<T> &n) {
+        append(n.value);
+    }
+
+    template <typename T1, typename T2> void append(const Pair<T1, T2> &p) {
+        append('(');
+        append(p.first);
+        append(", ", 2);
+        append(p.second);
+        append(')');
+    }
+
+    template <typename T, ::std::size_t N> void append(const Array<T, N> &c) {
+        sequence(c);
+    }
+    template <typename T, typename A>
+    void append(const ::std::vector<T, A> &c) {
+        sequence(c);
+    }
+    template <typename T, ::std::size_t N>
+    void append(const SmallVec<T, N> &c) {
+        sequence(c);
+    }
+    template <typename K, typename V, typename H, typename E, typename A>
+    void append(const ::std::unordered_map<K, V, H, E, A> &c) {
+        sequence(c);
+    }
+    template <typename K, typename V, typename H, typename E>
+    void append(const FlatHashMap<K, V, H, E> &c) {
+        sequence(c);
+    }
+    template <typename T> void append(const Slice<T> &c) { sequence(c); }
+    template <typename N, bool B>
+    void append(const numeric_types::EndianSlice<N, B> &c) {
+        sequence(c);
+    }
+
+    // anything else goes through its own operator<<
+    template <typename T>
+    numeric_types::enable_if_t<!::std::is_arithmetic<T>::value &&
+                               !numeric_types::detail::IsInteger<T>::value>
+    append(const T &value) {
+        stream(value);
+    }
+
+  private:
+    static ::std::string &thread_buffer() {
+        thread_local ::std::string buffer;
+        return buffer;
+    }
+
+    ::std::size_t printed() const { return written + buffer.size() - start; }
+
+    template <typename T> void stream(const T &value) {
+        flush();
+        s << value;
+    }
+
+    template <typename C> void sequence(const C &c) {
+        append('[');
+        ::std::size_t count = 0;
+        for (const auto &i : c) {
+            if (truncated || (items && count == items) ||
+                (bytes && printed() >= bytes)) {
+                append(count ? ", ..." : "...", count ? 5 : 3);
+                truncated = true;
+                break;
+            }
+            if (count++ > 0) {
+                append(", ", 2);
+            }
+            append(i);
+        }
+        append(']');
+    }
+
+    ::std::ostream &s;
+    const ::std::ostream::sentry sentry;
+    ::std::string &buffer;
+    ::std::size_t start; // bytes owned by an enclosing printer
+    ::std::size_t items;
+    ::std::size_t bytes;
+    ::std::size_t written = 0;
+    bool plain_int = false;
+    bool plain_float = false;
+    bool truncated = false;
+};
+
 template <typename T1, typename T2>
 ::std::ostream &operator<<(::std::ostream &s, const Pair<T1, T2> &p) {
-    return s << "(" << prepare(p.first) << ", " << prepare(p.second) << ")";
+    Printer printer{s};
+    printer.append(p);
+    printer.flush();
+    return s;
 }
 
 #define OSTREAM_IMPL(T1, T2)                                                   \
     template <T1>::std::ostream &operator<<(::std::ostream &s, const T2 &c) {  \
-        auto count = c.size();                                                 \
-        s << "[";                                                              \
-        for (const auto &i : c) {                                              \
-            s << prepare(i);                                                   \
-            if (--count > 0) {                                                 \
-                s << ", ";                                                     \
-            }                                                                  \
-        }                                                                      \
-        return s << "]";                                                       \
+        Printer printer{s};                                                    \
+        printer.append(c);                                                     \
+        printer.flush();                                                       \
+        return s;                                                              \
     }
 
 #define COMMA ,
 
 OSTREAM_IMPL(typename T COMMA ::std::size_t size, Array<T COMMA size>)
-OSTREAM_IMPL(typename T, Vec<T>)
-OSTREAM_IMPL(typename K COMMA typename V, HashMap<K COMMA V>)
+OSTREAM_IMPL(typename T COMMA typename A, ::std::vector<T COMMA A>)
+OSTREAM_IMPL(typename T COMMA ::std::size_t N, SmallVec<T COMMA N>)
+OSTREAM_IMPL(typename T, Slice<T>)
+OSTREAM_IMPL(typename K COMMA typename V COMMA typename H COMMA typename E
+                 COMMA typename A,
+             ::std::unordered_map<K COMMA V COMMA H COMMA E COMMA A>)
+OSTREAM_IMPL(typename K COMMA typename V COMMA typename H COMMA typename E,
+             FlatHashMap<K COMMA V COMMA H COMMA E>)
+OSTREAM_IMPL(typename N COMMA bool B,
+             ::rusty::numeric_types::EndianSlice<N COMMA B>)
 
 #undef COMMA
 #undef OSTREAM_IMPL
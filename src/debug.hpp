@@ -0,0 +1,690 @@
+// SPDX-License-Identifier: MIT
+// Copyright(c) 2021 ur4t
+
+#ifndef __RUSTY_DEBUG_HPP__
+#define __RUSTY_DEBUG_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+#include "collections.hpp"
+#include "numeric_types.hpp"
+
+// dbg_level(n, ...) prints only when n <= RUSTY_DBG_LEVEL, dbg is level 1,
+// 0 turns every dbg into its bare expression at preprocessing time
+#ifndef RUSTY_DBG_LEVEL
+#define RUSTY_DBG_LEVEL 1
+#endif
+
+// records per second per call site, 0 for no limit
+#ifndef RUSTY_DBG_RATE_LIMIT
+#define RUSTY_DBG_RATE_LIMIT 0
+#endif
+
+// define RUSTY_DBG_THREAD_ID and/or RUSTY_DBG_TIMESTAMP to tag records with
+// a small sequential thread id and seconds since the first record
+
+// define RUSTY_DBG_ASYNC to hand records to a background thread draining
+// every RUSTY_DBG_ASYNC_INTERVAL_MS, and at exit
+#ifndef RUSTY_DBG_ASYNC_INTERVAL_MS
+#define RUSTY_DBG_ASYNC_INTERVAL_MS 50
+#endif
+
+// define RUSTY_DBG_METRICS to turn on dbg_time, dbg_count and dbg_hist,
+// recorded per thread and written as JSON lines at exit (unless
+// RUSTY_DBG_METRICS_AT_EXIT is 0) or by dump_metrics(). Call sites past
+// RUSTY_DBG_METRICS_MAX_SITES are ignored. Timings use the TSC on x86
+// unless RUSTY_DBG_METRICS_STEADY_CLOCK is defined.
+#ifndef RUSTY_DBG_METRICS_AT_EXIT
+#define RUSTY_DBG_METRICS_AT_EXIT 1
+#endif
+#ifndef RUSTY_DBG_METRICS_MAX_SITES
+#define RUSTY_DBG_METRICS_MAX_SITES 1024
+#endif
+#if (defined(__x86_64__) || defined(__i386__)) &&                              \
+    (defined(__GNUC__) || defined(__clang__)) &&                               \
+    !defined(RUSTY_DBG_METRICS_STEADY_CLOCK)
+#define RUSTY_DBG_METRICS_HAS_TSC
+#endif
+
+namespace rusty::debug {
+
+// streambuf appending to a reusable string
+class StringBuf : public ::std::streambuf {
+  public:
+    ::std::string buffer;
+
+  protected:
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            buffer.push_back(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+    ::std::streamsize xsputn(const char *s, ::std::streamsize n) override {
+        buffer.append(s, static_cast<::std::size_t>(n));
+        return n;
+    }
+};
+
+// a whole record in one write syscall, so concurrent records never tear
+inline void emit(const char *data, ::std::size_t n) {
+#if defined(__unix__) || defined(__APPLE__)
+    while (n > 0) {
+        const auto r = ::write(STDERR_FILENO, data, n);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data += r;
+        n -= static_cast<::std::size_t>(r);
+    }
+#else
+    ::std::fwrite(data, 1, n, stderr);
+#endif
+}
+
+#ifdef RUSTY_DBG_ASYNC
+class AsyncSink {
+  public:
+    struct Pending {
+        ::std::mutex mutex;
+        ::std::string data;
+    };
+
+    static AsyncSink &instance() {
+        static AsyncSink sink;
+        return sink;
+    }
+
+    AsyncSink(const AsyncSink &) = delete;
+    AsyncSink &operator=(const AsyncSink &) = delete;
+    ~AsyncSink() {
+        {
+            const ::std::lock_guard<::std::mutex> lock(mutex);
+            stop = true;
+        }
+        cv.notify_one();
+        worker.join();
+        drain();
+    }
+
+    ::std::shared_ptr<Pending> attach() {
+        auto pending = ::std::make_shared<Pending>();
+        const ::std::lock_guard<::std::mutex> lock(mutex);
+        pendings.push_back(pending);
+        return pending;
+    }
+
+    void notify() { cv.notify_one(); }
+
+    // write out everything pending of every thread, in one go
+    void drain() {
+        auto snapshot = ::std::vector<::std::shared_ptr<Pending>>{};
+        {
+            const ::std::lock_guard<::std::mutex> lock(mutex);
+            snapshot = pendings;
+        }
+        auto out = ::std::string{};
+        for (const auto &pending : snapshot) {
+            const ::std::lock_guard<::std::mutex> lock(pending->mutex);
+            out.append(pending->data);
+            pending->data.clear();
+        }
+        if (!out.empty()) {
+            emit(out.data(), out.size());
+        }
+        // buffers of exited threads are only referenced here now
+        const ::std::lock_guard<::std::mutex> lock(mutex);
+        for (auto it = pendings.begin(); it != pendings.end();) {
+            it = it->use_count() == 1 && (*it)->data.empty()
+                     ? pendings.erase(it)
+                     : it + 1;
+        }
+    }
+
+  private:
+    AsyncSink() : worker([this] { run(); }) {}
+
+    void run() {
+        auto lock = ::std::unique_lock<::std::mutex>(mutex);
+        while (!stop) {
+            cv.wait_for(lock, ::std::chrono::milliseconds(
+                                  RUSTY_DBG_ASYNC_INTERVAL_MS));
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+    }
+
+    ::std::mutex mutex;
+    ::std::condition_variable cv;
+    ::std::vector<::std::shared_ptr<Pending>> pendings;
+    bool stop = false;
+    ::std::thread worker; // last, started once everything else is ready
+};
+#endif
+
+// per thread formatting state, records never touch a shared stream
+struct ThreadState {
+    static unsigned next_id() {
+        static ::std::atomic<unsigned> id{0};
+        return id.fetch_add(1, ::std::memory_order_relaxed);
+    }
+
+    unsigned id = next_id();
+    StringBuf buf;
+    ::std::ostream stream{&buf};
+    ::std::ostream pristine{nullptr}; // default format to restore from
+#ifdef RUSTY_DBG_ASYNC
+    ::std::shared_ptr<AsyncSink::Pending> pending =
+        AsyncSink::instance().attach();
+#endif
+};
+
+inline ThreadState &thread_state() {
+    thread_local ThreadState state;
+    return state;
+}
+
+// per call site limit of records per second
+class RateLimit {
+  public:
+    bool allow(unsigned per_second) noexcept {
+        if (per_second == 0) {
+            return true;
+        }
+        const auto now = ::std::chrono::duration_cast<::std::chrono::seconds>(
+                             ::std::chrono::steady_clock::now()
+                                 .time_since_epoch())
+                             .count();
+        auto current = window.load(::std::memory_order_relaxed);
+        if (current != now &&
+            window.compare_exchange_strong(current, now,
+                                           ::std::memory_order_relaxed)) {
+            count.store(0, ::std::memory_order_relaxed);
+        }
+        if (count.fetch_add(1, ::std::memory_order_relaxed) < per_second) {
+            return true;
+        }
+        dropped.fetch_add(1, ::std::memory_order_relaxed);
+        return false;
+    }
+
+    // records dropped since the last call
+    unsigned long long take_suppressed() noexcept {
+        return dropped.exchange(0, ::std::memory_order_relaxed);
+    }
+
+  private:
+    ::std::atomic<long long> window{-1};
+    ::std::atomic<unsigned> count{0};
+    ::std::atomic<unsigned long long> dropped{0};
+};
+
+inline ::std::ostream &begin_record(const char *file, int line,
+                                    const char *expr,
+                                    unsigned long long suppressed) {
+    auto &state = thread_state();
+    state.buf.buffer.clear();
+    state.stream << '[' << file << ':' << line;
+#ifdef RUSTY_DBG_THREAD_ID
+    state.stream << " T" << state.id;
+#endif
+#ifdef RUSTY_DBG_TIMESTAMP
+    static const auto start = ::std::chrono::steady_clock::now();
+    const auto elapsed =
+        ::std::chrono::duration_cast<::std::chrono::microseconds>(
+            ::std::chrono::steady_clock::now() - start)
+            .count();
+    const auto fill = state.stream.fill('0');
+    state.stream << " +" << elapsed / 1000000 << '.' << ::std::setw(6)
+                 << elapsed % 1000000 << 's';
+    state.stream.fill(fill);
+#endif
+    state.stream << "] ";
+    if (suppressed > 0) {
+        state.stream << '(' << suppressed << " suppressed) ";
+    }
+    state.stream << expr << " = ";
+    return state.stream;
+}
+
+// @formatted tells whether the record changed the stream format
+inline void end_record(bool formatted) {
+    auto &state = thread_state();
+    state.buf.buffer.push_back('\n');
+    if (formatted) {
+        state.stream.copyfmt(state.pristine);
+    }
+#ifdef RUSTY_DBG_ASYNC
+    auto &pending = *state.pending;
+    auto size = ::std::size_t{0};
+    {
+        const ::std::lock_guard<::std::mutex> lock(pending.mutex);
+        pending.data.append(state.buf.buffer);
+        size = pending.data.size();
+    }
+    if (size >= (1U << 16)) {
+        AsyncSink::instance().notify();
+    }
+#else
+    emit(state.buf.buffer.data(), state.buf.buffer.size());
+#endif
+}
+
+// backend of the dbg macro: when @enabled and the rate limit of @site
+// allows, records @value after @manipulate applied the stream format, then
+// hands @value back, lvalues by reference and rvalues moved into the result
+template <typename Site, typename Manipulate, typename T>
+T forward_record(bool enabled, Site site, unsigned rate_limit,
+                 const char *file, int line, const char *expr,
+                 bool formatted, Manipulate manipulate, T &&value) {
+    // printers of std containers, which argument dependent lookup misses
+    using namespace ::rusty::collections::ostream; // NOLINT
+    if (enabled) {
+        auto &limit = site();
+        if (limit.allow(rate_limit)) {
+            manipulate(begin_record(file, line, expr, limit.take_suppressed()))
+                << value;
+            end_record(formatted);
+        }
+    }
+    return static_cast<T &&>(value);
+}
+
+// write out pending records now, a no-op unless RUSTY_DBG_ASYNC
+inline void flush() {
+#ifdef RUSTY_DBG_ASYNC
+    AsyncSink::instance().drain();
+#endif
+}
+
+enum class MetricKind {
+    Count,
+    Time,
+    Hist,
+};
+
+inline const char *to_str(MetricKind kind) noexcept {
+    switch (kind) {
+    case MetricKind::Count:
+        return "count";
+    case MetricKind::Time:
+        return "time";
+    case MetricKind::Hist:
+        return "hist";
+    }
+    return "";
+}
+
+// clock of dbg_time, TSC ticks or steady_clock nanoseconds
+inline ::std::uint64_t ticks() noexcept {
+#ifdef RUSTY_DBG_METRICS_HAS_TSC
+    return __builtin_ia32_rdtsc();
+#else
+    return static_cast<::std::uint64_t>(
+        ::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+            ::std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+#endif
+}
+
+// HDR style log-linear buckets: exact below 2 ** SUB_BITS, then 2 **
+// (SUB_BITS - 1) buckets per power of two, so a bucket spans at most 1/16
+// of its values
+struct HistBuckets {
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr ::std::size_t COUNT =
+        (64 - SUB_BITS) * (::std::size_t{1} << (SUB_BITS - 1)) +
+        (::std::size_t{1} << SUB_BITS);
+
+    static ::std::size_t index(::std::uint64_t value) noexcept {
+        if (value < (::std::uint64_t{1} << SUB_BITS)) {
+            return static_cast<::std::size_t>(value);
+        }
+        const auto shift =
+            63 - numeric_types::detail::clz64(value) - SUB_BITS + 1;
+        return (static_cast<::std::size_t>(shift) << (SUB_BITS - 1)) +
+               static_cast<::std::size_t>(value >> shift);
+    }
+    // smallest value of bucket @i
+    static ::std::uint64_t lower(::std::size_t i) noexcept {
+        if (i < (::std::size_t{1} << SUB_BITS)) {
+            return i;
+        }
+        const auto shift = (i >> (SUB_BITS - 1)) - 1;
+        return static_cast<::std::uint64_t>(i - (shift << (SUB_BITS - 1)))
+               << shift;
+    }
+};
+
+// Metrics of one call site in one thread. Only the owning thread writes,
+// with plain load and store, dump_metrics reads concurrently.
+struct MetricSlot {
+    explicit MetricSlot(MetricKind kind)
+        : buckets(kind == MetricKind::Count
+                      ? nullptr
+                      : new ::std::atomic<::std::uint64_t>[HistBuckets::COUNT]()) {}
+
+    static void add(::std::atomic<::std::uint64_t> &a,
+                    ::std::uint64_t n) noexcept {
+        a.store(a.load(::std::memory_order_relaxed) + n,
+                ::std::memory_order_relaxed);
+    }
+
+    void count(::std::uint64_t n) noexcept { add(total, n); }
+    void record(::std::uint64_t value) noexcept {
+        add(total, 1);
+        add(sum, value);
+        if (value < min.load(::std::memory_order_relaxed)) {
+            min.store(value, ::std::memory_order_relaxed);
+        }
+        if (value > max.load(::std::memory_order_relaxed)) {
+            max.store(value, ::std::memory_order_relaxed);
+        }
+        add(buckets[HistBuckets::index(value)], 1);
+    }
+
+    ::std::atomic<::std::uint64_t> total{0};
+    ::std::atomic<::std::uint64_t> sum{0};
+    ::std::atomic<::std::uint64_t> min{~::std::uint64_t{0}};
+    ::std::atomic<::std::uint64_t> max{0};
+    ::std::unique_ptr<::std::atomic<::std::uint64_t>[]> buckets;
+};
+
+// slots of every call site used by a thread, kept after the thread exits
+// and handed to the next new thread
+struct MetricShard {
+    ::std::atomic<MetricSlot *> slots[RUSTY_DBG_METRICS_MAX_SITES] = {};
+    ::std::vector<::std::unique_ptr<MetricSlot>> owned;
+};
+
+// Never destroyed: threads of other statics (e.g. ThreadPool::global)
+// may still record and release their shards while statics are destroyed.
+class MetricRegistry {
+  public:
+    static MetricRegistry &instance() {
+        static auto *registry = new MetricRegistry(); // NOLINT
+        static const ExitDump exit_dump;
+        return *registry;
+    }
+
+    MetricRegistry(const MetricRegistry &) = delete;
+    MetricRegistry &operator=(const MetricRegistry &) = delete;
+
+    // index of a new call site, RUSTY_DBG_METRICS_MAX_SITES once full
+    ::std::size_t add_site(const char *name, MetricKind kind, const char *file,
+                           int line) {
+        const ::std::lock_guard<::std::mutex> lock(mutex);
+        if (sites.size() == RUSTY_DBG_METRICS_MAX_SITES) {
+            return RUSTY_DBG_METRICS_MAX_SITES;
+        }
+        sites.push_back(Site{name, kind, file, line});
+        return sites.size() - 1;
+    }
+
+    MetricShard *acquire() {
+        const ::std::lock_guard<::std::mutex> lock(mutex);
+        if (!idle.empty()) {
+            auto *shard = idle.back();
+            idle.pop_back();
+            return shard;
+        }
+        shards.emplace_back(new MetricShard{});
+        return shards.back().get();
+    }
+    void release(MetricShard *shard) {
+        const ::std::lock_guard<::std::mutex> lock(mutex);
+        idle.push_back(shard);
+    }
+
+    MetricKind kind(::std::size_t index) {
+        const ::std::lock_guard<::std::mutex> lock(mutex);
+        return sites[index].kind;
+    }
+
+    // one JSON object per call site, aggregated over every thread, times
+    // in nanoseconds
+    void dump(::std::ostream &s) {
+        const ::std::lock_guard<::std::mutex> lock(mutex);
+        const auto scale = ns_per_tick();
+        auto hist = ::std::vector<::std::uint64_t>(HistBuckets::COUNT);
+        for (::std::size_t i = 0; i < sites.size(); ++i) {
+            const auto &site = sites[i];
+            auto total = ::std::uint64_t{0};
+            auto sum = ::std::uint64_t{0};
+            auto min = ~::std::uint64_t{0};
+            auto max = ::std::uint64_t{0};
+            ::std::fill(hist.begin(), hist.end(), 0);
+            for (const auto &shard : shards) {
+                const auto *slot =
+                    shard->slots[i].load(::std::memory_order_acquire);
+                if (slot == nullptr) {
+                    continue;
+                }
+                total += slot->total.load(::std::memory_order_relaxed);
+                sum += slot->sum.load(::std::memory_order_relaxed);
+                min = ::std::min(min,
+                                 slot->min.load(::std::memory_order_relaxed));
+                max = ::std::max(max,
+                                 slot->max.load(::std::memory_order_relaxed));
+                for (::std::size_t b = 0; slot->buckets && b < hist.size();
+                     ++b) {
+                    hist[b] +=
+                        slot->buckets[b].load(::std::memory_order_relaxed);
+                }
+            }
+            s << "{\"name\": ";
+            write_json_string(s, site.name);
+            s << ", \"kind\": \"" << to_str(site.kind) << "\", \"site\": ";
+            write_json_string(s, site.file);
+            s << ", \"line\": " << site.line << ", \"count\": " << total;
+            if (site.kind != MetricKind::Count && total > 0) {
+                const auto unit = site.kind == MetricKind::Time ? scale : 1.0;
+                const auto value = [unit](::std::uint64_t v) {
+                    return static_cast<::std::uint64_t>(
+                        static_cast<double>(v) * unit + 0.5);
+                };
+                s << ", \"sum\": " << value(sum) << ", \"min\": " << value(min)
+                  << ", \"mean\": "
+                  << value(sum / total) << ", \"p50\": "
+                  << value(percentile(hist, total, 0.5, min, max))
+                  << ", \"p90\": "
+                  << value(percentile(hist, total, 0.9, min, max))
+                  << ", \"p99\": "
+                  << value(percentile(hist, total, 0.99, min, max))
+                  << ", \"p999\": "
+                  << value(percentile(hist, total, 0.999, min, max))
+                  << ", \"max\": " << value(max);
+            }
+            s << "}\n";
+        }
+    }
+
+    void dump_to_stderr() {
+        StringBuf buf;
+        ::std::ostream s(&buf);
+        dump(s);
+        emit(buf.buffer.data(), buf.buffer.size());
+    }
+
+  private:
+    struct Site {
+        const char *name;
+        MetricKind kind;
+        const char *file;
+        int line;
+    };
+
+    // the at exit dump, destroyed with the statics created before the
+    // first call site
+    struct ExitDump {
+        ExitDump() = default;
+        ExitDump(const ExitDump &) = delete;
+        ExitDump &operator=(const ExitDump &) = delete;
+        ~ExitDump() {
+            if (RUSTY_DBG_METRICS_AT_EXIT) {
+                instance().dump_to_stderr();
+            }
+        }
+    };
+
+    MetricRegistry() = default;
+
+    // TSC rate against steady_clock since the registry was created
+    double ns_per_tick() const {
+#ifdef RUSTY_DBG_METRICS_HAS_TSC
+        auto now = ::std::chrono::steady_clock::now();
+        while (now - start_time < ::std::chrono::milliseconds(1)) {
+            now = ::std::chrono::steady_clock::now();
+        }
+        const auto ticks_now = ticks();
+        return ::std::chrono::duration<double, ::std::nano>(now - start_time)
+                   .count() /
+               static_cast<double>(ticks_now - start_ticks);
+#else
+        return 1.0;
+#endif
+    }
+
+    // midpoint of the bucket holding the @q quantile, within [min, max]
+    static ::std::uint64_t percentile(const ::std::vector<::std::uint64_t> &hist,
+                                      ::std::uint64_t total, double q,
+                                      ::std::uint64_t min,
+                                      ::std::uint64_t max) {
+        const auto rank = static_cast<::std::uint64_t>(
+            q * static_cast<double>(total - 1));
+        auto seen = ::std::uint64_t{0};
+        for (::std::size_t b = 0; b < hist.size(); ++b) {
+            seen += hist[b];
+            if (seen > rank) {
+                const auto low = HistBuckets::lower(b);
+                const auto high = b + 1 < hist.size()
+                                      ? HistBuckets::lower(b + 1) - 1
+                                      : ~::std::uint64_t{0};
+                const auto mid = low + (high - low) / 2;
+                return ::std::max(min, ::std::min(max, mid));
+            }
+        }
+        return max;
+    }
+
+    static void write_json_string(::std::ostream &s, const char *text) {
+        s << '"';
+        for (; *text != '\0'; ++text) {
+            if (*text == '"' || *text == '\\') {
+                s << '\\';
+            }
+            s << *text;
+        }
+        s << '"';
+    }
+
+    ::std::mutex mutex;
+    ::std::vector<Site> sites;
+    ::std::vector<::std::unique_ptr<MetricShard>> shards;
+    ::std::vector<MetricShard *> idle;
+    ::std::chrono::steady_clock::time_point start_time =
+        ::std::chrono::steady_clock::now();
+    ::std::uint64_t start_ticks = ticks();
+};
+
+// static per call site, trivially destructible so it outlives nothing
+struct MetricSite {
+    MetricSite(const char *name, MetricKind kind, const char *file, int line)
+        : index(MetricRegistry::instance().add_site(name, kind, file, line)) {}
+
+    ::std::size_t index;
+};
+
+// shard of the calling thread, returned to the registry at thread exit
+inline MetricShard *&thread_shard() noexcept {
+    thread_local MetricShard *shard = nullptr;
+    return shard;
+}
+
+inline MetricShard *acquire_thread_shard() {
+    struct Release {
+        ~Release() {
+            MetricRegistry::instance().release(thread_shard());
+            thread_shard() = nullptr;
+        }
+    };
+    thread_local Release release;
+    return thread_shard() = MetricRegistry::instance().acquire();
+}
+
+inline MetricSlot *metric_slot(const MetricSite &site) {
+    if (site.index == RUSTY_DBG_METRICS_MAX_SITES) {
+        return nullptr;
+    }
+    auto *shard = thread_shard();
+    if (shard == nullptr) {
+        shard = acquire_thread_shard();
+    }
+    auto *slot = shard->slots[site.index].load(::std::memory_order_relaxed);
+    if (slot == nullptr) {
+        shard->owned.emplace_back(
+            new MetricSlot(MetricRegistry::instance().kind(site.index)));
+        slot = shard->owned.back().get();
+        shard->slots[site.index].store(slot, ::std::memory_order_release);
+    }
+    return slot;
+}
+
+inline void count_metric(const MetricSite &site, ::std::uint64_t n = 1) {
+    if (auto *slot = metric_slot(site)) {
+        slot->count(n);
+    }
+}
+
+inline void record_metric(const MetricSite &site, ::std::uint64_t value) {
+    if (auto *slot = metric_slot(site)) {
+        slot->record(value);
+    }
+}
+
+// records the ticks from construction to destruction
+class ScopedTimer {
+  public:
+    explicit ScopedTimer(const MetricSite &site) noexcept
+        : site(site), start(ticks()) {}
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+    ~ScopedTimer() { record_metric(site, ticks() - start); }
+
+  private:
+    const MetricSite &site;
+    ::std::uint64_t start;
+};
+
+// JSON lines of every metric so far, to @s or stderr
+inline void dump_metrics(::std::ostream &s) {
+    MetricRegistry::instance().dump(s);
+}
+inline void dump_metrics() { MetricRegistry::instance().dump_to_stderr(); }
+
+} // namespace rusty::debug
+
+#endif // __RUSTY_DEBUG_HPP__
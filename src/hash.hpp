@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: MIT
+// Copyright(c) 2021 ur4t
+
+#ifndef __RUSTY_HASH_HPP__
+#define __RUSTY_HASH_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <type_traits>
+
+#include "numeric_types.hpp"
+
+namespace rusty::hash {
+
+namespace detail {
+
+using numeric_types::enable_if_t;
+using numeric_types::int128;
+using numeric_types::uint128;
+
+// wyhash secrets
+constexpr ::std::uint64_t SECRET0 = 0xa0761d6478bd642fULL;
+constexpr ::std::uint64_t SECRET1 = 0xe7037ed1a0b428dbULL;
+
+// folded 128-bit product, a single mul instruction with native uint128
+inline ::std::uint64_t mum(::std::uint64_t a, ::std::uint64_t b) noexcept {
+    const auto product = uint128(a) * uint128(b);
+    return static_cast<::std::uint64_t>(product) ^
+           static_cast<::std::uint64_t>(product >> 64U);
+}
+
+inline ::std::uint64_t read64(const char *p) noexcept {
+    ::std::uint64_t v;
+    ::std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline ::std::uint64_t hash_bytes(const char *p, ::std::size_t n,
+                                  ::std::uint64_t seed) noexcept {
+    seed ^= SECRET0;
+    auto a = ::std::uint64_t{0};
+    auto b = ::std::uint64_t{0};
+    auto rest = n;
+    for (; rest > 16; rest -= 16, p += 16) {
+        seed = mum(read64(p) ^ SECRET1, read64(p + 8) ^ seed);
+    }
+    if (rest > 8) {
+        a = read64(p);
+        b = read64(p + rest - 8);
+    } else if (rest > 0) {
+        ::std::memcpy(&a, p, rest);
+    }
+    return mum(SECRET1 ^ n, mum(a ^ SECRET1, b ^ seed));
+}
+
+// equal keys give equal hashes, numbers hash their bits in one multiply
+template <typename T>
+enable_if_t<(::std::is_integral<T>::value || ::std::is_enum<T>::value) &&
+                sizeof(T) <= 8,
+            ::std::uint64_t>
+hash_with(const T &value, ::std::uint64_t seed) noexcept {
+    return mum(static_cast<::std::uint64_t>(value) ^ seed ^ SECRET0, SECRET1);
+}
+
+template <typename T>
+enable_if_t<::std::is_floating_point<T>::value && sizeof(T) <= 8,
+            ::std::uint64_t>
+hash_with(const T &value, ::std::uint64_t seed) noexcept {
+    using Bits = typename numeric_types::detail::UintOf<sizeof(T)>::Type;
+    // +0.0 and -0.0 compare equal
+    return hash_with(value == T(0) ? Bits{0}
+                                   : numeric_types::bit_cast<Bits>(value),
+                     seed);
+}
+
+inline ::std::uint64_t hash_with(const uint128 &value,
+                                 ::std::uint64_t seed) noexcept {
+    return mum(static_cast<::std::uint64_t>(value) ^ seed ^ SECRET0,
+               static_cast<::std::uint64_t>(value >> 64U) ^ SECRET1);
+}
+inline ::std::uint64_t hash_with(const int128 &value,
+                                 ::std::uint64_t seed) noexcept {
+    return hash_with(static_cast<uint128>(value), seed);
+}
+
+inline ::std::uint64_t hash_with(const ::std::string &value,
+                                 ::std::uint64_t seed) noexcept {
+    return hash_bytes(value.data(), value.size(), seed);
+}
+
+template <typename T>
+::std::uint64_t hash_with(const numeric_types::Number<T> &number,
+                          ::std::uint64_t seed) noexcept {
+    return hash_with(number.value, seed);
+}
+
+// anything else is remixed from its std::hash
+template <typename T>
+enable_if_t<!::std::is_arithmetic<T>::value && !::std::is_enum<T>::value &&
+                !numeric_types::detail::IsInteger<T>::value,
+            ::std::uint64_t>
+hash_with(const T &value, ::std::uint64_t seed) {
+    return mum(static_cast<::std::uint64_t>(::std::hash<T>{}(value)) ^ seed ^
+                   SECRET0,
+               SECRET1);
+}
+
+// distinct per call, unpredictable across processes
+inline ::std::uint64_t next_seed() {
+    static const auto key = [] {
+        ::std::random_device device;
+        return (::std::uint64_t{device()} << 32U) ^ device();
+    }();
+    static ::std::atomic<::std::uint64_t> counter{0};
+    return mum(key ^ counter.fetch_add(1, ::std::memory_order_relaxed),
+               SECRET1);
+}
+
+} // namespace detail
+
+// Hasher families, picked per map like `HashMap<u64, V, FastHash>`. Like
+// rust BuildHasher, each map default constructs its own hasher.
+
+// std::hash, the identity for integers in libstdc++ and libc++
+template <typename T> using StdHash = ::std::hash<T>;
+
+// deterministic, a single wide multiply for numbers
+template <typename T> struct FastHash {
+    using is_avalanching = ::std::true_type; // no remixing needed by tables
+
+    ::std::size_t operator()(const T &value) const noexcept {
+        return static_cast<::std::size_t>(detail::hash_with(value, 0));
+    }
+};
+
+// seeded per instance from a per-process random key like rust RandomState,
+// so colliding key sets cannot be precomputed
+template <typename T> class RandomHash {
+  public:
+    using is_avalanching = ::std::true_type;
+
+    RandomHash() : seed(detail::next_seed()) {}
+    explicit RandomHash(::std::uint64_t seed) : seed(seed) {}
+
+    ::std::size_t operator()(const T &value) const noexcept {
+        return static_cast<::std::size_t>(detail::hash_with(value, seed));
+    }
+
+  private:
+    ::std::uint64_t seed;
+};
+
+} // namespace rusty::hash
+
+#endif // __RUSTY_HASH_HPP__
@@ -0,0 +1,403 @@
+// SPDX-License-Identifier: MIT
+// Copyright(c) 2021 ur4t
+
+#ifndef __RUSTY_IO_HPP__
+#define __RUSTY_IO_HPP__
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define RUSTY_IO_HAS_FD
+#endif
+
+#include "numeric_types.hpp"
+
+namespace rusty::io {
+
+// Typed reads shared by every reader, @Derived provides:
+//     const ::std::uint8_t *take(::std::size_t n): n contiguous bytes
+//     void read_exact(::std::uint8_t *out, ::std::size_t n)
+// both throw ::std::out_of_range when input ends early.
+template <typename Derived> class ReadExt {
+  public:
+    template <typename N, bool BigEndian> N read() {
+        N number;
+        ::std::memcpy(&number, self().take(sizeof(N)), sizeof(N));
+        return BigEndian ? N::from_be(number) : N::from_le(number);
+    }
+
+    // batch read of @count elements straight into @out
+    template <typename N, bool BigEndian>
+    void read_into(N *out, ::std::size_t count) {
+        self().read_exact(reinterpret_cast<::std::uint8_t *>(out), // NOLINT
+                          count * sizeof(N));
+        if (BigEndian != N::is_be) {
+            N::swap_bytes_inplace(out, count);
+        }
+    }
+
+    numeric_types::u8 read_u8() { return read<numeric_types::u8, false>(); }
+    numeric_types::i8 read_i8() { return read<numeric_types::i8, false>(); }
+
+#define READ_IMPL(ALIAS)                                                       \
+    numeric_types::ALIAS read_##ALIAS##_le() {                                 \
+        return read<numeric_types::ALIAS, false>();                            \
+    }                                                                          \
+    numeric_types::ALIAS read_##ALIAS##_be() {                                 \
+        return read<numeric_types::ALIAS, true>();                             \
+    }
+
+    READ_IMPL(u16)
+    READ_IMPL(i16)
+    READ_IMPL(u32)
+    READ_IMPL(i32)
+    READ_IMPL(u64)
+    READ_IMPL(i64)
+    READ_IMPL(u128)
+    READ_IMPL(i128)
+    READ_IMPL(f32)
+    READ_IMPL(f64)
+
+#undef READ_IMPL
+
+  private:
+    Derived &self() { return static_cast<Derived &>(*this); }
+};
+
+// Typed writes shared by every writer, @Derived provides:
+//     void write_bytes(const ::std::uint8_t *bytes, ::std::size_t n)
+template <typename Derived> class WriteExt {
+  public:
+    template <typename N, bool BigEndian> void write(const N &number) {
+        const auto bytes =
+            BigEndian ? number.to_be_bytes() : number.to_le_bytes();
+        self().write_bytes(reinterpret_cast<const ::std::uint8_t *>( // NOLINT
+                               bytes.data()),
+                           bytes.size());
+    }
+
+    // batch write of @count elements, converted through a bounded chunk
+    template <typename N, bool BigEndian>
+    void write_from(const N *in, ::std::size_t count) {
+        if (BigEndian == N::is_be) {
+            self().write_bytes(
+                reinterpret_cast<const ::std::uint8_t *>(in), // NOLINT
+                count * sizeof(N));
+            return;
+        }
+        constexpr ::std::size_t chunk = 4096 / sizeof(N);
+        ::std::uint8_t buffer[chunk * sizeof(N)]; // NOLINT
+        while (count > 0) {
+            const auto n = ::std::min(count, chunk);
+            if (BigEndian) {
+                N::to_be_slice(in, n, buffer);
+            } else {
+                N::to_le_slice(in, n, buffer);
+            }
+            self().write_bytes(buffer, n * sizeof(N));
+            in += n;
+            count -= n;
+        }
+    }
+
+    void write_u8(numeric_types::u8 number) {
+        write<numeric_types::u8, false>(number);
+    }
+    void write_i8(numeric_types::i8 number) {
+        write<numeric_types::i8, false>(number);
+    }
+
+#define WRITE_IMPL(ALIAS)                                                      \
+    void write_##ALIAS##_le(numeric_types::ALIAS number) {                     \
+        write<numeric_types::ALIAS, false>(number);                            \
+    }                                                                          \
+    void write_##ALIAS##_be(numeric_types::ALIAS number) {                     \
+        write<numeric_types::ALIAS, true>(number);                             \
+    }
+
+    WRITE_IMPL(u16)
+    WRITE_IMPL(i16)
+    WRITE_IMPL(u32)
+    WRITE_IMPL(i32)
+    WRITE_IMPL(u64)
+    WRITE_IMPL(i64)
+    WRITE_IMPL(u128)
+    WRITE_IMPL(i128)
+    WRITE_IMPL(f32)
+    WRITE_IMPL(f64)
+
+#undef WRITE_IMPL
+
+  private:
+    Derived &self() { return static_cast<Derived &>(*this); }
+};
+
+// Cursor over borrowed memory (e.g. a mmap region), never copies on take
+class ByteReader : public ReadExt<ByteReader> {
+  public:
+    ByteReader(const ::std::uint8_t *bytes, ::std::size_t len)
+        : bytes(bytes), len(len) {}
+
+    // the whole input, position() bytes of it already read
+    const ::std::uint8_t *data() const { return bytes; }
+    ::std::size_t position() const { return pos; }
+    ::std::size_t remaining() const { return len - pos; }
+    bool is_empty() const { return pos == len; }
+
+    void seek(::std::size_t position) {
+        if (position > len) {
+            throw ::std::out_of_range("rusty::io: seek out of range");
+        }
+        pos = position;
+    }
+    void skip(::std::size_t n) { take(n); }
+
+    const ::std::uint8_t *take(::std::size_t n) {
+        if (n > remaining()) {
+            throw ::std::out_of_range("rusty::io: unexpected end of input");
+        }
+        const auto *p = bytes + pos;
+        pos += n;
+        return p;
+    }
+
+    void read_exact(::std::uint8_t *out, ::std::size_t n) {
+        ::std::memcpy(out, take(n), n);
+    }
+
+    // zero-copy view of the next @count encoded elements
+    template <typename N, bool BigEndian>
+    numeric_types::EndianSlice<N, BigEndian> read_slice(::std::size_t count) {
+        return {take(count * sizeof(N)), count};
+    }
+
+  private:
+    const ::std::uint8_t *bytes;
+    ::std::size_t len;
+    ::std::size_t pos = 0;
+};
+
+// Cursor appending to an owned growable buffer
+class ByteWriter : public WriteExt<ByteWriter> {
+  public:
+    void write_bytes(const ::std::uint8_t *bytes, ::std::size_t n) {
+        buffer.insert(buffer.end(), bytes, bytes + n);
+    }
+
+    const ::std::vector<::std::uint8_t> &bytes() const & { return buffer; }
+    ::std::vector<::std::uint8_t> into_inner() && { return ::std::move(buffer); }
+
+  private:
+    ::std::vector<::std::uint8_t> buffer;
+};
+
+// Sources return the count of bytes read, 0 only at end of input
+class IstreamSource {
+  public:
+    explicit IstreamSource(::std::istream &s) : s(&s) {}
+
+    ::std::size_t read(::std::uint8_t *out, ::std::size_t n) {
+        s->read(reinterpret_cast<char *>(out), // NOLINT
+                static_cast<::std::streamsize>(n));
+        if (s->bad()) {
+            throw ::std::runtime_error("rusty::io: istream read failed");
+        }
+        return static_cast<::std::size_t>(s->gcount());
+    }
+
+  private:
+    ::std::istream *s;
+};
+
+class OstreamSink {
+  public:
+    explicit OstreamSink(::std::ostream &s) : s(&s) {}
+
+    void write(const ::std::uint8_t *bytes, ::std::size_t n) {
+        if (!s->write(reinterpret_cast<const char *>(bytes), // NOLINT
+                      static_cast<::std::streamsize>(n))) {
+            throw ::std::runtime_error("rusty::io: ostream write failed");
+        }
+    }
+
+  private:
+    ::std::ostream *s;
+};
+
+#ifdef RUSTY_IO_HAS_FD
+class FdSource {
+  public:
+    explicit FdSource(int fd) : fd(fd) {}
+
+    ::std::size_t read(::std::uint8_t *out, ::std::size_t n) {
+        for (;;) {
+            const auto r = ::read(fd, out, n);
+            if (r >= 0) {
+                return static_cast<::std::size_t>(r);
+            }
+            if (errno != EINTR) {
+                throw ::std::system_error(errno, ::std::generic_category(),
+                                          "rusty::io: read");
+            }
+        }
+    }
+
+  private:
+    int fd;
+};
+
+class FdSink {
+  public:
+    explicit FdSink(int fd) : fd(fd) {}
+
+    void write(const ::std::uint8_t *bytes, ::std::size_t n) {
+        while (n > 0) {
+            const auto r = ::write(fd, bytes, n);
+            if (r < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw ::std::system_error(errno, ::std::generic_category(),
+                                          "rusty::io: write");
+            }
+            bytes += r;
+            n -= static_cast<::std::size_t>(r);
+        }
+    }
+
+  private:
+    int fd;
+};
+#endif
+
+// Reader refilling from @Source in large blocks, reads larger than the
+// buffer bypass it entirely
+template <typename Source> class BufReader : public ReadExt<BufReader<Source>> {
+  public:
+    static constexpr ::std::size_t DEFAULT_CAPACITY = 1 << 20;
+
+    explicit BufReader(Source source,
+                       ::std::size_t capacity = DEFAULT_CAPACITY)
+        : source(::std::move(source)), buffer(capacity) {}
+
+    ::std::size_t buffered() const { return end - begin; }
+
+    const ::std::uint8_t *take(::std::size_t n) {
+        if (buffered() < n) {
+            fill(n);
+        }
+        const auto *p = buffer.data() + begin;
+        begin += n;
+        return p;
+    }
+
+    void read_exact(::std::uint8_t *out, ::std::size_t n) {
+        const auto head = ::std::min(n, buffered());
+        ::std::memcpy(out, buffer.data() + begin, head);
+        begin += head;
+        out += head;
+        n -= head;
+        if (n >= buffer.size()) {
+            while (n > 0) {
+                const auto r = source.read(out, n);
+                if (r == 0) {
+                    throw ::std::out_of_range(
+                        "rusty::io: unexpected end of input");
+                }
+                out += r;
+                n -= r;
+            }
+        } else if (n > 0) {
+            ::std::memcpy(out, take(n), n);
+        }
+    }
+
+  private:
+    // make at least @n bytes contiguous in the buffer
+    void fill(::std::size_t n) {
+        ::std::memmove(buffer.data(), buffer.data() + begin, buffered());
+        end -= begin;
+        begin = 0;
+        if (buffer.size() < n) {
+            buffer.resize(n);
+        }
+        while (end < n) {
+            const auto r =
+                source.read(buffer.data() + end, buffer.size() - end);
+            if (r == 0) {
+                throw ::std::out_of_range("rusty::io: unexpected end of input");
+            }
+            end += r;
+        }
+    }
+
+    Source source;
+    ::std::vector<::std::uint8_t> buffer;
+    ::std::size_t begin = 0;
+    ::std::size_t end = 0;
+};
+
+// Writer flushing to @Sink in large blocks, flushed on destruction too
+template <typename Sink> class BufWriter : public WriteExt<BufWriter<Sink>> {
+  public:
+    static constexpr ::std::size_t DEFAULT_CAPACITY = 1 << 20;
+
+    explicit BufWriter(Sink sink, ::std::size_t capacity = DEFAULT_CAPACITY)
+        : sink(::std::move(sink)) {
+        buffer.reserve(capacity);
+    }
+    BufWriter(BufWriter &&) noexcept = default;
+    BufWriter(const BufWriter &) = delete;
+    BufWriter &operator=(const BufWriter &) = delete;
+    BufWriter &operator=(BufWriter &&) = delete;
+    ~BufWriter() {
+        try {
+            flush();
+        } catch (...) { // NOLINT(bugprone-empty-catch)
+            // errors on drop are ignored like rust, flush explicitly to see
+        }
+    }
+
+    void write_bytes(const ::std::uint8_t *bytes, ::std::size_t n) {
+        if (buffer.size() + n > buffer.capacity()) {
+            flush();
+        }
+        if (n >= buffer.capacity()) {
+            sink.write(bytes, n);
+        } else {
+            buffer.insert(buffer.end(), bytes, bytes + n);
+        }
+    }
+
+    void flush() {
+        if (!buffer.empty()) {
+            sink.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+
+  private:
+    Sink sink;
+    ::std::vector<::std::uint8_t> buffer;
+};
+
+using StreamReader = BufReader<IstreamSource>;
+using StreamWriter = BufWriter<OstreamSink>;
+#ifdef RUSTY_IO_HAS_FD
+using FdReader = BufReader<FdSource>;
+using FdWriter = BufWriter<FdSink>;
+#endif
+
+} // namespace rusty::io
+
+#endif // __RUSTY_IO_HPP__
@@ -0,0 +1,466 @@
+// SPDX-License-Identifier: MIT
+// Copyright(c) 2021 ur4t
+
+#ifndef __RUSTY_ITER_HPP__
+#define __RUSTY_ITER_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "collections.hpp"
+
+namespace rusty::iter {
+
+namespace detail {
+
+using collections::Pair;
+
+// value type stored by collect: references dropped, also inside pairs
+template <typename T> struct Owned {
+    using Type = typename ::std::decay<T>::type;
+};
+template <typename T1, typename T2> struct Owned<Pair<T1, T2>> {
+    using Type = Pair<typename Owned<T1>::Type, typename Owned<T2>::Type>;
+};
+template <typename T1, typename T2> struct Owned<const Pair<T1, T2>> {
+    using Type = Pair<typename Owned<T1>::Type, typename Owned<T2>::Type>;
+};
+
+// push_back for sequences, insert for maps
+template <typename C, typename T>
+auto append(C &c, T &&value, int /*preferred*/)
+    -> decltype(c.push_back(::std::forward<T>(value))) {
+    c.push_back(::std::forward<T>(value));
+}
+template <typename C, typename T>
+void append(C &c, T &&value, long /*fallback*/) {
+    c.insert(::std::forward<T>(value));
+}
+
+template <typename C>
+auto reserve(C &c, ::std::size_t n, int /*preferred*/)
+    -> decltype(c.reserve(n)) {
+    c.reserve(n);
+}
+template <typename C> void reserve(C & /*c*/, ::std::size_t /*n*/, long) {}
+
+// Stages push their items into a sink returning false to stop, so a whole
+// pipeline inlines into one loop. size_hint() is a lower bound, like the
+// first half of rust size_hint.
+
+template <typename It> class RangeStage {
+  public:
+    using Item = decltype(*::std::declval<It>());
+
+    RangeStage(It first, It last, ::std::size_t len)
+        : first(first), last(last), len(len) {}
+
+    template <typename F> void run(F &&sink) const {
+        for (auto it = first; it != last; ++it) {
+            if (!sink(*it)) {
+                return;
+            }
+        }
+    }
+    ::std::size_t size_hint() const noexcept { return len; }
+
+    It begin() const { return first; }
+    It end() const { return last; }
+
+  private:
+    It first;
+    It last;
+    ::std::size_t len;
+};
+
+template <typename S, typename F> class MapStage {
+  public:
+    using Item = decltype(::std::declval<const F &>()(
+        ::std::declval<typename S::Item>()));
+
+    MapStage(S base, F f) : base(::std::move(base)), f(::std::move(f)) {}
+
+    template <typename G> void run(G &&sink) const {
+        using In = typename S::Item;
+        base.run([&](In item) { return sink(f(::std::forward<In>(item))); });
+    }
+    ::std::size_t size_hint() const noexcept { return base.size_hint(); }
+
+  private:
+    S base;
+    F f;
+};
+
+template <typename S, typename P> class FilterStage {
+  public:
+    using Item = typename S::Item;
+
+    FilterStage(S base, P pred)
+        : base(::std::move(base)), pred(::std::move(pred)) {}
+
+    template <typename G> void run(G &&sink) const {
+        using Ref = const typename ::std::decay<Item>::type &;
+        // branching on the predicate itself keeps the loop vectorizable
+        base.run([&](Item item) {
+            if (pred(static_cast<Ref>(item))) {
+                return sink(::std::forward<Item>(item));
+            }
+            return true;
+        });
+    }
+    ::std::size_t size_hint() const noexcept { return 0; }
+
+  private:
+    S base;
+    P pred;
+};
+
+template <typename S> class TakeStage {
+  public:
+    using Item = typename S::Item;
+
+    TakeStage(S base, ::std::size_t n) : base(::std::move(base)), n(n) {}
+
+    template <typename G> void run(G &&sink) const {
+        auto left = n;
+        if (left > 0) {
+            base.run([&](Item item) {
+                return sink(::std::forward<Item>(item)) && --left > 0;
+            });
+        }
+    }
+    ::std::size_t size_hint() const noexcept {
+        return ::std::min(base.size_hint(), n);
+    }
+
+  private:
+    S base;
+    ::std::size_t n;
+};
+
+template <typename S> class SkipStage {
+  public:
+    using Item = typename S::Item;
+
+    SkipStage(S base, ::std::size_t n) : base(::std::move(base)), n(n) {}
+
+    template <typename G> void run(G &&sink) const {
+        auto left = n;
+        base.run([&](Item item) {
+            if (left > 0) {
+                --left;
+                return true;
+            }
+            return sink(::std::forward<Item>(item));
+        });
+    }
+    ::std::size_t size_hint() const noexcept {
+        return base.size_hint() > n ? base.size_hint() - n : 0;
+    }
+
+  private:
+    S base;
+    ::std::size_t n;
+};
+
+template <typename S> class EnumerateStage {
+  public:
+    using Item = Pair<::std::size_t, typename S::Item>;
+
+    explicit EnumerateStage(S base) : base(::std::move(base)) {}
+
+    template <typename G> void run(G &&sink) const {
+        using In = typename S::Item;
+        auto index = ::std::size_t{0};
+        base.run([&](In item) {
+            return sink(Item(index++, ::std::forward<In>(item)));
+        });
+    }
+    ::std::size_t size_hint() const noexcept { return base.size_hint(); }
+
+  private:
+    S base;
+};
+
+// pulls the second range while the first one pushes, ends with the shorter
+template <typename S, typename It> class ZipStage {
+  public:
+    using Item = Pair<typename S::Item, decltype(*::std::declval<It>())>;
+
+    ZipStage(S base, It first, It last, ::std::size_t len)
+        : base(::std::move(base)), first(first), last(last), len(len) {}
+
+    template <typename G> void run(G &&sink) const {
+        using In = typename S::Item;
+        auto it = first;
+        base.run([&](In item) {
+            if (it == last) {
+                return false;
+            }
+            auto pair = Item(::std::forward<In>(item), *it);
+            ++it;
+            return sink(::std::move(pair));
+        });
+    }
+    ::std::size_t size_hint() const noexcept {
+        return ::std::min(base.size_hint(), len);
+    }
+
+  private:
+    S base;
+    It first;
+    It last;
+    ::std::size_t len;
+};
+
+// both random access ranges zipped in one counted loop, which vectorizes
+// unlike the exit on the end of the second range
+template <typename It1, typename It2> class ZipRangeStage {
+  public:
+    using Item = Pair<decltype(*::std::declval<It1>()),
+                      decltype(*::std::declval<It2>())>;
+
+    ZipRangeStage(It1 first1, It1 last1, It2 first2, It2 last2)
+        : first1(first1), first2(first2),
+          len(static_cast<::std::size_t>(
+              ::std::min<::std::ptrdiff_t>(last1 - first1, last2 - first2))) {}
+
+    template <typename G> void run(G &&sink) const {
+        for (::std::size_t i = 0; i < len; ++i) {
+            if (!sink(Item(first1[i], first2[i]))) {
+                return;
+            }
+        }
+    }
+    ::std::size_t size_hint() const noexcept { return len; }
+
+  private:
+    It1 first1;
+    It2 first2;
+    ::std::size_t len;
+};
+
+template <typename It>
+using IsRandomAccess = ::std::is_base_of<
+    ::std::random_access_iterator_tag,
+    typename ::std::iterator_traits<It>::iterator_category>;
+
+template <typename S, typename It>
+ZipStage<S, It> zip_stage(const S &base, It first, It last,
+                          ::std::size_t len) {
+    return {base, first, last, len};
+}
+template <typename It1, typename It2>
+numeric_types::enable_if_t<IsRandomAccess<It1>::value &&
+                               IsRandomAccess<It2>::value,
+                           ZipRangeStage<It1, It2>>
+zip_stage(const RangeStage<It1> &base, It2 first, It2 last,
+          ::std::size_t /*len*/) {
+    return {base.begin(), base.end(), first, last};
+}
+
+template <typename S, typename C>
+using ZipStageOf = decltype(zip_stage(::std::declval<const S &>(),
+                                      ::std::begin(::std::declval<C &>()),
+                                      ::std::end(::std::declval<C &>()),
+                                      ::std::size_t{}));
+
+// slices of @size elements every @step elements, the shorter last one kept
+// only when @partial
+template <typename T> class SliceStage {
+  public:
+    using Item = collections::Slice<T>;
+
+    SliceStage(T *data, ::std::size_t len, ::std::size_t size,
+               ::std::size_t step, bool partial)
+        : data(data), len(len), size(size), step(step), partial(partial) {}
+
+    template <typename G> void run(G &&sink) const {
+        if (size == 0) {
+            return;
+        }
+        for (::std::size_t i = 0; i < len && (partial || len - i >= size);
+             i += step) {
+            if (!sink(Item(data + i, ::std::min(size, len - i)))) {
+                return;
+            }
+        }
+    }
+    ::std::size_t size_hint() const noexcept {
+        if (size == 0) {
+            return 0;
+        }
+        if (partial) {
+            return (len + step - 1) / step;
+        }
+        return len >= size ? (len - size) / step + 1 : 0;
+    }
+
+  private:
+    T *data;
+    ::std::size_t len;
+    ::std::size_t size;
+    ::std::size_t step;
+    bool partial;
+};
+
+template <typename C>
+using IteratorOf = decltype(::std::begin(::std::declval<C &>()));
+
+template <typename C>
+using ElementOf = typename ::std::remove_pointer<decltype(
+    ::std::declval<C &>().data())>::type;
+
+} // namespace detail
+
+// Lazy iterator over a stage like rust Iterator: adapters build a new
+// pipeline without running anything, consumers run it in one fused loop
+// with no intermediate container. Items are references into the source
+// until an adapter makes values.
+template <typename S> class Iter {
+  public:
+    using Item = typename S::Item;
+    using Owned = typename detail::Owned<Item>::Type;
+
+    explicit Iter(S stage) : stage(::std::move(stage)) {}
+
+    // adapters
+
+    template <typename F> Iter<detail::MapStage<S, F>> map(F f) const {
+        return Iter<detail::MapStage<S, F>>({stage, ::std::move(f)});
+    }
+    template <typename P> Iter<detail::FilterStage<S, P>> filter(P pred) const {
+        return Iter<detail::FilterStage<S, P>>({stage, ::std::move(pred)});
+    }
+    Iter<detail::TakeStage<S>> take(::std::size_t n) const {
+        return Iter<detail::TakeStage<S>>({stage, n});
+    }
+    Iter<detail::SkipStage<S>> skip(::std::size_t n) const {
+        return Iter<detail::SkipStage<S>>({stage, n});
+    }
+    // items become Pair<std::size_t, Item>
+    Iter<detail::EnumerateStage<S>> enumerate() const {
+        return Iter<detail::EnumerateStage<S>>(
+            detail::EnumerateStage<S>(stage));
+    }
+    // items become Pair<Item, element of @other>, @other must outlive it
+    template <typename C>
+    Iter<detail::ZipStageOf<S, C>> zip(C &other) const {
+        return Iter<detail::ZipStageOf<S, C>>(detail::zip_stage(
+            stage, ::std::begin(other), ::std::end(other),
+            static_cast<::std::size_t>(other.size())));
+    }
+    template <typename C> void zip(const C &&other) const = delete;
+
+    // consumers
+
+    template <typename F> void for_each(F f) const {
+        stage.run([&](Item item) {
+            f(::std::forward<Item>(item));
+            return true;
+        });
+    }
+
+    template <typename T, typename F> T fold(T init, F f) const {
+        stage.run([&](Item item) {
+            init = f(::std::move(init), ::std::forward<Item>(item));
+            return true;
+        });
+        return init;
+    }
+
+    Owned sum() const {
+        return fold(Owned{}, [](Owned acc, Item item) {
+            return static_cast<Owned>(acc + item);
+        });
+    }
+
+    ::std::size_t count() const {
+        auto n = ::std::size_t{0};
+        stage.run([&n](Item /*item*/) {
+            ++n;
+            return true;
+        });
+        return n;
+    }
+
+    // stop at the first item matching @pred
+    template <typename P> bool any(P pred) const {
+        auto found = false;
+        stage.run([&](Item item) {
+            found = pred(static_cast<const Owned &>(item));
+            return !found;
+        });
+        return found;
+    }
+    template <typename P> bool all(P pred) const {
+        auto ok = true;
+        stage.run([&](Item item) {
+            ok = pred(static_cast<const Owned &>(item));
+            return ok;
+        });
+        return ok;
+    }
+
+    // into any container with push_back or insert, like
+    // `collect<Vec<u32>>()`, `collect<Vec>()` or `collect<HashMap<K, V>>()`
+    template <typename C = collections::Vec<Owned>> C collect() const {
+        C out;
+        detail::reserve(out, stage.size_hint(), 0);
+        stage.run([&out](Item item) {
+            detail::append(out, ::std::forward<Item>(item), 0);
+            return true;
+        });
+        return out;
+    }
+    template <template <typename...> class C> C<Owned> collect() const {
+        return collect<C<Owned>>();
+    }
+
+    ::std::size_t size_hint() const noexcept { return stage.size_hint(); }
+
+  private:
+    S stage;
+};
+
+// items of any container, e.g. Vec, Array, SmallVec and HashMap; mutable
+// references for a non const container
+template <typename C>
+Iter<detail::RangeStage<detail::IteratorOf<C>>> iter(C &container) {
+    return Iter<detail::RangeStage<detail::IteratorOf<C>>>(
+        {::std::begin(container), ::std::end(container),
+         static_cast<::std::size_t>(container.size())});
+}
+template <typename C> void iter(const C &&container) = delete;
+
+// @first to @last, with @len as size hint
+template <typename It>
+Iter<detail::RangeStage<It>> iter(It first, It last, ::std::size_t len = 0) {
+    return Iter<detail::RangeStage<It>>({first, last, len});
+}
+
+// Slices of @size elements from a contiguous container, the last one shorter
+// when @size does not divide its length; none at all for a zero @size
+template <typename C>
+Iter<detail::SliceStage<detail::ElementOf<C>>> chunks(C &container,
+                                                      ::std::size_t size) {
+    return Iter<detail::SliceStage<detail::ElementOf<C>>>(
+        {container.data(), container.size(), size, size, true});
+}
+template <typename C> void chunks(const C &&container, ::std::size_t) = delete;
+
+// every run of @size consecutive elements, overlapping
+template <typename C>
+Iter<detail::SliceStage<detail::ElementOf<C>>> windows(C &container,
+                                                       ::std::size_t size) {
+    return Iter<detail::SliceStage<detail::ElementOf<C>>>(
+        {container.data(), container.size(), size, 1, false});
+}
+template <typename C> void windows(const C &&container, ::std::size_t) = delete;
+
+} // namespace rusty::iter
+
+#endif // __RUSTY_ITER_HPP__
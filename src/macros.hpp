@@ -4,18 +4,72 @@
 #ifndef __RUSTY_MACROS_HPP__
 #define __RUSTY_MACROS_HPP__
 
-// use a temporary variable in case that @x contains side effect
-#define dbg(x, ...)                                                            \
-    [&] {                                                                      \
-        auto t = (x);                                                          \
-        auto flag = ::std::cerr.flags();                                       \
-        auto precision = ::std::cerr.precision();                              \
-        ::std::cerr << "[" __FILE__ ":" << __LINE__                            \
-                    << "] " #x " = " __VA_ARGS__ << t << ::std::endl;          \
-        ::std::cerr.flags(flag);                                               \
-        ::std::cerr.precision(precision);                                      \
-        return t;                                                              \
-    }()
+// dbg backend lives in debug.hpp, configured by RUSTY_DBG_LEVEL,
+// RUSTY_DBG_RATE_LIMIT, RUSTY_DBG_ASYNC and RUSTY_DBG_METRICS
+
+// defaults of debug.hpp, repeated for `import rusty;` which exports no macro
+#ifndef RUSTY_DBG_LEVEL
+#define RUSTY_DBG_LEVEL 1
+#endif
+#ifndef RUSTY_DBG_RATE_LIMIT
+#define RUSTY_DBG_RATE_LIMIT 0
+#endif
+
+#if RUSTY_DBG_LEVEL <= 0
+#define dbg_level(level, x, ...) (x)
+#define dbg(x, ...) (x)
+#else
+// @x is evaluated once and forwarded: lvalues by reference, temporaries
+// moved; it is never named in an unevaluated context, so it may hold lambdas
+#define RUSTY_DBG_IMPL(level, expr, x, ...)                                    \
+    ::rusty::debug::forward_record(                                            \
+        (level) <= RUSTY_DBG_LEVEL,                                            \
+        []() -> ::rusty::debug::RateLimit & {                                  \
+            static ::rusty::debug::RateLimit limit;                            \
+            return limit;                                                      \
+        },                                                                     \
+        RUSTY_DBG_RATE_LIMIT, __FILE__, __LINE__, expr,                        \
+        sizeof(#__VA_ARGS__) > 1,                                              \
+        [&](::std::ostream &rusty_dbg_stream) -> ::std::ostream & {            \
+            return rusty_dbg_stream __VA_ARGS__;                               \
+        },                                                                     \
+        (x))
+#define dbg_level(level, x, ...) RUSTY_DBG_IMPL(level, #x, x, __VA_ARGS__)
+#define dbg(x, ...) RUSTY_DBG_IMPL(1, #x, x, __VA_ARGS__)
+#endif
+
+// dbg_time(name) times the rest of the enclosing scope, dbg_count(name)
+// counts executions and dbg_hist(name, value) records a distribution of
+// unsigned values. Without RUSTY_DBG_METRICS (see debug.hpp) they expand
+// to nothing and @value is not evaluated.
+#ifdef RUSTY_DBG_METRICS
+#define RUSTY_DBG_CAT_IMPL(a, b) a##b
+#define RUSTY_DBG_CAT(a, b) RUSTY_DBG_CAT_IMPL(a, b)
+#define RUSTY_DBG_SITE(name, kind)                                             \
+    static const ::rusty::debug::MetricSite RUSTY_DBG_CAT(rusty_dbg_site_,    \
+                                                          __LINE__)(           \
+        name, ::rusty::debug::MetricKind::kind, __FILE__, __LINE__)
+#define dbg_time(name)                                                         \
+    RUSTY_DBG_SITE(name, Time);                                                \
+    const ::rusty::debug::ScopedTimer RUSTY_DBG_CAT(rusty_dbg_timer_,          \
+                                                    __LINE__)(                 \
+        RUSTY_DBG_CAT(rusty_dbg_site_, __LINE__))
+#define dbg_count(name)                                                        \
+    do {                                                                       \
+        RUSTY_DBG_SITE(name, Count);                                           \
+        ::rusty::debug::count_metric(RUSTY_DBG_CAT(rusty_dbg_site_, __LINE__)); \
+    } while (false)
+#define dbg_hist(name, value)                                                  \
+    do {                                                                       \
+        RUSTY_DBG_SITE(name, Hist);                                            \
+        ::rusty::debug::record_metric(RUSTY_DBG_CAT(rusty_dbg_site_, __LINE__), \
+                                      static_cast<unsigned long long>(value)); \
+    } while (false)
+#else
+#define dbg_time(name) static_cast<void>(0)
+#define dbg_count(name) static_cast<void>(0)
+#define dbg_hist(name, value) static_cast<void>(sizeof(value))
+#endif
 
 #define assert_eq(left, right) assert((left) == (right))
 #define assert_ne(left, right) assert(!((left) == (right)))
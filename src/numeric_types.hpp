@@ -4,10 +4,34 @@
 #ifndef __RUSTY_NUMERIC_TYPES_HPP__
 #define __RUSTY_NUMERIC_TYPES_HPP__
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <istream>
+#include <iterator>
 #include <limits>
+#include <locale>
 #include <ostream>
+#include <stdexcept>
+
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+#if __cplusplus >= 202002L
+#include <bit>
+#endif
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace rusty::numeric_types {
 
@@ -25,16 +49,1491 @@ constexpr bool is_trivial_v = ::std::is_trivial<T>::value;
 using ::std::is_trivial_v;
 #endif
 
-// bit casting from https://en.cppreference.com/w/cpp/numeric/bit_cast
+// constexpr for functions mutating state, which C++11 does not allow
+#if __cplusplus >= 201402L
+#define RUSTY_CONSTEXPR14 constexpr
+#else
+#define RUSTY_CONSTEXPR14
+#endif
+
+#ifdef __has_builtin
+#if __has_builtin(__builtin_bit_cast)
+#define RUSTY_HAS_BUILTIN_BIT_CAST
+#endif
+#endif
+
+// bit casting from https://en.cppreference.com/w/cpp/numeric/bit_cast,
+// constexpr capable when the compiler provides __builtin_bit_cast
 template <class T1, class T2>
 constexpr enable_if_t<
     sizeof(T1) == sizeof(T2) && is_trivial_v<T2> && is_trivial_v<T1>, T1>
 bit_cast(const T2 &from) noexcept {
+#ifdef RUSTY_HAS_BUILTIN_BIT_CAST
+    return __builtin_bit_cast(T1, from);
+#else
     T1 to;
     ::std::memcpy(&to, &from, sizeof(T1));
     return to;
+#endif
+}
+
+// i128/u128 map to __int128 when the compiler provides it, otherwise (or
+// with RUSTY_NO_INT128 defined) to a portable two limb implementation
+#if defined(__SIZEOF_INT128__) && !defined(RUSTY_NO_INT128)
+#define RUSTY_HAS_INT128
+#endif
+
+namespace detail {
+
+#ifndef RUSTY_HAS_INT128
+// high 64 bits of the full 64x64 product, from 32-bit partial products
+constexpr ::std::uint64_t mul_hi64(::std::uint64_t a,
+                                   ::std::uint64_t b) noexcept {
+    return (a >> 32) * (b >> 32) + (((a & 0xffffffff) * (b >> 32)) >> 32) +
+           (((a >> 32) * (b & 0xffffffff)) >> 32) +
+           (((((a & 0xffffffff) * (b & 0xffffffff)) >> 32) +
+             (((a & 0xffffffff) * (b >> 32)) & 0xffffffff) +
+             (((a >> 32) * (b & 0xffffffff)) & 0xffffffff)) >>
+            32);
+}
+
+template <typename I> constexpr bool is_negative(I value) noexcept {
+    return ::std::is_signed<I>::value && value < I(0);
+}
+
+// quotient of @hi:@lo by @d, which needs @hi < @d so that it fits in 64 bits:
+// two steps of Knuth's algorithm D over 32-bit digits, @d normalized first
+inline ::std::uint64_t div128_64(::std::uint64_t hi, ::std::uint64_t lo,
+                                 ::std::uint64_t d,
+                                 ::std::uint64_t &rem) noexcept {
+    constexpr auto base = ::std::uint64_t{1} << 32;
+    auto shift = 0U;
+    for (auto bits = 32U; bits != 0; bits /= 2) {
+        if ((d << shift) >> (64 - bits) == 0) {
+            shift += bits;
+        }
+    }
+    d <<= shift;
+    const auto d1 = d >> 32;
+    const auto d0 = d & 0xffffffff;
+    const auto top = shift == 0 ? hi : hi << shift | lo >> (64 - shift);
+    lo <<= shift;
+    // one quotient digit of @u (three digits, the last being @next) by @d,
+    // the estimate from the top digits is at most two too large
+    const auto digit = [&](::std::uint64_t u,
+                           ::std::uint64_t next) -> ::std::uint64_t {
+        auto q = u / d1;
+        auto r = u - q * d1;
+        while (q >= base || q * d0 > (r << 32 | next)) {
+            --q;
+            r += d1;
+            if (r >= base) {
+                break;
+            }
+        }
+        return q;
+    };
+    const auto q1 = digit(top, lo >> 32);
+    const auto mid = (top << 32 | lo >> 32) - q1 * d;
+    const auto q0 = digit(mid, lo & 0xffffffff);
+    rem = ((mid << 32 | (lo & 0xffffffff)) - q0 * d) >> shift;
+    return q1 << 32 | q0;
+}
+
+// two's complement 128-bit integer laid out like a native one
+template <bool Signed> class TwoLimb {
+  public:
+#if defined(_WIN32) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    ::std::uint64_t lo, hi;
+#define TWO_LIMB_INIT(h, l) lo(l), hi(h)
+#else
+    ::std::uint64_t hi, lo;
+#define TWO_LIMB_INIT(h, l) hi(h), lo(l)
+#endif
+
+    TwoLimb() = default;
+    constexpr TwoLimb(::std::uint64_t h, ::std::uint64_t l, int /*tag*/)
+        : TWO_LIMB_INIT(h, l) {}
+    template <typename I,
+              enable_if_t<::std::is_integral<I>::value, int> = 0>
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    constexpr TwoLimb(I value) noexcept
+        : TWO_LIMB_INIT(is_negative(value) ? ~0ULL : 0ULL,
+                        static_cast<::std::uint64_t>(value)) {}
+    constexpr explicit TwoLimb(const TwoLimb<!Signed> &other) noexcept
+        : TWO_LIMB_INIT(other.hi, other.lo) {}
+    template <typename F,
+              enable_if_t<::std::is_floating_point<F>::value, int> = 0>
+    explicit TwoLimb(F value) noexcept : TwoLimb(0) {
+        const auto negative = value < 0;
+        value = negative ? -value : value;
+        hi = static_cast<::std::uint64_t>(value / 18446744073709551616.0);
+        lo = static_cast<::std::uint64_t>(
+            value - static_cast<F>(hi) * 18446744073709551616.0);
+        *this = negative ? -*this : *this;
+    }
+
+#undef TWO_LIMB_INIT
+
+    template <typename I, enable_if_t<::std::is_integral<I>::value, int> = 0>
+    constexpr explicit operator I() const noexcept {
+        return static_cast<I>(lo);
+    }
+    template <typename F,
+              enable_if_t<::std::is_floating_point<F>::value, int> = 0>
+    explicit operator F() const noexcept {
+        return is_negative_value()
+                   ? -static_cast<F>(TwoLimb<false>(-*this))
+                   : static_cast<F>(hi) * static_cast<F>(18446744073709551616.0) +
+                         static_cast<F>(lo);
+    }
+    constexpr explicit operator bool() const noexcept { return hi || lo; }
+
+    constexpr bool is_negative_value() const noexcept {
+        return Signed && (hi >> 63) != 0;
+    }
+
+    friend constexpr TwoLimb operator+(const TwoLimb &a) noexcept { return a; }
+    friend constexpr TwoLimb operator-(const TwoLimb &a) noexcept {
+        return TwoLimb(0) - a;
+    }
+    friend constexpr TwoLimb operator~(const TwoLimb &a) noexcept {
+        return TwoLimb(~a.hi, ~a.lo, 0);
+    }
+
+    friend constexpr TwoLimb operator+(const TwoLimb &a,
+                                       const TwoLimb &b) noexcept {
+        return TwoLimb(a.hi + b.hi + (a.lo + b.lo < a.lo ? 1 : 0),
+                       a.lo + b.lo, 0);
+    }
+    friend constexpr TwoLimb operator-(const TwoLimb &a,
+                                       const TwoLimb &b) noexcept {
+        return TwoLimb(a.hi - b.hi - (a.lo < b.lo ? 1 : 0), a.lo - b.lo, 0);
+    }
+    friend constexpr TwoLimb operator*(const TwoLimb &a,
+                                       const TwoLimb &b) noexcept {
+        return TwoLimb(mul_hi64(a.lo, b.lo) + a.lo * b.hi + a.hi * b.lo,
+                       a.lo * b.lo, 0);
+    }
+    friend TwoLimb operator/(const TwoLimb &a, const TwoLimb &b) noexcept {
+        TwoLimb remainder;
+        return divmod(a, b, remainder);
+    }
+    friend TwoLimb operator%(const TwoLimb &a, const TwoLimb &b) noexcept {
+        TwoLimb remainder;
+        divmod(a, b, remainder);
+        return remainder;
+    }
+
+#define BITWISE_IMPL(op)                                                       \
+    friend constexpr TwoLimb operator op(const TwoLimb &a,                     \
+                                         const TwoLimb &b) noexcept {          \
+        return TwoLimb(a.hi op b.hi, a.lo op b.lo, 0);                         \
+    }
+
+    BITWISE_IMPL(&)
+    BITWISE_IMPL(|)
+    BITWISE_IMPL(^)
+
+#undef BITWISE_IMPL
+
+    friend constexpr TwoLimb operator<<(const TwoLimb &a, unsigned n) noexcept {
+        return n == 0    ? a
+               : n < 64  ? TwoLimb(a.hi << n | a.lo >> (64 - n), a.lo << n, 0)
+               : n < 128 ? TwoLimb(a.lo << (n - 64), 0, 0)
+                         : TwoLimb(0);
+    }
+    // arithmetic for signed, logical for unsigned
+    friend constexpr TwoLimb operator>>(const TwoLimb &a, unsigned n) noexcept {
+        return n == 0 ? a
+               : n < 64
+                   ? TwoLimb(a.shifted_hi(n), a.lo >> n | a.hi << (64 - n), 0)
+               : n < 128 ? TwoLimb(a.fill(), a.shifted_hi(n - 64), 0)
+                         : TwoLimb(a.fill(), a.fill(), 0);
+    }
+    friend constexpr TwoLimb operator<<(const TwoLimb &a,
+                                        const TwoLimb &n) noexcept {
+        return a << static_cast<unsigned>(n.lo);
+    }
+    friend constexpr TwoLimb operator>>(const TwoLimb &a,
+                                        const TwoLimb &n) noexcept {
+        return a >> static_cast<unsigned>(n.lo);
+    }
+
+    friend constexpr bool operator==(const TwoLimb &a,
+                                     const TwoLimb &b) noexcept {
+        return a.hi == b.hi && a.lo == b.lo;
+    }
+    friend constexpr bool operator!=(const TwoLimb &a,
+                                     const TwoLimb &b) noexcept {
+        return !(a == b);
+    }
+    friend constexpr bool operator<(const TwoLimb &a,
+                                    const TwoLimb &b) noexcept {
+        return a.hi != b.hi ? (Signed ? static_cast<::std::int64_t>(a.hi) <
+                                            static_cast<::std::int64_t>(b.hi)
+                                      : a.hi < b.hi)
+                            : a.lo < b.lo;
+    }
+    friend constexpr bool operator>(const TwoLimb &a,
+                                    const TwoLimb &b) noexcept {
+        return b < a;
+    }
+    friend constexpr bool operator<=(const TwoLimb &a,
+                                     const TwoLimb &b) noexcept {
+        return !(b < a);
+    }
+    friend constexpr bool operator>=(const TwoLimb &a,
+                                     const TwoLimb &b) noexcept {
+        return !(a < b);
+    }
+
+#define ASSIGN_IMPL(op)                                                        \
+    RUSTY_CONSTEXPR14 TwoLimb &operator op##=(const TwoLimb &other) noexcept { \
+        return *this = *this op other;                                         \
+    }
+
+    ASSIGN_IMPL(+)
+    ASSIGN_IMPL(-)
+    ASSIGN_IMPL(*)
+    ASSIGN_IMPL(/)
+    ASSIGN_IMPL(%)
+    ASSIGN_IMPL(&)
+    ASSIGN_IMPL(|)
+    ASSIGN_IMPL(^)
+    ASSIGN_IMPL(<<)
+    ASSIGN_IMPL(>>)
+
+#undef ASSIGN_IMPL
+
+    RUSTY_CONSTEXPR14 TwoLimb &operator++() noexcept { return *this += 1; }
+    RUSTY_CONSTEXPR14 TwoLimb &operator--() noexcept { return *this -= 1; }
+    RUSTY_CONSTEXPR14 TwoLimb
+    operator++(int) noexcept { // NOLINT(cert-dcl21-cpp)
+        const auto old = *this;
+        ++*this;
+        return old;
+    }
+    RUSTY_CONSTEXPR14 TwoLimb
+    operator--(int) noexcept { // NOLINT(cert-dcl21-cpp)
+        const auto old = *this;
+        --*this;
+        return old;
+    }
+
+  private:
+    constexpr ::std::uint64_t fill() const noexcept {
+        return is_negative_value() ? ~0ULL : 0ULL;
+    }
+    constexpr ::std::uint64_t shifted_hi(unsigned n) const noexcept {
+        return Signed ? static_cast<::std::uint64_t>(
+                            static_cast<::std::int64_t>(hi) >> n)
+                      : hi >> n;
+    }
+
+    // truncating division of magnitudes, signs fixed up afterwards
+    static TwoLimb divmod(const TwoLimb &a, const TwoLimb &b,
+                          TwoLimb &remainder) noexcept {
+        const auto negative_a = a.is_negative_value();
+        const auto negative_b = b.is_negative_value();
+        const auto n = TwoLimb<false>(negative_a ? -a : a);
+        const auto d = TwoLimb<false>(negative_b ? -b : b);
+        TwoLimb<false> r;
+        const auto q = TwoLimb<false>::divmod_unsigned(n, d, r);
+        remainder = negative_a ? -TwoLimb(r) : TwoLimb(r);
+        return negative_a != negative_b ? -TwoLimb(q) : TwoLimb(q);
+    }
+
+    static TwoLimb divmod_unsigned(const TwoLimb &n, const TwoLimb &d,
+                                   TwoLimb &r) noexcept {
+        if (n.hi == 0 && d.hi == 0) {
+            r = TwoLimb(n.lo % d.lo);
+            return TwoLimb(n.lo / d.lo);
+        }
+        if (d.hi == 0 && d.lo <= 0xffffffff) {
+            // schoolbook over 32-bit limbs, one hardware division each
+            const ::std::uint64_t limbs[] = {n.hi >> 32, n.hi & 0xffffffff,
+                                             n.lo >> 32, n.lo & 0xffffffff};
+            ::std::uint64_t q[4] = {}; // NOLINT(modernize-avoid-c-arrays)
+            ::std::uint64_t rem = 0;
+            for (auto i = 0; i < 4; ++i) {
+                const auto cur = rem << 32 | limbs[i];
+                q[i] = cur / d.lo;
+                rem = cur % d.lo;
+            }
+            r = TwoLimb(rem);
+            return TwoLimb(q[0] << 32 | q[1], q[2] << 32 | q[3], 0);
+        }
+        if (d.hi == 0) {
+            // the high limb alone, then the remainder with the low limb
+            ::std::uint64_t rem = 0;
+            const auto lo = div128_64(n.hi % d.lo, n.lo, d.lo, rem);
+            r = TwoLimb(rem);
+            return TwoLimb(n.hi / d.lo, lo, 0);
+        }
+        // shift-subtract, a divisor of 2^64 or more leaves a 64-bit quotient
+        TwoLimb q(0);
+        r = TwoLimb(0);
+        for (auto i = 127; i >= 0; --i) {
+            r = r << 1U | ((n >> static_cast<unsigned>(i)) & TwoLimb(1));
+            if (r >= d) {
+                r -= d;
+                q = q | (TwoLimb(1) << static_cast<unsigned>(i));
+            }
+        }
+        return q;
+    }
+
+    friend class TwoLimb<!Signed>;
+};
+#endif
+
+} // namespace detail
+
+#ifdef RUSTY_HAS_INT128
+__extension__ using int128 = __int128;          // NOLINT
+__extension__ using uint128 = unsigned __int128; // NOLINT
+#else
+using int128 = detail::TwoLimb<true>;
+using uint128 = detail::TwoLimb<false>;
+#endif
+
+namespace detail {
+
+// std traits extended to the 128-bit integers, which are not integral
+// under strict -std=c++XX modes
+template <typename T> struct IsInteger : ::std::is_integral<T> {};
+template <> struct IsInteger<int128> : ::std::true_type {};
+template <> struct IsInteger<uint128> : ::std::true_type {};
+
+template <typename T> struct IsSigned : ::std::is_signed<T> {};
+template <> struct IsSigned<int128> : ::std::true_type {};
+template <> struct IsSigned<uint128> : ::std::false_type {};
+
+template <typename T, typename = void> struct MakeUnsigned {
+    using Type = T;
+};
+template <typename T>
+struct MakeUnsigned<T, enable_if_t<::std::is_integral<T>::value>> {
+    using Type = typename ::std::make_unsigned<T>::type;
+};
+template <> struct MakeUnsigned<int128> { using Type = uint128; };
+template <> struct MakeUnsigned<uint128> { using Type = uint128; };
+
+template <typename T> struct Limits {
+    static constexpr T max() noexcept { return ::std::numeric_limits<T>::max(); }
+    static constexpr T min() noexcept { return ::std::numeric_limits<T>::min(); }
+};
+template <> struct Limits<uint128> {
+    static constexpr uint128 max() noexcept { return ~uint128(0); }
+    static constexpr uint128 min() noexcept { return uint128(0); }
+};
+template <> struct Limits<int128> {
+    static constexpr int128 max() noexcept {
+        return int128(Limits<uint128>::max() >> 1U);
+    }
+    static constexpr int128 min() noexcept { return -max() - int128(1); }
+};
+
+} // namespace detail
+
+namespace detail {
+
+template <::std::size_t N> struct UintOf;
+template <> struct UintOf<1> { using Type = ::std::uint8_t; };
+template <> struct UintOf<2> { using Type = ::std::uint16_t; };
+template <> struct UintOf<4> { using Type = ::std::uint32_t; };
+template <> struct UintOf<8> { using Type = ::std::uint64_t; };
+template <> struct UintOf<16> { using Type = uint128; };
+
+// single bswap instruction, usable in constant expressions
+#if defined(__cpp_lib_byteswap)
+template <typename T> constexpr T byteswap(T value) noexcept {
+    return ::std::byteswap(value);
+}
+#elif defined(__GNUC__) || defined(__clang__)
+constexpr ::std::uint8_t byteswap(::std::uint8_t value) noexcept {
+    return value;
+}
+constexpr ::std::uint16_t byteswap(::std::uint16_t value) noexcept {
+    return __builtin_bswap16(value);
+}
+constexpr ::std::uint32_t byteswap(::std::uint32_t value) noexcept {
+    return __builtin_bswap32(value);
+}
+constexpr ::std::uint64_t byteswap(::std::uint64_t value) noexcept {
+    return __builtin_bswap64(value);
+}
+#else
+// shift patterns recognized by compilers as bswap
+constexpr ::std::uint8_t byteswap(::std::uint8_t value) noexcept {
+    return value;
+}
+constexpr ::std::uint16_t byteswap(::std::uint16_t value) noexcept {
+    return static_cast<::std::uint16_t>((value << 8) | (value >> 8));
+}
+constexpr ::std::uint32_t byteswap(::std::uint32_t value) noexcept {
+    return ((value & 0x000000ffU) << 24) | ((value & 0x0000ff00U) << 8) |
+           ((value & 0x00ff0000U) >> 8) | ((value & 0xff000000U) >> 24);
+}
+constexpr ::std::uint64_t byteswap(::std::uint64_t value) noexcept {
+    return (static_cast<::std::uint64_t>(
+                byteswap(static_cast<::std::uint32_t>(value)))
+            << 32) |
+           byteswap(static_cast<::std::uint32_t>(value >> 32));
+}
+#endif
+constexpr uint128 byteswap(uint128 value) noexcept {
+    return static_cast<uint128>(byteswap(static_cast<::std::uint64_t>(value)))
+               << 64U |
+           static_cast<uint128>(
+               byteswap(static_cast<::std::uint64_t>(value >> 64U)));
+}
+
+// reverse every @W-byte element of @count elements from @src into @dst,
+// @src and @dst may alias exactly (in-place swapping)
+template <::std::size_t W>
+inline void swap_bytes_block(const ::std::uint8_t *src, ::std::uint8_t *dst,
+                             ::std::size_t count) noexcept {
+    static_assert(W == 1 || W == 2 || W == 4 || W == 8 || W == 16,
+                  "unsupported width!");
+    ::std::size_t i = 0;
+    if (W == 1) {
+        if (src != dst) {
+            ::std::memmove(dst, src, count);
+        }
+        return;
+    }
+#if defined(__SSSE3__) || defined(__AVX2__)
+    // pshufb mask mapping byte j to (j / W) * W + (W - 1 - j % W)
+    const __m128i mask =
+        W == 2   ? _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12,
+                                 15, 14)
+        : W == 4 ? _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14,
+                                 13, 12)
+        : W == 8 ? _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11,
+                                 10, 9, 8)
+                 : _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3,
+                                 2, 1, 0);
+#if defined(__AVX2__)
+    // vpshufb shuffles within 128-bit lanes, so the mask is just duplicated
+    const __m256i mask256 = _mm256_broadcastsi128_si256(mask);
+    for (; i + 32 / W <= count; i += 32 / W) {
+        const auto v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(src + i * W)); // NOLINT
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * W), // NOLINT
+                            _mm256_shuffle_epi8(v, mask256));
+    }
+#endif
+    for (; i + 16 / W <= count; i += 16 / W) {
+        const auto v = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src + i * W)); // NOLINT
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * W), // NOLINT
+                         _mm_shuffle_epi8(v, mask));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 / W <= count; i += 16 / W) {
+        const auto v = vld1q_u8(src + i * W);
+        vst1q_u8(dst + i * W,
+                 W == 2   ? vrev16q_u8(v)
+                 : W == 4 ? vrev32q_u8(v)
+                 : W == 8 ? vrev64q_u8(v)
+                          : vextq_u8(vrev64q_u8(v), vrev64q_u8(v), 8));
+    }
+#endif
+    // scalar tail (or whole range without simd)
+    for (; i < count; ++i) {
+        typename UintOf<W>::Type tmp;
+        ::std::memcpy(&tmp, src + i * W, W);
+        tmp = byteswap(tmp);
+        ::std::memcpy(dst + i * W, &tmp, W);
+    }
 }
 
+// bit counts of 64-bit words in single popcnt/lzcnt/tzcnt (or bsr/bsf)
+// instructions, usable in constant expressions; zero counts 64 zeros
+#if defined(__cpp_lib_bitops)
+constexpr unsigned popcount64(::std::uint64_t v) noexcept {
+    return static_cast<unsigned>(::std::popcount(v));
+}
+constexpr unsigned clz64(::std::uint64_t v) noexcept {
+    return static_cast<unsigned>(::std::countl_zero(v));
+}
+constexpr unsigned ctz64(::std::uint64_t v) noexcept {
+    return static_cast<unsigned>(::std::countr_zero(v));
+}
+#elif defined(__GNUC__) || defined(__clang__)
+constexpr unsigned popcount64(::std::uint64_t v) noexcept {
+    return static_cast<unsigned>(__builtin_popcountll(v));
+}
+constexpr unsigned clz64(::std::uint64_t v) noexcept {
+    return v == 0 ? 64 : static_cast<unsigned>(__builtin_clzll(v));
+}
+constexpr unsigned ctz64(::std::uint64_t v) noexcept {
+    return v == 0 ? 64 : static_cast<unsigned>(__builtin_ctzll(v));
+}
+#else
+// swar patterns recognized by compilers as popcnt
+constexpr ::std::uint64_t popcount_pairs(::std::uint64_t v) noexcept {
+    return v - ((v >> 1) & 0x5555555555555555ULL);
+}
+constexpr ::std::uint64_t popcount_nibbles(::std::uint64_t v) noexcept {
+    return (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+}
+constexpr ::std::uint64_t popcount_bytes(::std::uint64_t v) noexcept {
+    return (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+}
+constexpr unsigned popcount64(::std::uint64_t v) noexcept {
+    return static_cast<unsigned>(
+        (popcount_bytes(popcount_nibbles(popcount_pairs(v))) *
+         0x0101010101010101ULL) >>
+        56);
+}
+// every bit below the highest set one set too
+constexpr ::std::uint64_t smear_right(::std::uint64_t v,
+                                      unsigned shift = 1) noexcept {
+    return shift == 64 ? v : smear_right(v | (v >> shift), shift * 2);
+}
+constexpr unsigned clz64(::std::uint64_t v) noexcept {
+    return 64 - popcount64(smear_right(v));
+}
+constexpr unsigned ctz64(::std::uint64_t v) noexcept {
+    return popcount64(~v & (v - 1));
+}
+#endif
+
+constexpr unsigned at_most(unsigned n, unsigned bound) noexcept {
+    return n < bound ? n : bound;
+}
+
+// the same bits as an unsigned integer, the domain of every bit operation
+template <typename I>
+constexpr typename UintOf<sizeof(I)>::Type as_unsigned(const I &v) noexcept {
+    return static_cast<typename UintOf<sizeof(I)>::Type>(v);
+}
+
+template <typename U> constexpr unsigned count_ones(U v) noexcept {
+    return popcount64(v);
+}
+template <typename U> constexpr unsigned leading_zeros(U v) noexcept {
+    return clz64(v) - (64 - 8 * sizeof(U));
+}
+template <typename U> constexpr unsigned trailing_zeros(U v) noexcept {
+    return at_most(ctz64(v), 8 * sizeof(U));
+}
+constexpr unsigned count_ones(uint128 v) noexcept {
+    return popcount64(static_cast<::std::uint64_t>(v)) +
+           popcount64(static_cast<::std::uint64_t>(v >> 64U));
+}
+constexpr unsigned leading_zeros(uint128 v) noexcept {
+    return static_cast<::std::uint64_t>(v >> 64U) == 0
+               ? 64 + clz64(static_cast<::std::uint64_t>(v))
+               : clz64(static_cast<::std::uint64_t>(v >> 64U));
+}
+constexpr unsigned trailing_zeros(uint128 v) noexcept {
+    return static_cast<::std::uint64_t>(v) == 0
+               ? 64 + ctz64(static_cast<::std::uint64_t>(v >> 64U))
+               : ctz64(static_cast<::std::uint64_t>(v));
+}
+
+// shift pattern recognized by compilers as rol
+template <typename U> constexpr U rotate_left(U v, unsigned n) noexcept {
+    return static_cast<U>(v << (n % (8 * sizeof(U))) |
+                          v >> ((8 * sizeof(U) - n % (8 * sizeof(U))) %
+                                (8 * sizeof(U))));
+}
+
+// set bits in @n bytes, in vpopcntq or pshufb nibble lookup lanes when
+// available and a popcnt per 64-bit word otherwise
+inline ::std::uint64_t count_ones_block(const ::std::uint8_t *bytes,
+                                        ::std::size_t n) noexcept {
+    ::std::size_t i = 0;
+    auto total = ::std::uint64_t{0};
+#if defined(__AVX512VPOPCNTDQ__) && defined(__AVX512F__)
+    auto acc512 = _mm512_setzero_si512();
+    for (; i + 64 <= n; i += 64) {
+        acc512 = _mm512_add_epi64(
+            acc512, _mm512_popcnt_epi64(_mm512_loadu_si512(bytes + i)));
+    }
+    total += static_cast<::std::uint64_t>(_mm512_reduce_add_epi64(acc512));
+#elif defined(__AVX2__)
+    // count per nibble with a 16 entry table, summed into 64-bit lanes
+    const auto table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2,
+                                        3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2,
+                                        2, 3, 2, 3, 3, 4);
+    const auto low = _mm256_set1_epi8(0x0f);
+    auto acc256 = _mm256_setzero_si256();
+    for (; i + 32 <= n; i += 32) {
+        const auto v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(bytes + i)); // NOLINT
+        const auto counts = _mm256_add_epi8(
+            _mm256_shuffle_epi8(table, _mm256_and_si256(v, low)),
+            _mm256_shuffle_epi8(
+                table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+        acc256 = _mm256_add_epi64(
+            acc256, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+    total += static_cast<::std::uint64_t>(_mm256_extract_epi64(acc256, 0)) +
+             static_cast<::std::uint64_t>(_mm256_extract_epi64(acc256, 1)) +
+             static_cast<::std::uint64_t>(_mm256_extract_epi64(acc256, 2)) +
+             static_cast<::std::uint64_t>(_mm256_extract_epi64(acc256, 3));
+#elif defined(__ARM_NEON)
+    auto acc = vdupq_n_u64(0);
+    for (; i + 16 <= n; i += 16) {
+        acc = vaddq_u64(acc, vpaddlq_u32(vpaddlq_u16(
+                                 vpaddlq_u8(vcntq_u8(vld1q_u8(bytes + i))))));
+    }
+    total += vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1);
+#endif
+    // scalar tail (or whole range without simd)
+    for (; i + 8 <= n; i += 8) {
+        ::std::uint64_t word;
+        ::std::memcpy(&word, bytes + i, 8);
+        total += popcount64(word);
+    }
+    for (; i < n; ++i) {
+        total += popcount64(bytes[i]);
+    }
+    return total;
+}
+
+// upper bound of characters written by Number<T>::write_to, the longest
+// being the 40 of the minimum i128
+constexpr ::std::size_t MAX_FORMAT_CHARS = 48;
+
+inline const char *digit_pairs() noexcept {
+    static constexpr char TABLE[] = "00010203040506070809"
+                                    "10111213141516171819"
+                                    "20212223242526272829"
+                                    "30313233343536373839"
+                                    "40414243444546474849"
+                                    "50515253545556575859"
+                                    "60616263646566676869"
+                                    "70717273747576777879"
+                                    "80818283848586878889"
+                                    "90919293949596979899";
+    return TABLE;
+}
+
+// two digits per division, written backwards then moved into place
+inline char *write_uint(char *out, ::std::uint64_t value) noexcept {
+    char buffer[20]; // NOLINT(modernize-avoid-c-arrays)
+    auto *p = buffer + sizeof(buffer);
+    while (value >= 100) {
+        p -= 2;
+        ::std::memcpy(p, digit_pairs() + (value % 100) * 2, 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        p -= 2;
+        ::std::memcpy(p, digit_pairs() + value * 2, 2);
+    } else {
+        *--p = static_cast<char>('0' + value);
+    }
+    const auto n = static_cast<::std::size_t>(buffer + sizeof(buffer) - p);
+    ::std::memcpy(out, p, n);
+    return out + n;
+}
+
+// exactly @width digits, zero padded
+inline char *write_uint_padded(char *out, ::std::uint64_t value,
+                               ::std::size_t width) noexcept {
+    char digits[20]; // NOLINT(modernize-avoid-c-arrays)
+    const auto n = static_cast<::std::size_t>(write_uint(digits, value) -
+                                              digits);
+    ::std::memset(out, '0', width - n);
+    ::std::memcpy(out + width - n, digits, n);
+    return out + width;
+}
+
+template <typename T>
+enable_if_t<::std::is_integral<T>::value && sizeof(T) <= 8, char *>
+write_number(char *out, T value) {
+#ifdef __cpp_lib_to_chars
+    return ::std::to_chars(out, out + MAX_FORMAT_CHARS, value).ptr;
+#else
+    auto abs = static_cast<::std::uint64_t>(value);
+    if (value < 0) {
+        *out++ = '-';
+        abs = 0 - abs;
+    }
+    return write_uint(out, abs);
+#endif
+}
+
+// 128-bit division is a slow library call, so peel 19 digits off per
+// division and format the 64-bit pieces with the digit pair table
+template <typename T>
+enable_if_t<IsInteger<T>::value && sizeof(T) == 16, char *>
+write_number(char *out, T value) {
+    using U = typename MakeUnsigned<T>::Type;
+    auto abs = static_cast<U>(value);
+    if (IsSigned<T>::value && value < T(0)) {
+        *out++ = '-';
+        abs = U(0) - abs;
+    }
+    const auto ten19 = U(10000000000000000000ULL);
+    ::std::uint64_t pieces[2]; // NOLINT(modernize-avoid-c-arrays)
+    auto n = 0;
+    while (abs >> 64U) {
+        pieces[n++] = static_cast<::std::uint64_t>(abs % ten19);
+        abs /= ten19;
+    }
+    out = write_uint(out, static_cast<::std::uint64_t>(abs));
+    while (n > 0) {
+        out = write_uint_padded(out, pieces[--n], 19);
+    }
+    return out;
+}
+
+// shortest representation which parses back to the same value
+template <typename T>
+enable_if_t<::std::is_floating_point<T>::value, char *>
+write_number(char *out, T value) {
+#ifdef __cpp_lib_to_chars
+    return ::std::to_chars(out, out + MAX_FORMAT_CHARS, value).ptr;
+#else
+    auto n = 0;
+    for (auto precision = 1;
+         precision <= ::std::numeric_limits<T>::max_digits10; ++precision) {
+        n = ::std::snprintf(out, MAX_FORMAT_CHARS, "%.*g", precision,
+                            static_cast<double>(value));
+        if (static_cast<T>(::std::strtod(out, nullptr)) == value) {
+            break;
+        }
+    }
+    // %g picks exponent form for 100 at precision 1, keep the shorter one
+    const auto *e = ::std::strchr(out, 'e');
+    const auto exp = e ? ::std::atoi(e + 1) : -1;
+    if (exp >= 0 && exp < ::std::numeric_limits<T>::max_digits10) {
+        char fixed[MAX_FORMAT_CHARS]; // NOLINT(modernize-avoid-c-arrays)
+        const auto m = ::std::snprintf(fixed, MAX_FORMAT_CHARS, "%.*g",
+                                       exp + 1, static_cast<double>(value));
+        if (m <= n) {
+            ::std::memcpy(out, fixed, static_cast<::std::size_t>(m));
+            n = m;
+        }
+    }
+    return out + n;
+#endif
+}
+
+} // namespace detail
+
+// Error kinds of Number<T>::from_str, like rust's IntErrorKind and
+// ParseFloatError
+enum class ParseError {
+    None,
+    Empty,
+    InvalidDigit,
+    PosOverflow,
+    NegOverflow,
+    Invalid,
+};
+
+inline const char *to_str(ParseError error) noexcept {
+    switch (error) {
+    case ParseError::None:
+        return "no error";
+    case ParseError::Empty:
+        return "cannot parse number from empty string";
+    case ParseError::InvalidDigit:
+        return "invalid digit found in string";
+    case ParseError::PosOverflow:
+        return "number too large to fit in target type";
+    case ParseError::NegOverflow:
+        return "number too small to fit in target type";
+    case ParseError::Invalid:
+        return "invalid number literal";
+    }
+    return "unknown error";
+}
+
+template <typename N> struct ParseResult {
+    N value{};
+    ParseError error = ParseError::None;
+
+    constexpr bool is_ok() const noexcept { return error == ParseError::None; }
+    constexpr bool is_err() const noexcept { return !is_ok(); }
+    constexpr N unwrap_or(const N &fallback) const noexcept {
+        return is_ok() ? value : fallback;
+    }
+    N unwrap() const {
+        if (is_err()) {
+            throw ::std::invalid_argument(to_str(error));
+        }
+        return value;
+    }
+};
+
+// result of a checked operation, like rust Option of an integer
+template <typename N> struct Checked {
+    N value{};
+    bool overflow = false;
+
+    constexpr Checked() = default;
+    constexpr Checked(const N &value, bool overflow = false) // NOLINT
+        : value(value), overflow(overflow) {}
+
+    constexpr bool is_some() const noexcept { return !overflow; }
+    constexpr bool is_none() const noexcept { return overflow; }
+    constexpr N unwrap_or(const N &fallback) const noexcept {
+        return overflow ? fallback : value;
+    }
+    N unwrap() const {
+        if (overflow) {
+            throw ::std::overflow_error("arithmetic overflow");
+        }
+        return value;
+    }
+};
+
+namespace detail {
+
+#if defined(__GNUC__) || defined(__clang__)
+#define RUSTY_HAS_OVERFLOW_BUILTINS
+#endif
+
+// arithmetic done in an unsigned type wide enough to skip int promotion
+template <typename I>
+using WrappingOf =
+    typename ::std::conditional<(sizeof(I) < sizeof(unsigned)), unsigned,
+                                typename MakeUnsigned<I>::Type>::type;
+
+template <typename I> constexpr bool below_zero(const I &value) noexcept {
+    return IsSigned<I>::value && value < I(0);
+}
+
+// wrapped result in @out, returns whether it overflowed; the builtins
+// compile to the plain instruction and a flag check
+#ifdef RUSTY_HAS_OVERFLOW_BUILTINS
+#define OVERFLOW_BUILTIN_IMPL(op)                                              \
+    template <typename I>                                                      \
+    enable_if_t<!::std::is_class<I>::value, bool> op##_overflow(               \
+        I a, I b, I &out) noexcept {                                           \
+        return __builtin_##op##_overflow(a, b, &out);                          \
+    }
+
+OVERFLOW_BUILTIN_IMPL(add)
+OVERFLOW_BUILTIN_IMPL(sub)
+OVERFLOW_BUILTIN_IMPL(mul)
+
+#undef OVERFLOW_BUILTIN_IMPL
+template <typename I>
+using UseOverflowFallback = enable_if_t<::std::is_class<I>::value, bool>;
+#else
+template <typename I> using UseOverflowFallback = bool;
+#endif
+
+template <typename I>
+UseOverflowFallback<I> add_overflow(I a, I b, I &out) noexcept {
+    using W = WrappingOf<I>;
+    out = static_cast<I>(static_cast<W>(a) + static_cast<W>(b));
+    return IsSigned<I>::value ? below_zero(a) == below_zero(b) &&
+                                    below_zero(out) != below_zero(a)
+                              : out < a;
+}
+template <typename I>
+UseOverflowFallback<I> sub_overflow(I a, I b, I &out) noexcept {
+    using W = WrappingOf<I>;
+    out = static_cast<I>(static_cast<W>(a) - static_cast<W>(b));
+    return IsSigned<I>::value ? below_zero(a) != below_zero(b) &&
+                                    below_zero(out) != below_zero(a)
+                              : a < b;
+}
+template <typename I>
+UseOverflowFallback<I> mul_overflow(I a, I b, I &out) noexcept {
+    using W = WrappingOf<I>;
+    out = static_cast<I>(static_cast<W>(a) * static_cast<W>(b));
+    if (a == I(0)) {
+        return false;
+    }
+    if (IsSigned<I>::value && a == I(-1)) {
+        return b == Limits<I>::min();
+    }
+    return out / a != b;
+}
+
+// division by zero or MIN / -1
+template <typename I> constexpr bool div_overflow(I a, I b) noexcept {
+    return b == I(0) ||
+           (IsSigned<I>::value && a == Limits<I>::min() && b == I(-1));
+}
+
+// the bound an overflowing operation saturates to
+template <typename I> constexpr I saturate(bool below) noexcept {
+    return below ? Limits<I>::min() : Limits<I>::max();
+}
+template <typename I> I saturating_add(I a, I b) noexcept {
+    I out;
+    return add_overflow(a, b, out) ? saturate<I>(below_zero(b)) : out;
+}
+template <typename I> I saturating_sub(I a, I b) noexcept {
+    I out;
+    return sub_overflow(a, b, out)
+               ? saturate<I>(!IsSigned<I>::value || !below_zero(b))
+               : out;
+}
+template <typename I> I saturating_mul(I a, I b) noexcept {
+    I out;
+    return mul_overflow(a, b, out)
+               ? saturate<I>(below_zero(a) != below_zero(b))
+               : out;
+}
+
+// saturating lanes of 8 and 16-bit integers, the tail in scalar code
+#if defined(__AVX2__)
+#define SATURATING_SIMD_IMPL(T, op, epx, neon)                                 \
+    inline void saturating_##op##_block(const T *a, const T *b, T *out,        \
+                                        ::std::size_t count) noexcept {        \
+        const auto lanes = count - count % (32 / sizeof(T));                   \
+        ::std::size_t i = 0;                                                   \
+        for (; i < lanes; i += 32 / sizeof(T)) {                                \
+            const auto x = _mm256_loadu_si256(                                 \
+                reinterpret_cast<const __m256i *>(a + i)); /* NOLINT */        \
+            const auto y = _mm256_loadu_si256(                                 \
+                reinterpret_cast<const __m256i *>(b + i)); /* NOLINT */        \
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),          \
+                                _mm256_##op##s_##epx(x, y)); /* NOLINT */      \
+        }                                                                      \
+        for (; i < count; ++i) {                                               \
+            out[i] = saturating_##op(a[i], b[i]);                              \
+        }                                                                      \
+    }
+#elif defined(__SSE2__)
+#define SATURATING_SIMD_IMPL(T, op, epx, neon)                                 \
+    inline void saturating_##op##_block(const T *a, const T *b, T *out,        \
+                                        ::std::size_t count) noexcept {        \
+        const auto lanes = count - count % (16 / sizeof(T));                   \
+        ::std::size_t i = 0;                                                   \
+        for (; i < lanes; i += 16 / sizeof(T)) {                                \
+            const auto x = _mm_loadu_si128(                                    \
+                reinterpret_cast<const __m128i *>(a + i)); /* NOLINT */        \
+            const auto y = _mm_loadu_si128(                                    \
+                reinterpret_cast<const __m128i *>(b + i)); /* NOLINT */        \
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),             \
+                             _mm_##op##s_##epx(x, y)); /* NOLINT */            \
+        }                                                                      \
+        for (; i < count; ++i) {                                               \
+            out[i] = saturating_##op(a[i], b[i]);                              \
+        }                                                                      \
+    }
+#elif defined(__ARM_NEON)
+#define SATURATING_SIMD_IMPL(T, op, epx, neon)                                 \
+    inline void saturating_##op##_block(const T *a, const T *b, T *out,        \
+                                        ::std::size_t count) noexcept {        \
+        const auto lanes = count - count % (16 / sizeof(T));                   \
+        ::std::size_t i = 0;                                                   \
+        for (; i < lanes; i += 16 / sizeof(T)) {                                \
+            vst1q_##neon(out + i, vq##op##q_##neon(vld1q_##neon(a + i),        \
+                                                   vld1q_##neon(b + i)));      \
+        }                                                                      \
+        for (; i < count; ++i) {                                               \
+            out[i] = saturating_##op(a[i], b[i]);                              \
+        }                                                                      \
+    }
+#endif
+
+#ifdef SATURATING_SIMD_IMPL
+SATURATING_SIMD_IMPL(::std::uint8_t, add, epu8, u8)
+SATURATING_SIMD_IMPL(::std::int8_t, add, epi8, s8)
+SATURATING_SIMD_IMPL(::std::uint16_t, add, epu16, u16)
+SATURATING_SIMD_IMPL(::std::int16_t, add, epi16, s16)
+SATURATING_SIMD_IMPL(::std::uint8_t, sub, epu8, u8)
+SATURATING_SIMD_IMPL(::std::int8_t, sub, epi8, s8)
+SATURATING_SIMD_IMPL(::std::uint16_t, sub, epu16, u16)
+SATURATING_SIMD_IMPL(::std::int16_t, sub, epi16, s16)
+
+#undef SATURATING_SIMD_IMPL
+#endif
+
+// no lanes for the other widths
+template <typename T>
+void saturating_add_block(const T *a, const T *b, T *out,
+                          ::std::size_t count) noexcept {
+    for (::std::size_t i = 0; i < count; ++i) {
+        out[i] = saturating_add(a[i], b[i]);
+    }
+}
+template <typename T>
+void saturating_sub_block(const T *a, const T *b, T *out,
+                          ::std::size_t count) noexcept {
+    for (::std::size_t i = 0; i < count; ++i) {
+        out[i] = saturating_sub(a[i], b[i]);
+    }
+}
+
+} // namespace detail
+
+namespace detail {
+
+constexpr unsigned digit_value(char c) noexcept {
+    return c >= '0' && c <= '9'   ? static_cast<unsigned>(c - '0')
+           : c >= 'a' && c <= 'z' ? static_cast<unsigned>(c - 'a' + 10)
+           : c >= 'A' && c <= 'Z' ? static_cast<unsigned>(c - 'A' + 10)
+                                  : 255U;
+}
+
+// SWAR digit parsing from
+// https://lemire.me/blog/2022/01/21/swar-explained-parsing-eight-digits/
+inline ::std::uint64_t load_eight_chars(const char *p) noexcept {
+    // assembled little-endian on every host, folded into one load
+    ::std::uint64_t v = 0;
+    for (auto i = 0; i < 8; ++i) {
+        v |= static_cast<::std::uint64_t>(static_cast<::std::uint8_t>(p[i]))
+             << (8 * i);
+    }
+    return v;
+}
+
+inline bool is_eight_digits(::std::uint64_t v) noexcept {
+    return ((v & 0xf0f0f0f0f0f0f0f0) |
+            (((v + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4)) ==
+           0x3333333333333333;
+}
+
+inline ::std::uint32_t parse_eight_digits(::std::uint64_t v) noexcept {
+    v = (v & 0x0f0f0f0f0f0f0f0f) * 2561 >> 8;
+    v = (v & 0x00ff00ff00ff00ff) * 6553601 >> 16;
+    return static_cast<::std::uint32_t>((v & 0x0000ffff0000ffff) *
+                                            42949672960001 >>
+                                        32);
+}
+
+// unsigned magnitude of [@p, @last), 8 decimal digits per step when the
+// accumulator is wide enough
+template <typename U>
+ParseError parse_magnitude(const char *p, const char *last, unsigned radix,
+                           U &out) noexcept {
+    const auto max = Limits<U>::max();
+    U acc = 0;
+    if (radix == 10 && sizeof(U) >= 8) {
+        for (; last - p >= 8; p += 8) {
+            const auto chars = load_eight_chars(p);
+            if (!is_eight_digits(chars)) {
+                break;
+            }
+            const U v = parse_eight_digits(chars);
+            if (acc > (max - v) / 100000000U) {
+                return ParseError::PosOverflow;
+            }
+            acc = acc * 100000000U + v;
+        }
+    }
+    for (; p != last; ++p) {
+        const auto d = digit_value(*p);
+        if (d >= radix) {
+            return ParseError::InvalidDigit;
+        }
+        if (acc > (max - d) / radix) {
+            return ParseError::PosOverflow;
+        }
+        acc = static_cast<U>(acc * radix + d);
+    }
+    out = acc;
+    return ParseError::None;
+}
+
+template <typename T>
+enable_if_t<IsInteger<T>::value, ParseError>
+parse_number(const char *first, const char *last, unsigned radix, T &out) {
+    using U = typename MakeUnsigned<T>::Type;
+    if (first == last) {
+        return ParseError::Empty;
+    }
+    const auto negative = *first == '-';
+    if (*first == '+' || negative) {
+        ++first;
+        if (first == last || (negative && !IsSigned<T>::value)) {
+            return ParseError::InvalidDigit;
+        }
+    }
+    U magnitude = 0;
+    const auto error = parse_magnitude(first, last, radix, magnitude);
+    if (error != ParseError::None) {
+        return negative && error == ParseError::PosOverflow
+                   ? ParseError::NegOverflow
+                   : error;
+    }
+    const auto max = static_cast<U>(Limits<T>::max());
+    if (negative) {
+        if (magnitude > static_cast<U>(max + 1U)) {
+            return ParseError::NegOverflow;
+        }
+        out = static_cast<T>(0 - magnitude);
+    } else {
+        if (magnitude > max) {
+            return ParseError::PosOverflow;
+        }
+        out = static_cast<T>(magnitude);
+    }
+    return ParseError::None;
+}
+
+inline void parse_float_slow(const char *s, char **end, float &out) {
+    out = ::std::strtof(s, end);
+}
+inline void parse_float_slow(const char *s, char **end, double &out) {
+    out = ::std::strtod(s, end);
+}
+
+template <typename T>
+enable_if_t<::std::is_floating_point<T>::value, ParseError>
+parse_number(const char *first, const char *last, unsigned radix, T &out) {
+    if (first == last) {
+        return ParseError::Empty;
+    }
+    if (radix != 10) {
+        return ParseError::Invalid;
+    }
+    const auto *p = first + (*first == '+' ? 1 : 0);
+    if (p == last || (p != first && *p == '-')) {
+        return ParseError::Invalid;
+    }
+#ifdef __cpp_lib_to_chars
+    // libstdc++ and msvc implement this with eisel-lemire
+    const auto r = ::std::from_chars(p, last, out);
+    if (r.ec == ::std::errc() && r.ptr == last) {
+        return ParseError::None;
+    }
+    if (r.ec != ::std::errc::result_out_of_range) {
+        return ParseError::Invalid;
+    }
+    // out of range goes on to yield inf or zero like rust
+#else
+    // clinger's fast path: exact when both mantissa and power of ten are
+    // exactly representable
+    const auto negative = *p == '-';
+    const auto *q = p + (negative ? 1 : 0);
+    ::std::uint64_t mantissa = 0;
+    auto digits = 0;
+    auto exponent = 0;
+    auto any = false;
+    for (; q != last && digit_value(*q) < 10; ++q, any = true) {
+        mantissa = mantissa * 10 + digit_value(*q);
+        digits += mantissa ? 1 : 0;
+    }
+    if (q != last && *q == '.') {
+        for (++q; q != last && digit_value(*q) < 10; ++q, any = true) {
+            mantissa = mantissa * 10 + digit_value(*q);
+            digits += mantissa ? 1 : 0;
+            --exponent;
+        }
+    }
+    if (q != last && (*q == 'e' || *q == 'E') && any) {
+        const auto *e = q + 1;
+        const auto exp_negative = e != last && *e == '-';
+        e += e != last && (*e == '-' || *e == '+') ? 1 : 0;
+        auto exp = 0;
+        for (; e != last && digit_value(*e) < 10; ++e) {
+            // saturated, far beyond any finite exponent
+            exp = exp < 100000 ? exp * 10 + static_cast<int>(digit_value(*e))
+                               : exp;
+        }
+        if (e != last || digit_value(e[-1]) >= 10) {
+            return ParseError::Invalid;
+        }
+        exponent += exp_negative ? -exp : exp;
+        q = last;
+    }
+    constexpr auto max_exp = sizeof(T) == 4 ? 10 : 22;
+    if (q == last && any && digits <= 19 &&
+        mantissa <= (1ULL << ::std::numeric_limits<T>::digits) &&
+        exponent >= -max_exp && exponent <= max_exp) {
+        static constexpr double POW10[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+            1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+            1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22}; // NOLINT
+        auto value = static_cast<T>(mantissa);
+        const auto scale = static_cast<T>(POW10[exponent < 0 ? -exponent
+                                                             : exponent]);
+        value = exponent < 0 ? value / scale : value * scale;
+        out = negative ? -value : value;
+        return ParseError::None;
+    }
+#endif
+    if (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r' ||
+        ::std::find(p, last, 'x') != last || ::std::find(p, last, 'X') != last) {
+        return ParseError::Invalid;
+    }
+    const auto copy = ::std::string(p, last);
+    char *end = nullptr;
+    parse_float_slow(copy.c_str(), &end, out);
+    return end == copy.c_str() + copy.size() ? ParseError::None
+                                             : ParseError::Invalid;
+}
+
+// write_to output matches num_put under @loc: no digit grouping and '.'
+// as the decimal point
+inline bool is_plain_locale(const ::std::locale &loc) {
+    if (loc == ::std::locale::classic()) {
+        return true;
+    }
+    const auto &punct = ::std::use_facet<::std::numpunct<char>>(loc);
+    return punct.grouping().empty() && punct.decimal_point() == '.';
+}
+
+// @n bytes as one formatted output: the sentry flushes tie() before and
+// honors unitbuf after, a short write sets badbit
+inline ::std::ostream &write_formatted(::std::ostream &s, const char *data,
+                                       ::std::streamsize n) {
+    const ::std::ostream::sentry sentry(s);
+    if (sentry && s.rdbuf()->sputn(data, n) != n) {
+        s.setstate(::std::ios_base::badbit);
+    }
+    return s;
+}
+
+template <typename T>
+enable_if_t<!(IsInteger<T>::value && sizeof(T) == 16), ::std::ostream &>
+stream_number(::std::ostream &s, const T &value) {
+    return s << +value;
+}
+
+// ostream has no 128-bit overloads, base, showbase, showpos and uppercase
+// are honored here, the padding by the string insertion
+template <typename T>
+enable_if_t<IsInteger<T>::value && sizeof(T) == 16, ::std::ostream &>
+stream_number(::std::ostream &s, const T &value) {
+    const auto flags = s.flags();
+    const auto base = flags & ::std::ios_base::basefield;
+    char buffer[48]; // NOLINT(modernize-avoid-c-arrays)
+    auto *const end = buffer + sizeof(buffer);
+    auto *p = end;
+    if (base == ::std::ios_base::hex || base == ::std::ios_base::oct) {
+        const auto *digits = flags & ::std::ios_base::uppercase
+                                 ? "0123456789ABCDEF"
+                                 : "0123456789abcdef";
+        const auto shift = base == ::std::ios_base::hex ? 4U : 3U;
+        auto bits = static_cast<uint128>(value);
+        do {
+            *--p = digits[static_cast<unsigned>(bits & uint128((1U << shift) -
+                                                               1))];
+            bits = bits >> shift;
+        } while (bits);
+        if (flags & ::std::ios_base::showbase && value != T(0)) {
+            if (base == ::std::ios_base::hex) {
+                *--p = flags & ::std::ios_base::uppercase ? 'X' : 'x';
+            }
+            *--p = '0';
+        }
+    } else {
+        p = buffer + 1;
+        const auto *last = write_number(p, value);
+        if (flags & ::std::ios_base::showpos && IsSigned<T>::value &&
+            !(value < T(0))) {
+            *--p = '+';
+        }
+        return s << ::std::string(p, static_cast<::std::size_t>(last - p));
+    }
+    return s << ::std::string(p, end);
+}
+
+template <typename T>
+enable_if_t<!(IsInteger<T>::value && sizeof(T) == 16), ::std::istream &>
+read_number(::std::istream &s, T &value) {
+    return s >> value;
+}
+
+template <typename T>
+enable_if_t<IsInteger<T>::value && sizeof(T) == 16, ::std::istream &>
+read_number(::std::istream &s, T &value) {
+    auto token = ::std::string{};
+    if (s >> token && parse_number(token.data(), token.data() + token.size(),
+                                   10, value) != ParseError::None) {
+        s.setstate(::std::ios_base::failbit);
+    }
+    return s;
+}
+
+template <typename T> ::std::size_t hash_value(const T &value) noexcept {
+    return ::std::hash<T>{}(value);
+}
+inline ::std::size_t hash_value(const uint128 &value) noexcept {
+    const auto lo = static_cast<::std::uint64_t>(value);
+    const auto hi = static_cast<::std::uint64_t>(value >> 64U);
+    return ::std::hash<::std::uint64_t>{}(lo ^ (hi * 0x9e3779b97f4a7c15ULL +
+                                                (lo << 6) + (lo >> 2)));
+}
+inline ::std::size_t hash_value(const int128 &value) noexcept {
+    return hash_value(static_cast<uint128>(value));
+}
+
+// integer literal of any base with digit separators, for wide integers
+template <typename U>
+constexpr U parse_literal(const char *s, unsigned base, U acc) {
+    return *s == '\0'   ? acc
+           : *s == '\'' ? parse_literal(s + 1, base, acc)
+                        : parse_literal(s + 1, base,
+                                        acc * U(base) + U(digit_value(*s)));
+}
+template <typename U> constexpr U parse_literal(const char *s) {
+    return s[0] == '0' && (s[1] == 'x' || s[1] == 'X')
+               ? parse_literal(s + 2, 16, U(0))
+           : s[0] == '0' && (s[1] == 'b' || s[1] == 'B')
+               ? parse_literal(s + 2, 2, U(0))
+           : s[0] == '0' && s[1] != '\0' ? parse_literal(s + 1, 8, U(0))
+                                         : parse_literal(s, 10, U(0));
+}
+
+// ~0 / base for the literal bases, as TwoLimb cannot divide in constant
+// expressions
+constexpr uint128 max_before_digit(unsigned base) noexcept {
+    return base == 10 ? (uint128(0x1999999999999999ULL) << 64U) |
+                            uint128(0x9999999999999999ULL)
+                      : ~uint128(0) >> (base == 16  ? 4U
+                                        : base == 8 ? 3U
+                                                    : 1U);
+}
+
+// integer literal at most @max, checked digit by digit so nothing wraps;
+// floating literals fail on their point or exponent
+constexpr bool literal_fits(const char *s, unsigned base, uint128 acc,
+                            uint128 max) noexcept {
+    return *s == '\0'   ? acc <= max
+           : *s == '\'' ? literal_fits(s + 1, base, acc, max)
+                        : digit_value(*s) < base &&
+                              acc <= max_before_digit(base) &&
+                              acc * uint128(base) <=
+                                  ~uint128(0) - uint128(digit_value(*s)) &&
+                              literal_fits(s + 1, base,
+                                           acc * uint128(base) +
+                                               uint128(digit_value(*s)),
+                                           max);
+}
+constexpr bool literal_fits(const char *s, uint128 max) noexcept {
+    return s[0] == '0' && (s[1] == 'x' || s[1] == 'X')
+               ? literal_fits(s + 2, 16, uint128(0), max)
+           : s[0] == '0' && (s[1] == 'b' || s[1] == 'B')
+               ? literal_fits(s + 2, 2, uint128(0), max)
+           : s[0] == '0' && s[1] != '\0'
+               ? literal_fits(s + 1, 8, uint128(0), max)
+               : literal_fits(s, 10, uint128(0), max);
+}
+
+// largest literal of T: its MAX, or the magnitude of MIN when signed,
+// which is only usable negated (see MinLiteral)
+template <typename T> constexpr uint128 literal_max() noexcept {
+    return IsSigned<T>::value ? uint128(Limits<T>::max()) + uint128(1)
+                              : uint128(Limits<T>::max());
+}
+
+// the characters of a literal operator template as a string
+template <char... Cs> struct LiteralChars {
+    static constexpr char value[sizeof...(Cs) + 1] = {Cs..., '\0'};
+};
+// value of an integer literal of T, a constant even at -O0
+template <typename T, char... Cs> struct Literal {
+    static constexpr T value =
+        static_cast<T>(parse_literal<uint128>(LiteralChars<Cs...>::value));
+};
+#if __cplusplus < 201703L
+template <char... Cs>
+constexpr char LiteralChars<Cs...>::value[sizeof...(Cs) + 1];
+template <typename T, char... Cs> constexpr T Literal<T, Cs...>::value;
+#endif
+
+} // namespace detail
+
+template <typename T> struct Number;
+
+namespace detail {
+
+// The magnitude of a signed MIN, e.g. 0x80000000_i32, out of range by
+// itself and MIN once negated: no conversion, only unary minus.
+template <typename T> struct MinLiteral {
+    constexpr Number<T> operator-() const noexcept {
+        return Number<T>{Limits<T>::min()};
+    }
+};
+
+template <typename T, char... Cs>
+struct IsMinLiteral
+    : ::std::integral_constant<
+          bool, IsSigned<T>::value &&
+                    parse_literal<uint128>(LiteralChars<Cs...>::value) ==
+                        literal_max<T>()> {};
+
+template <typename T, char... Cs>
+using LiteralType =
+    typename ::std::conditional<IsMinLiteral<T, Cs...>::value, MinLiteral<T>,
+                                Number<T>>::type;
+
+template <typename T, char... Cs>
+constexpr Number<T> make_literal(::std::false_type /*min*/) noexcept {
+    return Number<T>{Literal<T, Cs...>::value};
+}
+template <typename T, char... Cs>
+constexpr MinLiteral<T> make_literal(::std::true_type /*min*/) noexcept {
+    return MinLiteral<T>{};
+}
+
+template <typename N> struct ValueOf {
+    using Type = N;
+};
+template <typename T> struct ValueOf<Number<T>> {
+    using Type = T;
+};
+
+// T holds every value of U
+template <typename T, typename U>
+struct Contains
+    : ::std::integral_constant<
+          bool,
+          IsInteger<T>::value && IsInteger<U>::value
+              ? (IsSigned<T>::value == IsSigned<U>::value
+                     ? sizeof(T) >= sizeof(U)
+                     : IsSigned<T>::value && sizeof(T) > sizeof(U))
+          : ::std::is_floating_point<T>::value &&
+                  ::std::is_floating_point<U>::value
+              ? sizeof(T) >= sizeof(U)
+          : ::std::is_floating_point<T>::value && IsInteger<U>::value
+              ? 8 * sizeof(U) - IsSigned<U>::value <=
+                    static_cast<::std::size_t>(
+                        ::std::numeric_limits<T>::digits)
+              : false> {};
+
+// none out of range, nothing to check when T holds every value of U
+template <typename T, typename U>
+constexpr enable_if_t<Contains<T, U>::value, Checked<Number<T>>>
+try_convert(const U &value) noexcept {
+    return Checked<Number<T>>{Number<T>{static_cast<T>(value)}};
+}
+template <typename T, typename U>
+constexpr enable_if_t<!Contains<T, U>::value, Checked<Number<T>>>
+try_convert(const U &value) noexcept {
+    // in range when the round trip gives the value back with its sign
+    return Checked<Number<T>>{
+        Number<T>{static_cast<T>(value)},
+        static_cast<U>(static_cast<T>(value)) != value ||
+            below_zero(value) != below_zero(static_cast<T>(value))};
+}
+
+// 2 ** @n in F
+template <typename F> constexpr F power_of_two(unsigned n) noexcept {
+    return n == 0 ? F(1) : F(2) * power_of_two<F>(n - 1);
+}
+
+// rust `as`: integers wrap, floats to integers saturate with NaN as 0
+template <typename T, typename U>
+constexpr enable_if_t<
+    !(IsInteger<T>::value && ::std::is_floating_point<U>::value), T>
+as_cast(const U &value) noexcept {
+    return static_cast<T>(value);
+}
+template <typename T, typename U>
+constexpr enable_if_t<IsInteger<T>::value && ::std::is_floating_point<U>::value,
+                      T>
+as_cast(const U &value) noexcept {
+    return value != value ? T(0) // NOLINT(misc-redundant-expression)
+           : value <= static_cast<U>(Limits<T>::min()) ? Limits<T>::min()
+           : value >= power_of_two<U>(8 * sizeof(T) - IsSigned<T>::value)
+               ? Limits<T>::max()
+               : static_cast<T>(value);
+}
+
+} // namespace detail
+
 template <typename T> struct Number {
     template <::std::size_t N>
     using Bytes = ::std::array<Number<::std::uint8_t>, N>;
@@ -77,19 +1576,22 @@ template <typename T> struct Number {
         return reversed_bytes;
     }
 
+    // floating values are swapped through the unsigned integer of same width
     constexpr Self reverse_bytes() const & {
-        return from_ne_bytes(reverse_bytes(to_ne_bytes()));
+        return bit_cast<Self>(detail::byteswap(
+            bit_cast<typename detail::UintOf<sizeof(T)>::Type>(value)));
     }
 
 #define BYTE_CONVERT_IMPL(e)                                                   \
     static constexpr Self from_##e##_bytes(const Bytes<sizeof(T)> &bytes) {    \
-        return from_ne_bytes(is_##e ? bytes : reverse_bytes(bytes));           \
+        return is_##e ? from_ne_bytes(bytes)                                   \
+                      : from_ne_bytes(bytes).reverse_bytes();                  \
     }                                                                          \
     static constexpr Self from_##e(const Self &source) {                       \
         return is_##e ? source : source.reverse_bytes();                       \
     }                                                                          \
     constexpr Bytes<sizeof(T)> to_##e##_bytes() const & {                      \
-        return is_##e ? to_ne_bytes() : reverse_bytes(to_ne_bytes());          \
+        return is_##e ? to_ne_bytes() : reverse_bytes().to_ne_bytes();         \
     }                                                                          \
     constexpr Self to_##e() const & {                                          \
         return is_##e ? Self{value} : reverse_bytes();                         \
@@ -100,19 +1602,224 @@ template <typename T> struct Number {
 
 #undef BYTE_CONVERT_IMPL
 
-#define INC_DEC_IMPL(op, pos, pre, post)                                       \
-    inline Self operator op(pos) & { return Self{pre value post}; }
+    // bulk conversion of @count elements, native endian is a plain memcpy
+    static void swap_bytes_inplace(Self *data, ::std::size_t count) noexcept {
+        auto *bytes = reinterpret_cast<::std::uint8_t *>(data); // NOLINT
+        detail::swap_bytes_block<sizeof(T)>(bytes, bytes, count);
+    }
+
+    // works with any contiguous container, e.g. Vec<Self> and Array<Self, N>
+    template <typename C> static void swap_bytes_inplace(C &container) noexcept {
+        swap_bytes_inplace(container.data(), container.size());
+    }
+
+#define SLICE_CONVERT_IMPL(e)                                                  \
+    static void from_##e##_slice(const ::std::uint8_t *bytes,                  \
+                                 ::std::size_t count, Self *out) noexcept {    \
+        auto *dst = reinterpret_cast<::std::uint8_t *>(out); /* NOLINT */      \
+        if (is_##e) {                                                          \
+            ::std::memmove(dst, bytes, count * sizeof(T));                     \
+        } else {                                                               \
+            detail::swap_bytes_block<sizeof(T)>(bytes, dst, count);            \
+        }                                                                      \
+    }                                                                          \
+    static void to_##e##_slice(const Self *in, ::std::size_t count,            \
+                               ::std::uint8_t *bytes) noexcept {               \
+        const auto *src =                                                      \
+            reinterpret_cast<const ::std::uint8_t *>(in); /* NOLINT */         \
+        if (is_##e) {                                                          \
+            ::std::memmove(bytes, src, count * sizeof(T));                     \
+        } else {                                                               \
+            detail::swap_bytes_block<sizeof(T)>(src, bytes, count);            \
+        }                                                                      \
+    }
+
+    SLICE_CONVERT_IMPL(le)
+    SLICE_CONVERT_IMPL(be)
+
+#undef SLICE_CONVERT_IMPL
+
+    // rust integer arithmetic: overflowing_X returns the wrapped result and
+    // whether it overflowed, checked_X reports overflow, wrapping_X wraps
+    // and saturating_X clamps to the bounds of T
+#define OVERFLOW_IMPL(op)                                                      \
+    ::std::pair<Self, bool> overflowing_##op(const Self &rhs) const & {        \
+        T out;                                                                 \
+        const auto overflow = detail::op##_overflow(value, rhs.value, out);    \
+        return {Self{out}, overflow};                                          \
+    }                                                                          \
+    Checked<Self> checked_##op(const Self &rhs) const & {                      \
+        T out;                                                                 \
+        const auto overflow = detail::op##_overflow(value, rhs.value, out);    \
+        return {Self{out}, overflow};                                          \
+    }                                                                          \
+    Self wrapping_##op(const Self &rhs) const & {                              \
+        T out;                                                                 \
+        detail::op##_overflow(value, rhs.value, out);                          \
+        return out;                                                            \
+    }                                                                          \
+    Self saturating_##op(const Self &rhs) const & {                            \
+        return detail::saturating_##op(value, rhs.value);                      \
+    }
+
+    OVERFLOW_IMPL(add)
+    OVERFLOW_IMPL(sub)
+    OVERFLOW_IMPL(mul)
+
+#undef OVERFLOW_IMPL
+
+    // none on division by zero and on MIN / -1
+    Checked<Self> checked_div(const Self &rhs) const & {
+        return detail::div_overflow(value, rhs.value)
+                   ? Checked<Self>{Self{}, true}
+                   : Checked<Self>{Self{value / rhs.value}};
+    }
+    Checked<Self> checked_rem(const Self &rhs) const & {
+        return detail::div_overflow(value, rhs.value)
+                   ? Checked<Self>{Self{}, true}
+                   : Checked<Self>{Self{value % rhs.value}};
+    }
+    Checked<Self> checked_neg() const & { return Self{0}.checked_sub(*this); }
+    Self wrapping_neg() const & { return Self{0}.wrapping_sub(*this); }
+
+    // element wise over @count elements, in simd lanes for 8 and 16-bit
+    // integers; @out may alias either input
+#define SATURATING_SLICE_IMPL(op)                                              \
+    static void saturating_##op##_slice(const Self *a, const Self *b,          \
+                                        Self *out,                             \
+                                        ::std::size_t count) noexcept {        \
+        detail::saturating_##op##_block(                                       \
+            reinterpret_cast<const T *>(a), /* NOLINT */                       \
+            reinterpret_cast<const T *>(b), /* NOLINT */                       \
+            reinterpret_cast<T *>(out), count); /* NOLINT */                   \
+    }
+
+    SATURATING_SLICE_IMPL(add)
+    SATURATING_SLICE_IMPL(sub)
+
+#undef SATURATING_SLICE_IMPL
+
+    static void wrapping_add_slice(const Self *a, const Self *b, Self *out,
+                                   ::std::size_t count) noexcept {
+        for (::std::size_t i = 0; i < count; ++i) {
+            out[i] = a[i].wrapping_add(b[i]);
+        }
+    }
+    static void wrapping_sub_slice(const Self *a, const Self *b, Self *out,
+                                   ::std::size_t count) noexcept {
+        for (::std::size_t i = 0; i < count; ++i) {
+            out[i] = a[i].wrapping_sub(b[i]);
+        }
+    }
+
+    // rust conversions: from is lossless and compiles only when T holds
+    // every value of U, try_from is none out of range and checks nothing
+    // when T holds every value, as wraps integers and saturates floats to
+    // integers
+    template <typename U>
+    static constexpr Self from(const Number<U> &other) noexcept {
+        static_assert(detail::Contains<T, U>::value,
+                      "lossy conversion, use try_from or as!");
+        return Self{static_cast<T>(other.value)};
+    }
+    template <typename U>
+    static constexpr Checked<Self> try_from(const Number<U> &other) noexcept {
+        static_assert(detail::IsInteger<T>::value &&
+                          detail::IsInteger<U>::value,
+                      "integers only, use as!");
+        return detail::try_convert<T>(other.value);
+    }
+    template <typename U,
+              enable_if_t<detail::IsInteger<U>::value, int> = 0>
+    static constexpr Checked<Self> try_from(const U &other) noexcept {
+        return try_from(Number<U>{other});
+    }
+    // to a Number or to a raw numeric type, e.g. as<u8>() or as<float>()
+    template <typename N>
+    constexpr Number<typename detail::ValueOf<N>::Type> as() const & noexcept {
+        return Number<typename detail::ValueOf<N>::Type>{
+            detail::as_cast<typename detail::ValueOf<N>::Type>(value)};
+    }
+
+    // rust integer bit operations on the two's complement bits of T, each
+    // a single instruction where the target has one
+    static constexpr unsigned BITS = 8 * sizeof(T); // NOLINT
+
+    constexpr unsigned count_ones() const & noexcept {
+        return detail::count_ones(detail::as_unsigned(value));
+    }
+    constexpr unsigned count_zeros() const & noexcept {
+        return BITS - count_ones();
+    }
+    constexpr unsigned leading_zeros() const & noexcept {
+        return detail::leading_zeros(detail::as_unsigned(value));
+    }
+    constexpr unsigned trailing_zeros() const & noexcept {
+        return detail::trailing_zeros(detail::as_unsigned(value));
+    }
+    constexpr unsigned leading_ones() const & noexcept {
+        return detail::leading_zeros(detail::as_unsigned(T(~value)));
+    }
+    constexpr unsigned trailing_ones() const & noexcept {
+        return detail::trailing_zeros(detail::as_unsigned(T(~value)));
+    }
+    constexpr Self rotate_left(unsigned n) const & noexcept {
+        return static_cast<T>(detail::rotate_left(detail::as_unsigned(value), n));
+    }
+    constexpr Self rotate_right(unsigned n) const & noexcept {
+        return rotate_left(BITS - n % BITS);
+    }
+
+    // unsigned only, like rust
+    constexpr bool is_power_of_two() const & noexcept {
+        static_assert(!detail::IsSigned<T>::value, "unsigned integers only!");
+        return count_ones() == 1;
+    }
+    // none when the next power of two does not fit T
+    constexpr Checked<Self> checked_next_power_of_two() const & noexcept {
+        static_assert(!detail::IsSigned<T>::value, "unsigned integers only!");
+        return value <= T(1) ? Checked<Self>{Self{T(1)}}
+               : Self{T(value - T(1))}.leading_zeros() == 0
+                   ? Checked<Self>{Self{}, true}
+                   : Checked<Self>{Self{T(
+                         T(1) << (BITS - Self{T(value - T(1))}
+                                             .leading_zeros()))}};
+    }
+    // 0 when the next power of two does not fit T, like rust release builds
+    constexpr Self next_power_of_two() const & noexcept {
+        return checked_next_power_of_two().unwrap_or(Self{T(0)});
+    }
+
+    // set bits of @count elements, in simd lanes where available
+    static ::std::uint64_t count_ones_slice(const Self *data,
+                                            ::std::size_t count) noexcept {
+        return detail::count_ones_block(
+            reinterpret_cast<const ::std::uint8_t *>(data), // NOLINT
+            count * sizeof(T));
+    }
+
+    // like builtin integers, prefix and compound assignment return the
+    // operand itself and postfix returns the previous value
+#define INC_DEC_IMPL(op)                                                       \
+    RUSTY_CONSTEXPR14 Self &operator op() & noexcept {                         \
+        op value;                                                              \
+        return *this;                                                          \
+    }                                                                          \
+    RUSTY_CONSTEXPR14 Self operator op(int) & noexcept { /* NOLINT */          \
+        const auto old = *this;                                                \
+        op value;                                                              \
+        return old;                                                            \
+    }
 
-    INC_DEC_IMPL(++, , ++, )
-    INC_DEC_IMPL(--, , --, )
-    INC_DEC_IMPL(++, int, , ++) // NOLINT(cert-dcl21-cpp)
-    INC_DEC_IMPL(--, int, , ++) // NOLINT(cert-dcl21-cpp)
+    INC_DEC_IMPL(++)
+    INC_DEC_IMPL(--)
 
 #undef INC_DEC_IMPL
 
 #define BINARY_ASSIGN_IMPL(op)                                                 \
-    inline Self operator op##=(const Self &oprand) & {                         \
-        return Self{value op## = oprand.value};                                \
+    RUSTY_CONSTEXPR14 Self &operator op##=(const Self &oprand) & noexcept {    \
+        value op## = oprand.value;                                             \
+        return *this;                                                          \
     }
 
     BINARY_ASSIGN_IMPL(+)
@@ -128,22 +1835,233 @@ template <typename T> struct Number {
 
 #undef BINARY_ASSIGN_IMPL
 
+    // locale independent decimal formatting, shortest round trip for
+    // floating values, writes at most MAX_FORMAT_CHARS without terminator
+    char *write_to(char *out) const & noexcept {
+        return detail::write_number(out, value);
+    }
+
+    ::std::string to_string() const & {
+        char buffer[detail::MAX_FORMAT_CHARS]; // NOLINT
+        return {buffer, write_to(buffer)};
+    }
+
+    // `s << number.display()` always goes through write_to, whatever the
+    // stream flags are
+    struct Display {
+        const Self &number;
+
+        friend ::std::ostream &operator<<(::std::ostream &s,
+                                          const Display &d) {
+            char buffer[detail::MAX_FORMAT_CHARS]; // NOLINT
+            return detail::write_formatted(s, buffer,
+                                           d.number.write_to(buffer) - buffer);
+        }
+    };
+
+    Display display() const & noexcept { return Display{*this}; }
+
+    // integers skip num_put when the stream is plain decimal and its locale
+    // groups no digits
     friend ::std::ostream &operator<<(::std::ostream &s, const Self &number) {
-        return s << +number.value;
+        const auto flags = s.flags();
+        const auto base = flags & ::std::ios_base::basefield;
+        if (detail::IsInteger<T>::value && s.width() == 0 &&
+            (base == ::std::ios_base::dec || base == 0) &&
+            !(flags & ::std::ios_base::showpos) &&
+            detail::is_plain_locale(s.getloc())) {
+            return s << number.display();
+        }
+        return detail::stream_number(s, number.value);
+    }
+
+    // rust style parsing, no whitespace allowed, a leading '+' accepted
+    static ParseResult<Self> from_str_radix(const char *first,
+                                            const char *last,
+                                            unsigned radix) {
+        auto result = ParseResult<Self>{};
+        result.error =
+            detail::parse_number(first, last, radix, result.value.value);
+        return result;
+    }
+    static ParseResult<Self> from_str(const char *first, const char *last) {
+        return from_str_radix(first, last, 10);
+    }
+    // @S could be ::std::string, ::std::string_view, or anything with
+    // data() and size()
+    template <typename S>
+    static ParseResult<Self> from_str_radix(const S &s, unsigned radix) {
+        return from_str_radix(s.data(), s.data() + s.size(), radix);
+    }
+    template <typename S> static ParseResult<Self> from_str(const S &s) {
+        return from_str(s.data(), s.data() + s.size());
+    }
+
+    // parse every @delimiter separated field into @out (e.g. a Vec<Self>),
+    // stops at the first failing field whose index is then out.size()
+    template <typename C>
+    static ParseError parse_delimited(const char *first, const char *last,
+                                      char delimiter, C &out) {
+        while (first != last) {
+            const auto *end = static_cast<const char *>(
+                ::std::memchr(first, delimiter, last - first));
+            end = end ? end : last;
+            const auto result = from_str(first, end);
+            if (result.is_err()) {
+                return result.error;
+            }
+            out.push_back(result.value);
+            first = end == last ? last : end + 1;
+        }
+        return ParseError::None;
     }
 
     friend ::std::istream &operator>>(::std::istream &s, Self &number) {
-        return s >> number.value;
+        return detail::read_number(s, number.value);
+    }
+};
+
+// Zero-copy view of @count encoded @N (a Number<T>) laid out in @BigEndian
+// order, elements are decoded on access with unaligned-safe loads
+template <typename N, bool BigEndian> class EndianSlice {
+  public:
+    // dereferencing decodes a value rather than referring to storage, so
+    // it is only an input iterator to the C++17 requirements, while C++20
+    // algorithms see the random access it really provides
+    class Iterator {
+      public:
+        using iterator_category = ::std::input_iterator_tag;
+#if __cplusplus >= 202002L
+        using iterator_concept = ::std::random_access_iterator_tag;
+#endif
+        using value_type = N;
+        using difference_type = ::std::ptrdiff_t;
+        using pointer = void;
+        using reference = N; // by value, no storage to refer to
+
+        constexpr Iterator() = default;
+        constexpr explicit Iterator(const ::std::uint8_t *ptr) : ptr(ptr) {}
+
+        N operator*() const { return decode(ptr); }
+        N operator[](difference_type n) const {
+            return decode(ptr + n * static_cast<difference_type>(sizeof(N)));
+        }
+
+        Iterator &operator++() { return *this += 1; }
+        Iterator &operator--() { return *this -= 1; }
+        Iterator operator++(int) { // NOLINT(cert-dcl21-cpp)
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+        Iterator operator--(int) { // NOLINT(cert-dcl21-cpp)
+            auto it = *this;
+            --*this;
+            return it;
+        }
+        Iterator &operator+=(difference_type n) {
+            ptr += n * static_cast<difference_type>(sizeof(N));
+            return *this;
+        }
+        Iterator &operator-=(difference_type n) { return *this += -n; }
+        friend Iterator operator+(Iterator it, difference_type n) {
+            return it += n;
+        }
+        friend Iterator operator+(difference_type n, Iterator it) {
+            return it += n;
+        }
+        friend Iterator operator-(Iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(const Iterator &a,
+                                         const Iterator &b) {
+            return (a.ptr - b.ptr) / static_cast<difference_type>(sizeof(N));
+        }
+
+#define COMPARE_IMPL(op)                                                       \
+    friend bool operator op(const Iterator &a, const Iterator &b) {            \
+        return a.ptr op b.ptr;                                                 \
+    }
+
+        COMPARE_IMPL(==)
+        COMPARE_IMPL(!=)
+        COMPARE_IMPL(<)
+        COMPARE_IMPL(<=)
+        COMPARE_IMPL(>)
+        COMPARE_IMPL(>=)
+
+#undef COMPARE_IMPL
+
+      private:
+        const ::std::uint8_t *ptr = nullptr;
+    };
+
+    using value_type = N;
+    using size_type = ::std::size_t;
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+
+    constexpr EndianSlice() = default;
+    constexpr EndianSlice(const ::std::uint8_t *bytes, ::std::size_t count)
+        : bytes(bytes), count(count) {}
+
+    constexpr ::std::size_t size() const { return count; }
+    constexpr bool empty() const { return count == 0; }
+    constexpr const ::std::uint8_t *data() const { return bytes; }
+
+    N operator[](::std::size_t i) const {
+        return decode(bytes + i * sizeof(N));
     }
+    N front() const { return (*this)[0]; }
+    N back() const { return (*this)[count - 1]; }
+
+    Iterator begin() const { return Iterator{bytes}; }
+    Iterator end() const { return Iterator{bytes + count * sizeof(N)}; }
+
+    // sub view of @len elements starting from @start
+    EndianSlice subslice(::std::size_t start, ::std::size_t len) const {
+        return EndianSlice{bytes + start * sizeof(N), len};
+    }
+
+  private:
+    static N decode(const ::std::uint8_t *ptr) {
+        N number;
+        ::std::memcpy(&number, ptr, sizeof(N));
+        return BigEndian ? N::from_be(number) : N::from_le(number);
+    }
+
+    const ::std::uint8_t *bytes = nullptr;
+    ::std::size_t count = 0;
 };
 
-// TODO(i128/u128)
+template <typename N> using LeSlice = EndianSlice<N, false>;
+template <typename N> using BeSlice = EndianSlice<N, true>;
+
+// wrappers must stay trivially copyable and laid out exactly like the
+// wrapped type, so that Vec<u32> memcpys and vectorizes like a raw array
+#define LAYOUT_CHECK(ALIAS, ORIGIN)                                            \
+    static_assert(is_trivial_v<ALIAS> &&                                       \
+                      ::std::is_trivially_copyable<ALIAS>::value &&            \
+                      ::std::is_standard_layout<ALIAS>::value,                 \
+                  #ALIAS " not trivial!");                                     \
+    static_assert(sizeof(ALIAS) == sizeof(ORIGIN) &&                           \
+                      alignof(ALIAS) == alignof(ORIGIN),                       \
+                  #ALIAS " not layout compatible with " #ORIGIN "!");
 
+// integer literals of any base and width, out of range ones rejected at
+// compile time instead of wrapping
 #define GENERAL_INT_IMPL(ALIAS, ORIGIN)                                        \
     using ALIAS = Number<ORIGIN>;                                              \
+    LAYOUT_CHECK(ALIAS, ORIGIN)                                                \
     namespace literal {                                                        \
-    inline constexpr ALIAS operator""_##ALIAS(unsigned long long int val) {    \
-        return static_cast<ALIAS>(val);                                        \
+    template <char... Cs>                                                      \
+    constexpr detail::LiteralType<ORIGIN, Cs...> operator""_##ALIAS() {        \
+        static_assert(                                                         \
+            detail::literal_fits(detail::LiteralChars<Cs...>::value,           \
+                                 detail::literal_max<ORIGIN>()),               \
+            "_" #ALIAS " literal out of range or not an integer!");            \
+        return detail::make_literal<ORIGIN, Cs...>(                            \
+            detail::IsMinLiteral<ORIGIN, Cs...>{});                            \
     }                                                                          \
     } // namespace literal
 
@@ -153,6 +2071,7 @@ template <typename T> struct Number {
 
 #define FLOATING_IMPL(BITS, ORIGIN)                                            \
     using f##BITS = Number<ORIGIN>;                                            \
+    LAYOUT_CHECK(f##BITS, ORIGIN)                                              \
     static_assert(::std::numeric_limits<ORIGIN>::is_iec559 &&                  \
                       sizeof(ORIGIN) == (BITS) / 8,                            \
                   "f" #BITS " illegal!");                                      \
@@ -167,6 +2086,9 @@ FIXED_INT_IMPL(16)
 FIXED_INT_IMPL(32)
 FIXED_INT_IMPL(64)
 
+GENERAL_INT_IMPL(i128, int128)
+GENERAL_INT_IMPL(u128, uint128)
+
 GENERAL_INT_IMPL(isize, intptr_t)
 GENERAL_INT_IMPL(usize, uintptr_t)
 
@@ -176,13 +2098,14 @@ FLOATING_IMPL(64, double)
 #undef FIXED_INT_IMPL
 #undef FLOATING_IMPL
 #undef GENERAL_INT_IMPL
+#undef LAYOUT_CHECK
 
 } // namespace rusty::numeric_types
 
 template <typename T> struct std::hash<::rusty::numeric_types::Number<T>> {
     ::std::size_t constexpr operator()(
         const ::rusty::numeric_types::Number<T> &number) const &noexcept {
-        return ::std::hash<T>{}(number.value);
+        return ::rusty::numeric_types::detail::hash_value(number.value);
     }
 };
 
@@ -0,0 +1,497 @@
+// SPDX-License-Identifier: MIT
+// Copyright(c) 2021 ur4t
+
+#ifndef __RUSTY_PARALLEL_HPP__
+#define __RUSTY_PARALLEL_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// define RUSTY_PARALLEL_STD_EXECUTION to run sorts, for_each and reductions
+// through the std::execution::par algorithms where the standard library
+// provides them (MSVC, libstdc++ with TBB, linked with -ltbb), the pool runs
+// them otherwise; an exception escaping an element then terminates
+#if defined(RUSTY_PARALLEL_STD_EXECUTION) && __cplusplus >= 201703L
+#if defined(__has_include)
+#if __has_include(<execution>)
+#include <execution>
+#endif
+#endif
+#endif
+#if defined(RUSTY_PARALLEL_STD_EXECUTION) &&                                  \
+    defined(__cpp_lib_parallel_algorithm)
+#define RUSTY_PARALLEL_HAS_STD_EXECUTION
+#endif
+
+namespace rusty::parallel {
+
+// Work stealing pool: each thread owns a deque, runs its newest task first
+// and steals the oldest task of another deque when it runs dry. A thread
+// waiting for its tasks runs queued tasks meanwhile, so parallel calls
+// nest without deadlock.
+class ThreadPool {
+  public:
+    // RUSTY_NUM_THREADS when set, like RAYON_NUM_THREADS, otherwise the
+    // hardware concurrency
+    static ::std::size_t default_threads() {
+        if (const char *env = ::std::getenv("RUSTY_NUM_THREADS")) {
+            const auto n = ::std::strtoul(env, nullptr, 10);
+            if (n > 0) {
+                return n;
+            }
+        }
+        const auto n = ::std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+    // shared by every parallel call not given a pool
+    static ThreadPool &global() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // @threads counts the calling thread, which works while it waits, so
+    // ThreadPool(1) runs everything inline
+    explicit ThreadPool(::std::size_t threads = default_threads()) {
+        threads = threads > 0 ? threads : 1;
+        for (::std::size_t i = 0; i < threads; ++i) {
+            queues.emplace_back(new Queue);
+        }
+        for (::std::size_t i = 1; i < threads; ++i) {
+            workers.emplace_back([this, i] { work(i); });
+        }
+    }
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ~ThreadPool() {
+        {
+            const ::std::lock_guard<::std::mutex> lock(sleep_mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    ::std::size_t threads() const noexcept { return queues.size(); }
+
+    // calls @body(chunk, begin, end) for the @chunks contiguous ranges of
+    // [0, @n), returns when all are done and rethrows the first exception
+    template <typename F>
+    void for_each_chunk(::std::size_t n, ::std::size_t chunks,
+                        const F &body) {
+        chunks = ::std::max<::std::size_t>(::std::min(chunks, n), 1);
+        if (chunks == 1 || threads() == 1) {
+            for (::std::size_t i = 0; i < chunks; ++i) {
+                body(i, n * i / chunks, n * (i + 1) / chunks);
+            }
+            return;
+        }
+        Job job;
+        job.remaining.store(chunks, ::std::memory_order_relaxed);
+        const auto self = self_index();
+        // newest first on our own deque, so the first chunks go last
+        for (auto i = chunks - 1; i > 0; --i) {
+            auto task = [&job, &body, n, chunks, i] {
+                job.run([&] { body(i, n * i / chunks, n * (i + 1) / chunks); });
+            };
+            const auto target = self != 0 ? self : i % threads();
+            {
+                const ::std::lock_guard<::std::mutex> lock(
+                    queues[target]->mutex);
+                queues[target]->tasks.emplace_back(::std::move(task));
+            }
+        }
+        pending.fetch_add(chunks - 1, ::std::memory_order_release);
+        {
+            // waiters check pending under the lock, no wakeup is lost
+            const ::std::lock_guard<::std::mutex> lock(sleep_mutex);
+        }
+        wake.notify_all();
+        job.run([&] { body(0, 0, n / chunks); });
+        while (job.remaining.load(::std::memory_order_acquire) > 0) {
+            if (!run_one(self)) {
+                ::std::this_thread::yield();
+            }
+        }
+        if (job.error) {
+            ::std::rethrow_exception(job.error);
+        }
+    }
+
+  private:
+    struct Queue {
+        ::std::mutex mutex;
+        ::std::deque<::std::function<void()>> tasks;
+    };
+
+    struct Job {
+        ::std::atomic<::std::size_t> remaining{0};
+        ::std::atomic<bool> failed{false};
+        ::std::exception_ptr error;
+
+        // the job must not be touched once remaining drops
+        template <typename F> void run(const F &f) {
+            if (!failed.load(::std::memory_order_relaxed)) {
+                try {
+                    f();
+                } catch (...) {
+                    if (!failed.exchange(true)) {
+                        error = ::std::current_exception();
+                    }
+                }
+            }
+            remaining.fetch_sub(1, ::std::memory_order_acq_rel);
+        }
+    };
+
+    // deque of the current thread in this pool, 0 for outside threads
+    ::std::size_t self_index() const noexcept {
+        return current_pool() == this ? current_index() : 0;
+    }
+    static const ThreadPool *&current_pool() noexcept {
+        thread_local const ThreadPool *pool = nullptr;
+        return pool;
+    }
+    static ::std::size_t &current_index() noexcept {
+        thread_local ::std::size_t index = 0;
+        return index;
+    }
+
+    // newest task of our deque, else the oldest of another one
+    bool run_one(::std::size_t self) {
+        ::std::function<void()> task;
+        for (::std::size_t k = 0; k < queues.size() && !task; ++k) {
+            auto &queue = *queues[(self + k) % queues.size()];
+            const ::std::lock_guard<::std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                if (k == 0) {
+                    task = ::std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                } else {
+                    task = ::std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+            }
+        }
+        if (!task) {
+            return false;
+        }
+        pending.fetch_sub(1, ::std::memory_order_relaxed);
+        task();
+        return true;
+    }
+
+    void work(::std::size_t self) {
+        current_pool() = this;
+        current_index() = self;
+        for (;;) {
+            if (run_one(self)) {
+                continue;
+            }
+            auto lock = ::std::unique_lock<::std::mutex>(sleep_mutex);
+            wake.wait(lock, [this] {
+                return stop || pending.load(::std::memory_order_acquire) > 0;
+            });
+            if (stop) {
+                return;
+            }
+        }
+    }
+
+    ::std::vector<::std::unique_ptr<Queue>> queues;
+    ::std::atomic<::std::size_t> pending{0};
+    ::std::mutex sleep_mutex;
+    ::std::condition_variable wake;
+    bool stop = false;
+    ::std::vector<::std::thread> workers; // last, started once all is ready
+};
+
+namespace detail {
+
+// smallest chunk worth a task, in elements
+constexpr ::std::size_t DEFAULT_MIN_LEN = 1024;
+
+// a few chunks per thread, so stealing evens out uneven chunks, and a
+// single pass when there is no other thread
+inline ::std::size_t chunks_for(const ThreadPool &pool, ::std::size_t n,
+                                ::std::size_t min_len) {
+    if (pool.threads() == 1) {
+        return 1;
+    }
+    return ::std::min((n + min_len - 1) / min_len, pool.threads() * 4);
+}
+
+// element type of a contiguous container, const for a const one
+template <typename C>
+using ElementOf = typename ::std::remove_pointer<decltype(
+    ::std::declval<C &>().data())>::type;
+
+struct Identity {
+    template <typename T> T &&operator()(T &&value) const noexcept {
+        return static_cast<T &&>(value);
+    }
+};
+
+template <typename F, typename G> struct Composed {
+    F f;
+    G g;
+
+    template <typename T>
+    auto operator()(T &&value) const
+        -> decltype(g(f(static_cast<T &&>(value)))) {
+        return g(f(static_cast<T &&>(value)));
+    }
+};
+
+struct Plus {
+    template <typename T> T operator()(const T &a, const T &b) const {
+        return static_cast<T>(a + b);
+    }
+};
+
+} // namespace detail
+
+// Parallel view of @len elements from @first, transformed lazily by map
+// and consumed in chunks by for_each, reduce, sum and collect, like rayon
+// par_iter; @F maps each element reference to the item
+template <typename T, typename F = detail::Identity> class ParIter {
+  public:
+    using Item = typename ::std::decay<decltype(::std::declval<const F &>()(
+        ::std::declval<T &>()))>::type;
+
+    ParIter(T *first, ::std::size_t len, F f = F{},
+            ThreadPool *pool = &ThreadPool::global(),
+            ::std::size_t min_len = detail::DEFAULT_MIN_LEN)
+        : first(first), len(len), f(::std::move(f)), pool(pool),
+          min_len(min_len > 0 ? min_len : 1) {}
+
+    template <typename G>
+    ParIter<T, detail::Composed<F, G>> map(G g) const {
+        return {first, len, detail::Composed<F, G>{f, ::std::move(g)}, pool,
+                min_len};
+    }
+
+    // run on @other instead of the global pool
+    ParIter with_pool(ThreadPool &other) const {
+        return {first, len, f, &other, min_len};
+    }
+    // no chunk smaller than @n elements, raise it for cheap items
+    ParIter with_min_len(::std::size_t n) const {
+        return {first, len, f, pool, n};
+    }
+
+    ::std::size_t size() const noexcept { return len; }
+
+    template <typename G> void for_each(const G &g) const {
+#ifdef RUSTY_PARALLEL_HAS_STD_EXECUTION
+        ::std::for_each(::std::execution::par, first, first + len,
+                        [&](T &value) { g(f(value)); });
+#else
+        pool->for_each_chunk(len, chunks(),
+                             [&](::std::size_t, ::std::size_t begin,
+                                 ::std::size_t end) {
+                                 for (auto i = begin; i < end; ++i) {
+                                     g(f(first[i]));
+                                 }
+                             });
+#endif
+    }
+
+    // @op must be associative, and commutative too with std::execution
+    template <typename Op> Item reduce(const Item &identity, Op op) const {
+#ifdef RUSTY_PARALLEL_HAS_STD_EXECUTION
+        return ::std::transform_reduce(
+            ::std::execution::par, first, first + len, identity,
+            [&](const Item &a, const Item &b) { return op(a, b); },
+            [&](T &value) { return static_cast<Item>(f(value)); });
+#else
+        auto partials = ::std::vector<Item>(chunks(), identity);
+        pool->for_each_chunk(len, partials.size(),
+                             [&](::std::size_t chunk, ::std::size_t begin,
+                                 ::std::size_t end) {
+                                 auto acc = identity;
+                                 for (auto i = begin; i < end; ++i) {
+                                     acc = op(acc, f(first[i]));
+                                 }
+                                 partials[chunk] = acc;
+                             });
+        auto acc = identity;
+        for (const auto &partial : partials) {
+            acc = op(acc, partial);
+        }
+        return acc;
+#endif
+    }
+
+    Item sum() const { return reduce(Item{}, detail::Plus{}); }
+
+    // items in order, into any container with a size constructor
+    template <typename C = ::std::vector<Item>> C collect() const {
+        auto out = C(len);
+        pool->for_each_chunk(len, chunks(),
+                             [&](::std::size_t, ::std::size_t begin,
+                                 ::std::size_t end) {
+                                 for (auto i = begin; i < end; ++i) {
+                                     out[i] = f(first[i]);
+                                 }
+                             });
+        return out;
+    }
+
+  private:
+    ::std::size_t chunks() const {
+        return detail::chunks_for(*pool, len, min_len);
+    }
+
+    T *first;
+    ::std::size_t len;
+    F f;
+    ThreadPool *pool;
+    ::std::size_t min_len;
+};
+
+// works with any contiguous container, e.g. Vec<u32> and Array<f64, N>
+template <typename C>
+ParIter<detail::ElementOf<C>> par_iter(C &container) {
+    return {container.data(), container.size()};
+}
+template <typename C>
+ParIter<detail::ElementOf<C>> par_iter(C &container, ThreadPool &pool) {
+    return {container.data(), container.size(), {}, &pool};
+}
+
+// chunks sorted in parallel, then merged pairwise a level at a time
+template <typename C, typename Compare>
+void par_sort_unstable_by(C &container, Compare compare,
+                          ThreadPool &pool = ThreadPool::global()) {
+    auto *first = container.data();
+    const auto n = static_cast<::std::size_t>(container.size());
+#ifdef RUSTY_PARALLEL_HAS_STD_EXECUTION
+    (void)pool;
+    ::std::sort(::std::execution::par, first, first + n, compare);
+#else
+    auto chunks = ::std::size_t{1};
+    while (chunks < pool.threads() && n / (chunks * 2) >= (1U << 14)) {
+        chunks *= 2;
+    }
+    const auto bound = [n, chunks](::std::size_t i) { return n * i / chunks; };
+    pool.for_each_chunk(n, chunks,
+                        [&](::std::size_t, ::std::size_t begin,
+                            ::std::size_t end) {
+                            ::std::sort(first + begin, first + end, compare);
+                        });
+    for (::std::size_t width = 1; width < chunks; width *= 2) {
+        const auto pairs = chunks / (width * 2);
+        pool.for_each_chunk(pairs, pairs,
+                            [&](::std::size_t pair, ::std::size_t,
+                                ::std::size_t) {
+                                const auto lo = pair * width * 2;
+                                ::std::inplace_merge(
+                                    first + bound(lo),
+                                    first + bound(lo + width),
+                                    first + bound(lo + width * 2), compare);
+                            });
+    }
+#endif
+}
+
+template <typename C>
+void par_sort_unstable(C &container, ThreadPool &pool = ThreadPool::global()) {
+    using T = detail::ElementOf<C>;
+    par_sort_unstable_by(container, ::std::less<T>{}, pool);
+}
+
+// in place inclusive scan in two blocked passes: chunk totals, then each
+// chunk rescanned from the total of the chunks before it
+template <typename C, typename Op>
+void par_inclusive_scan(C &container, Op op,
+                        ThreadPool &pool = ThreadPool::global()) {
+    using T = detail::ElementOf<C>;
+    auto *first = container.data();
+    const auto n = static_cast<::std::size_t>(container.size());
+    if (n == 0) {
+        return;
+    }
+    const auto chunks = detail::chunks_for(pool, n, detail::DEFAULT_MIN_LEN);
+    auto totals = ::std::vector<T>(chunks, first[0]);
+    if (chunks > 1) {
+        pool.for_each_chunk(n, chunks,
+                            [&](::std::size_t chunk, ::std::size_t begin,
+                                ::std::size_t end) {
+                                auto acc = first[begin];
+                                for (auto i = begin + 1; i < end; ++i) {
+                                    acc = op(acc, first[i]);
+                                }
+                                totals[chunk] = acc;
+                            });
+        for (::std::size_t i = 1; i < chunks; ++i) {
+            totals[i] = op(totals[i - 1], totals[i]);
+        }
+    }
+    pool.for_each_chunk(n, chunks,
+                        [&](::std::size_t chunk, ::std::size_t begin,
+                            ::std::size_t end) {
+                            auto acc = chunk > 0
+                                           ? op(totals[chunk - 1], first[begin])
+                                           : first[begin];
+                            first[begin] = acc;
+                            for (auto i = begin + 1; i < end; ++i) {
+                                acc = op(acc, first[i]);
+                                first[i] = acc;
+                            }
+                        });
+}
+
+template <typename C>
+void par_prefix_sum(C &container, ThreadPool &pool = ThreadPool::global()) {
+    par_inclusive_scan(container, detail::Plus{}, pool);
+}
+
+// counts of @bins buckets, @bucket maps an element to its index below @bins;
+// a private histogram per thread, summed at the end
+template <typename C, typename B>
+::std::vector<::std::size_t> par_histogram(const C &container,
+                                           ::std::size_t bins, B bucket,
+                                           ThreadPool &pool =
+                                               ThreadPool::global()) {
+    const auto *first = container.data();
+    const auto n = static_cast<::std::size_t>(container.size());
+    const auto chunks = ::std::min(
+        pool.threads(), (n + detail::DEFAULT_MIN_LEN - 1) /
+                            detail::DEFAULT_MIN_LEN);
+    auto counts = ::std::vector<::std::vector<::std::size_t>>(
+        ::std::max<::std::size_t>(chunks, 1),
+        ::std::vector<::std::size_t>(bins));
+    pool.for_each_chunk(n, counts.size(),
+                        [&](::std::size_t chunk, ::std::size_t begin,
+                            ::std::size_t end) {
+                            auto &local = counts[chunk];
+                            for (auto i = begin; i < end; ++i) {
+                                ++local[bucket(first[i])];
+                            }
+                        });
+    for (::std::size_t i = 1; i < counts.size(); ++i) {
+        for (::std::size_t b = 0; b < bins; ++b) {
+            counts[0][b] += counts[i][b];
+        }
+    }
+    return ::std::move(counts[0]);
+}
+
+} // namespace rusty::parallel
+
+#endif // __RUSTY_PARALLEL_HPP__
@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: MIT
+// Copyright(c) 2021 ur4t
+
+// C++20 module standing in for rusty.hpp: `import rusty;` exports every
+// public name, each in its usual namespace. Modules cannot export macros,
+// include macros.hpp (no system header included) after the import for dbg,
+// assert_eq and assert_ne.
+
+module;
+
+#include "rusty.hpp"
+
+export module rusty;
+
+export namespace rusty::numeric_types {
+
+using numeric_types::bit_cast;
+using numeric_types::BeSlice;
+using numeric_types::Checked;
+using numeric_types::EndianSlice;
+using numeric_types::int128;
+using numeric_types::LeSlice;
+using numeric_types::Number;
+using numeric_types::ParseError;
+using numeric_types::ParseResult;
+using numeric_types::to_str;
+using numeric_types::uint128;
+
+using numeric_types::f32;
+using numeric_types::f64;
+using numeric_types::i128;
+using numeric_types::i16;
+using numeric_types::i32;
+using numeric_types::i64;
+using numeric_types::i8;
+using numeric_types::isize;
+using numeric_types::u128;
+using numeric_types::u16;
+using numeric_types::u32;
+using numeric_types::u64;
+using numeric_types::u8;
+using numeric_types::usize;
+
+namespace literal {
+
+using literal::operator""_f32;
+using literal::operator""_f64;
+using literal::operator""_i128;
+using literal::operator""_i16;
+using literal::operator""_i32;
+using literal::operator""_i64;
+using literal::operator""_i8;
+using literal::operator""_isize;
+using literal::operator""_u128;
+using literal::operator""_u16;
+using literal::operator""_u32;
+using literal::operator""_u64;
+using literal::operator""_u8;
+using literal::operator""_usize;
+
+} // namespace literal
+
+} // namespace rusty::numeric_types
+
+export namespace rusty::hash {
+
+using hash::FastHash;
+using hash::RandomHash;
+using hash::StdHash;
+
+} // namespace rusty::hash
+
+export namespace rusty::alloc {
+
+using alloc::Arena;
+using alloc::ArenaAllocator;
+
+namespace arena {
+
+using arena::Allocator;
+using arena::HashMap;
+using arena::String;
+using arena::Vec;
+
+} // namespace arena
+
+} // namespace rusty::alloc
+
+export namespace rusty::collections {
+
+using collections::Array;
+using collections::FlatHashMap;
+using collections::HashMap;
+using collections::load;
+using collections::Pair;
+using collections::save;
+using collections::Slice;
+using collections::SmallVec;
+using collections::Vec;
+using collections::view;
+using collections::view_map;
+
+namespace ostream {
+
+using ostream::max_bytes;
+using ostream::max_items;
+using ostream::operator<<;
+
+} // namespace ostream
+
+} // namespace rusty::collections
+
+// used by the dbg macro expansion
+export namespace rusty::debug {
+
+using debug::begin_record;
+using debug::count_metric;
+using debug::dump_metrics;
+using debug::end_record;
+using debug::flush;
+using debug::forward_record;
+using debug::MetricKind;
+using debug::MetricSite;
+using debug::RateLimit;
+using debug::record_metric;
+using debug::ScopedTimer;
+
+} // namespace rusty::debug
+
+export namespace rusty::io {
+
+using io::BufReader;
+using io::BufWriter;
+using io::ByteReader;
+using io::ByteWriter;
+using io::IstreamSource;
+using io::OstreamSink;
+using io::ReadExt;
+using io::StreamReader;
+using io::StreamWriter;
+using io::WriteExt;
+#ifdef RUSTY_IO_HAS_FD
+using io::FdReader;
+using io::FdSink;
+using io::FdSource;
+using io::FdWriter;
+#endif
+
+} // namespace rusty::io
+
+// qualified, iter alone names the function inside the namespace
+export namespace rusty::iter {
+
+using ::rusty::iter::chunks;
+using ::rusty::iter::iter;
+using ::rusty::iter::Iter;
+using ::rusty::iter::windows;
+
+} // namespace rusty::iter
+
+export namespace rusty::parallel {
+
+using parallel::par_histogram;
+using parallel::par_inclusive_scan;
+using parallel::par_iter;
+using parallel::par_prefix_sum;
+using parallel::par_sort_unstable;
+using parallel::par_sort_unstable_by;
+using parallel::ParIter;
+using parallel::ThreadPool;
+
+} // namespace rusty::parallel
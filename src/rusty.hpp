@@ -4,16 +4,28 @@
 #ifndef __RUSTY_HPP__
 #define __RUSTY_HPP__
 
+#include "numeric_types.hpp"
+#include "hash.hpp"
+
+#include "alloc.hpp"
 #include "collections.hpp"
+#include "debug.hpp"
+#include "io.hpp"
+#include "iter.hpp"
+#include "parallel.hpp"
 #include "macros.hpp"
-#include "numeric_types.hpp"
 
 #ifdef RUSTY_USE_DEFAULT_USING
 
 using namespace ::rusty::numeric_types;
 using namespace ::rusty::numeric_types::literal;
+using namespace ::rusty::hash;
+using namespace ::rusty::alloc;
 using namespace ::rusty::collections;
 using namespace ::rusty::collections::ostream;
+using namespace ::rusty::io;
+using namespace ::rusty::iter;
+using namespace ::rusty::parallel;
 
 #endif
 